@@ -7,6 +7,8 @@ const codebook = require('../src/codebook');
 const fec = require('../src/fec');
 const adaptive = require('../src/adaptive');
 const packet = require('../src/packet');
+const dictionary = require('../src/dictionary');
+const fs = require('fs');
 
 const args = process.argv.slice(2);
 const command = args[0];
@@ -22,6 +24,9 @@ Usage:
   meshxt bench <message>
   meshxt range [--sf 7-12] [--bw 125|250|500] [--power 14] [--antenna 3]
   meshxt codebook                    List all codebook templates
+  meshxt train <log> [--out dict.bin] [--header dict.h] [--id 1-255] [--existing a.bin,b.bin]
+                                     Train a dictionary on a message log (one per line);
+                                     its ID must not clash with --existing or the old --out
   meshxt help
 
 Examples:
@@ -29,6 +34,7 @@ Examples:
   meshxt encode "I'm OK" --compress codebook
   meshxt bench "Need help at the old bridge, heading south"
   meshxt range --sf 12 --bw 125 --power 14 --antenna 6
+  meshxt train channel0.log --out dict0.bin
 `);
 }
 
@@ -187,6 +193,52 @@ function doCodebook() {
   console.log();
 }
 
+function doTrain() {
+  const file = args[1];
+  if (!file) { console.error('Error: provide a message log to train on'); process.exit(1); }
+
+  const flags = parseFlags(args.slice(2));
+  const out = flags.out || 'dict.bin';
+
+  try {
+    const messages = fs.readFileSync(file, 'utf8').split(/\r?\n/);
+    const options = {};
+    if (flags.id) options.id = parseInt(flags.id);
+    if (flags.entries) options.maxEntries = parseInt(flags.entries);
+
+    // Dictionaries already on the mesh, including the one being replaced:
+    // nodes that still hold it would decode the new one's packets with it
+    const existing = flags.existing ? flags.existing.split(',') : [];
+    if (fs.existsSync(out)) existing.push(out);
+    options.avoid = existing.map(f => dictionary.parse(fs.readFileSync(f)));
+
+    const dict = dictionary.train(messages, options);
+    const blob = dictionary.serialize(dict);
+    fs.writeFileSync(out, blob);
+    if (flags.header) fs.writeFileSync(flags.header, dictionary.toCHeader(dict));
+
+    const { stats } = dict;
+    const pct = (n) => ((1 - n / stats.originalBytes) * 100).toFixed(1);
+
+    console.log(`\n📖 MeshXT Dictionary Training`);
+    console.log(`─────────────────────────────────`);
+    console.log(`Messages:      ${stats.messages} (${stats.originalBytes} bytes)`);
+    console.log(`Built-in:      ${stats.builtinBytes} bytes (${pct(stats.builtinBytes)}% saved)`);
+    console.log(`Trained:       ${stats.trainedBytes} bytes (${pct(stats.trainedBytes)}% saved)`);
+    console.log(`─────────────────────────────────`);
+    console.log(`Dictionary:    ID ${dict.id}, ${dict.entries.length} entries, ${blob.length} bytes → ${out}`);
+    if (options.id === undefined && dict.id !== dict.hashId) {
+      console.log(`               (hash ID ${dict.hashId} is taken by another dictionary)`);
+    }
+    if (flags.header) console.log(`C header:      ${flags.header}`);
+    console.log(`Install:       copy to /meshxt/dict<channel>.bin on every node of the channel`);
+    console.log();
+  } catch (e) {
+    console.error(`Error: ${e.message}`);
+    process.exit(1);
+  }
+}
+
 // Dispatch
 switch (command) {
   case 'encode':  doEncode(); break;
@@ -194,6 +246,7 @@ switch (command) {
   case 'bench':   doBench(); break;
   case 'range':   doRange(); break;
   case 'codebook': doCodebook(); break;
+  case 'train':   doTrain(); break;
   case 'help': case '--help': case '-h': case undefined: usage(); break;
   default:
     console.error(`Unknown command: ${command}`);
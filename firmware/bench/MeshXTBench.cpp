@@ -0,0 +1,284 @@
+#include "MeshXTBench.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "MeshXTCompress.h"
+#include "MeshXTEntropy.h"
+#include "MeshXTFEC.h"
+#include "MeshXTPacket.h"
+#include "MeshXTStats.h"
+
+#define BENCH_NOINLINE __attribute__((noinline))
+#define BENCH_PAINT    0xA5
+
+const char *const MESHXT_BENCH_CORPUS[] = {
+    "On my way, be there in 10",
+    "Copy that, heading to the north trailhead now",
+    "Anyone on frequency near the ridge?",
+    "Battery at 40%, switching to low power mode",
+    "Meet at the bridge at 14:30",
+    "Weather is turning, heavy rain and wind from the west",
+    "Road closed at mile marker 42, take the detour through town",
+    "Need water and a first aid kit at camp 3",
+    "All good here, signal is weak but holding",
+    "Can you relay to base: team two is delayed by an hour",
+    "Fog is rolling in near 51.48N, visibility is poor",
+    "Lost the trail after the creek crossing, backtracking",
+    "Thanks, see you tomorrow morning",
+    "Node 4 is back online after the reboot",
+    "How many people are at the shelter tonight?",
+    "Supplies arrived, unloading the truck now",
+    "Checkpoint reached at 09:15, everyone accounted for",
+    "Please confirm you received the updated map",
+    "Gate code changed to 4471, pass it on",
+    "Storm warning until 18:00, stay off the summit",
+    "Found a good spot for the repeater on the hill behind the farm",
+    "ok",
+    "Where are you?",
+    "Running late, traffic on the main road out of the valley, maybe twenty more minutes",
+};
+const size_t MESHXT_BENCH_CORPUS_SIZE = sizeof(MESHXT_BENCH_CORPUS) / sizeof(MESHXT_BENCH_CORPUS[0]);
+
+const char *meshxt_bench_unit(void) {
+    return meshxt_cycles_unit();
+}
+
+// ---------------------------------------------------------------------------
+// Operations
+// ---------------------------------------------------------------------------
+
+/**
+ * One call's input and output. prepare() builds `in` from the text
+ * untimed; op() is the timed call.
+ */
+typedef struct {
+    const char *text;
+    size_t textLen;
+    uint8_t nsym;
+    uint8_t in[MESHXT_MAX_PACKET_SIZE + 32];
+    size_t inLen;
+    uint8_t out[1024];
+} BenchCase;
+
+typedef struct {
+    const char *name;
+    uint8_t nsym;
+    bool (*prepare)(BenchCase *c);  // false = skip this message
+    int (*op)(BenchCase *c);        // bytes out, or -1
+} BenchDef;
+
+static bool prep_text(BenchCase *c) {
+    c->inLen = c->textLen;
+    return true;
+}
+
+static bool prep_smaz(BenchCase *c) {
+    int n = meshxt_compress_optimal(c->text, c->in, sizeof(c->in));
+    c->inLen = n < 0 ? 0 : (size_t)n;
+    return n >= 0;
+}
+
+static bool prep_entropy(BenchCase *c) {
+    int n = meshxt_compress_entropy(c->text, c->in, sizeof(c->in));
+    c->inLen = n < 0 ? 0 : (size_t)n;
+    return n >= 0;
+}
+
+/** Entropy-coded payload, cut to one codeword with the case's parity. */
+static bool prep_fec_payload(BenchCase *c) {
+    if (!prep_entropy(c)) return false;
+    if (c->inLen > 255u - c->nsym) c->inLen = 255u - c->nsym;
+    return c->inLen > 0;
+}
+
+static bool prep_fec_clean(BenchCase *c) {
+    uint8_t payload[255];
+    if (!prep_fec_payload(c)) return false;
+    memcpy(payload, c->in, c->inLen);
+    int n = meshxt_fec_encode(payload, c->inLen, c->in, c->nsym);
+    c->inLen = n < 0 ? 0 : (size_t)n;
+    return n >= 0;
+}
+
+/** Codeword with nsym / 2 symbol errors, the most it can correct. */
+static bool prep_fec_errors(BenchCase *c) {
+    if (!prep_fec_clean(c)) return false;
+    for (size_t k = 0; k < (size_t)(c->nsym / 2); k++) c->in[(k * 7) % c->inLen] ^= (uint8_t)(0x5A + k);
+    return true;
+}
+
+static bool prep_packet(BenchCase *c) {
+    int n = meshxt_create_packet(c->text, c->in, MESHXT_COMP_ENTROPY, MESHXT_FEC_LOW_CODE | MESHXT_FEC_RATIO);
+    c->inLen = n < 0 ? 0 : (size_t)n;
+    return n >= 0;
+}
+
+static int op_compress(BenchCase *c) {
+    return meshxt_compress(c->text, c->out, sizeof(c->out));
+}
+
+static int op_compress_optimal(BenchCase *c) {
+    return meshxt_compress_optimal(c->text, c->out, sizeof(c->out));
+}
+
+static int op_compress_entropy(BenchCase *c) {
+    return meshxt_compress_entropy(c->text, c->out, sizeof(c->out));
+}
+
+static int op_decompress(BenchCase *c) {
+    return meshxt_decompress(c->in, c->inLen, (char *)c->out, sizeof(c->out));
+}
+
+static int op_decompress_entropy(BenchCase *c) {
+    return meshxt_decompress_entropy(c->in, c->inLen, (char *)c->out, sizeof(c->out));
+}
+
+static int op_fec_encode(BenchCase *c) {
+    return meshxt_fec_encode(c->in, c->inLen, c->out, c->nsym);
+}
+
+static int op_fec_decode(BenchCase *c) {
+    return meshxt_fec_decode(c->in, c->inLen, c->out, c->nsym);
+}
+
+static int op_create_packet(BenchCase *c) {
+    return meshxt_create_packet(c->text, c->out, MESHXT_COMP_ENTROPY, MESHXT_FEC_LOW_CODE | MESHXT_FEC_RATIO);
+}
+
+/** Clean packets are not modified by the in-place parse, so calls repeat. */
+static int op_parse_packet(BenchCase *c) {
+    return meshxt_parse_packet_inplace(c->in, c->inLen, (char *)c->out, sizeof(c->out), NULL);
+}
+
+static const BenchDef BENCHES[] = {
+    {"compress", 0, prep_text, op_compress},
+    {"compress_optimal", 0, prep_text, op_compress_optimal},
+    {"compress_entropy", 0, prep_text, op_compress_entropy},
+    {"decompress", 0, prep_smaz, op_decompress},
+    {"decompress_entropy", 0, prep_entropy, op_decompress_entropy},
+    {"fec_encode low", MESHXT_FEC_LOW, prep_fec_payload, op_fec_encode},
+    {"fec_encode medium", MESHXT_FEC_MEDIUM, prep_fec_payload, op_fec_encode},
+    {"fec_encode high", MESHXT_FEC_HIGH, prep_fec_payload, op_fec_encode},
+    {"fec_decode low clean", MESHXT_FEC_LOW, prep_fec_clean, op_fec_decode},
+    {"fec_decode low 8 err", MESHXT_FEC_LOW, prep_fec_errors, op_fec_decode},
+    {"fec_decode medium clean", MESHXT_FEC_MEDIUM, prep_fec_clean, op_fec_decode},
+    {"fec_decode medium 16 err", MESHXT_FEC_MEDIUM, prep_fec_errors, op_fec_decode},
+    {"fec_decode high clean", MESHXT_FEC_HIGH, prep_fec_clean, op_fec_decode},
+    {"fec_decode high 32 err", MESHXT_FEC_HIGH, prep_fec_errors, op_fec_decode},
+    {"create_packet", 0, prep_text, op_create_packet},
+    {"parse_packet_inplace", 0, prep_packet, op_parse_packet},
+};
+
+// ---------------------------------------------------------------------------
+// Stack high-water mark
+// ---------------------------------------------------------------------------
+
+static volatile uint8_t *paintArea;
+
+/** Fill the stack below the caller with a pattern. */
+static BENCH_NOINLINE void stack_paint(void) {
+    volatile uint8_t area[MESHXT_BENCH_STACK_PAINT];
+    for (size_t i = 0; i < sizeof(area); i++) area[i] = BENCH_PAINT;
+    // Kept for stack_used(), which runs in the same stack region afterwards
+    volatile uint8_t *p = area;
+    __asm__ volatile("" : "+r"(p));
+    paintArea = p;
+}
+
+/**
+ * Bytes of the painted area overwritten since stack_paint(). The stack
+ * grows down, so the untouched pattern is at the low end of the area.
+ */
+static BENCH_NOINLINE uint32_t stack_used(void) {
+    size_t i = 0;
+    while (i < MESHXT_BENCH_STACK_PAINT && paintArea[i] == BENCH_PAINT) i++;
+    return (uint32_t)(MESHXT_BENCH_STACK_PAINT - i);
+}
+
+static BENCH_NOINLINE uint32_t measure_stack(const BenchDef *b, BenchCase *c) {
+    stack_paint();
+    b->op(c);
+    return stack_used();
+}
+
+// ---------------------------------------------------------------------------
+// Runner
+// ---------------------------------------------------------------------------
+
+/** Cost of reading the clock twice, removed from every measurement. */
+static uint32_t clock_overhead(void) {
+    uint32_t best = 0xFFFFFFFFUL;
+    for (int i = 0; i < 64; i++) {
+        uint32_t t0 = meshxt_cycles();
+        uint32_t t1 = meshxt_cycles();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+static BenchCase benchCase;
+
+size_t meshxt_bench_run(const char *const *messages, size_t count, uint32_t iterations,
+                        MeshXTBenchResult *results) {
+    meshxt_cycles_init();
+    uint32_t overhead = clock_overhead();
+
+    size_t numResults = 0;
+    for (size_t k = 0; k < sizeof(BENCHES) / sizeof(BENCHES[0]) && numResults < MESHXT_BENCH_MAX_RESULTS; k++) {
+        const BenchDef *b = &BENCHES[k];
+        MeshXTBenchResult *r = &results[numResults++];
+        memset(r, 0, sizeof(*r));
+        r->name = b->name;
+
+        BenchCase *c = &benchCase;
+        for (size_t m = 0; m < count; m++) {
+            c->text = messages[m];
+            c->textLen = strlen(messages[m]);
+            c->nsym = b->nsym;
+            if (c->textLen == 0 || c->textLen > 255 || !b->prepare(c)) continue;
+
+            int outLen = b->op(c);  // warm-up, and skips inputs the op cannot take
+            if (outLen < 0) continue;
+            uint32_t stack = measure_stack(b, c);
+            if (stack > r->stackBytes) r->stackBytes = stack;
+
+            for (uint32_t it = 0; it < iterations; it++) {
+                uint32_t t0 = meshxt_cycles();
+                b->op(c);
+                uint32_t t = meshxt_cycles() - t0;
+                t = t > overhead ? t - overhead : 0;
+
+                r->ticks += t;
+                if (t > r->maxTicks) r->maxTicks = t;
+                r->ops++;
+                r->bytesIn += c->inLen;
+                r->bytesOut += (uint32_t)outLen;
+            }
+        }
+    }
+    return numResults;
+}
+
+void meshxt_bench_print(const MeshXTBenchResult *results, size_t count, MeshXTBenchLog log, void *ctx) {
+    char line[128];
+    char unit[16];
+    snprintf(unit, sizeof(unit), "%s/op", meshxt_cycles_unit());
+    snprintf(line, sizeof(line), "%-24s %10s %10s %8s %8s %7s %7s", "operation", unit, "max",
+             "in B/op", "out B/op", "ratio", "stack");
+    log(line, ctx);
+
+    for (size_t i = 0; i < count; i++) {
+        const MeshXTBenchResult *r = &results[i];
+        if (r->ops == 0) {
+            snprintf(line, sizeof(line), "%-24s (no messages)", r->name);
+            log(line, ctx);
+            continue;
+        }
+        double in = (double)r->bytesIn / r->ops;
+        double out = (double)r->bytesOut / r->ops;
+        snprintf(line, sizeof(line), "%-24s %10.0f %10lu %8.1f %8.1f %6.1f%% %7lu", r->name,
+                 (double)r->ticks / r->ops, (unsigned long)r->maxTicks, in, out, in > 0 ? 100.0 * out / in : 0.0,
+                 (unsigned long)r->stackBytes);
+        log(line, ctx);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Benchmark — throughput, latency and stack use of the C++ core
+ *
+ * Runs compression, decompression, Reed-Solomon and packet operations
+ * over a set of messages and reports, per operation:
+ *   - mean and worst time per call (ns on a host, CPU cycles on a device)
+ *   - bytes in and out per call, and their ratio
+ *   - stack high-water mark, by painting the stack before one call and
+ *     checking how much of the pattern it overwrote
+ *
+ * The clock is meshxt_cycles() (MeshXTStats.h): std::chrono on a host,
+ * ESP.getCycleCount() on ESP32 and the DWT cycle counter on nRF52. The
+ * same code runs in both places: firmware/bench/bench_host.cpp on a PC,
+ * or the module at boot when built with -DMESHXT_BENCH (see
+ * firmware/README.md).
+ */
+
+#define MESHXT_BENCH_MAX_RESULTS 20
+
+// Bytes of stack painted below the caller for the high-water mark. Must
+// stay inside the task's stack on a device.
+#ifndef MESHXT_BENCH_STACK_PAINT
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_NRF52) || defined(NRF52_SERIES)
+#define MESHXT_BENCH_STACK_PAINT 3072
+#else
+#define MESHXT_BENCH_STACK_PAINT 16384
+#endif
+#endif
+
+/**
+ * Totals for one operation over all messages and iterations.
+ */
+typedef struct {
+    const char *name;     // e.g. "compress_entropy"
+    uint32_t ops;         // Calls timed
+    uint64_t ticks;       // Sum over all calls, clock overhead removed
+    uint32_t maxTicks;    // Slowest single call
+    uint64_t bytesIn;     // Sum of input sizes
+    uint64_t bytesOut;    // Sum of output sizes
+    uint32_t stackBytes;  // Deepest stack use of one call (0 if not measured)
+} MeshXTBenchResult;
+
+/** Receives one line of the report (no trailing newline). */
+typedef void (*MeshXTBenchLog)(const char *line, void *ctx);
+
+/** Built-in messages, for devices that have no corpus file. */
+extern const char *const MESHXT_BENCH_CORPUS[];
+extern const size_t MESHXT_BENCH_CORPUS_SIZE;
+
+/** Unit of MeshXTBenchResult ticks: "ns" or "cycles". */
+const char *meshxt_bench_unit(void);
+
+/**
+ * Run every operation over the messages.
+ *
+ * @param messages    Texts (null-terminated, up to 255 chars; longer ones are skipped)
+ * @param count       Number of texts
+ * @param iterations  Passes over the texts per operation
+ * @param results     Output, at least MESHXT_BENCH_MAX_RESULTS entries
+ * @return            Number of results written
+ */
+size_t meshxt_bench_run(const char *const *messages, size_t count, uint32_t iterations,
+                        MeshXTBenchResult *results);
+
+/** Format results as a table, one line per operation. */
+void meshxt_bench_print(const MeshXTBenchResult *results, size_t count, MeshXTBenchLog log, void *ctx);
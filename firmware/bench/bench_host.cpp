@@ -0,0 +1,67 @@
+/**
+ * Host benchmark of the firmware C++ core, built without MESHTASTIC_FIRMWARE
+ * from all .cpp files in firmware/src and firmware/bench (see "Benchmarking"
+ * in firmware/README.md for the command):
+ *
+ *   ./meshxt-bench [corpus.txt] [iterations]
+ *
+ * The corpus is one message per line (default: firmware/tools/chat-corpus.txt,
+ * else the built-in messages).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MeshXTBench.h"
+
+#define MAX_MESSAGES 1024
+
+static char lines[MAX_MESSAGES][256];
+static const char *messages[MAX_MESSAGES];
+
+static void print_line(const char *line, void *) {
+    puts(line);
+}
+
+/** Read up to MAX_MESSAGES lines of at most 255 chars; returns the count. */
+static size_t load_corpus(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    size_t count = 0;
+    char buf[4096];
+    while (count < MAX_MESSAGES && fgets(buf, sizeof(buf), f)) {
+        buf[strcspn(buf, "\r\n")] = '\0';
+        size_t len = strlen(buf);
+        if (len == 0 || len >= sizeof(lines[0])) continue;
+        memcpy(lines[count], buf, len + 1);
+        messages[count] = lines[count];
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "firmware/tools/chat-corpus.txt";
+    uint32_t iterations = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 200;
+
+    const char *const *corpus = messages;
+    size_t count = load_corpus(path);
+    if (count == 0) {
+        if (argc > 1) {
+            fprintf(stderr, "No messages in %s\n", path);
+            return 1;
+        }
+        corpus = MESHXT_BENCH_CORPUS;
+        count = MESHXT_BENCH_CORPUS_SIZE;
+        path = "built-in messages";
+    }
+    printf("MeshXT benchmark: %zu messages from %s, %u iterations\n\n", count, path, iterations);
+
+    MeshXTBenchResult results[MESHXT_BENCH_MAX_RESULTS];
+    size_t n = meshxt_bench_run(corpus, count, iterations, results);
+    meshxt_bench_print(results, n, print_line, NULL);
+    return 0;
+}
@@ -0,0 +1,444 @@
+/**
+ * Fuzz harness for the receive path of the firmware C++ core: everything
+ * that reads bytes off the air (packet parsing, FEC, every decompressor,
+ * batches and fragment reassembly).
+ *
+ * The first input byte picks the target and the output buffer size, the
+ * rest is the frame. Output buffers are allocated at exactly the size
+ * passed in and inputs are copied to exact-size buffers, so under ASan a
+ * write at outSize or a read past the frame is reported at once. Besides
+ * not crashing, the decoders must agree with each other: a size-only pass
+ * (meshxt_decompressed_len) and a streamed decode report the same length
+ * as the buffered one, and a buffer one byte too small is refused.
+ *
+ * With libFuzzer:
+ *
+ *   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -DMESHXT_LIBFUZZER \
+ *       -Ifirmware/src firmware/fuzz/meshxt_fuzz.cpp \
+ *       firmware/src/MeshXT{Compress,Codebook,Entropy,History,FEC,Packet,Fragment}.cpp -o meshxt-fuzz
+ *   ./meshxt-fuzz corpus/
+ *
+ * Without it the same file builds a standalone driver (g++ or afl-g++):
+ *
+ *   g++ -std=c++17 -g -O1 -fsanitize=address,undefined -Ifirmware/src firmware/fuzz/meshxt_fuzz.cpp \
+ *       firmware/src/MeshXT{Compress,Codebook,Entropy,History,FEC,Packet,Fragment}.cpp -o meshxt-fuzz
+ *   ./meshxt-fuzz crash-file ...      # replay inputs (AFL: ./meshxt-fuzz @@)
+ *   ./meshxt-fuzz -r 1000000 [seed]   # mutate valid packets of every type
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MeshXTCodebook.h"
+#include "MeshXTCompress.h"
+#include "MeshXTEntropy.h"
+#include "MeshXTFEC.h"
+#include "MeshXTFragment.h"
+#include "MeshXTHistory.h"
+#include "MeshXTPacket.h"
+
+#define FUZZ_TARGETS 8
+
+// Fails the run with a location, under any fuzzer or none
+#define FUZZ_CHECK(cond)                                                                  \
+    do {                                                                                  \
+        if (!(cond)) {                                                                    \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);      \
+            abort();                                                                      \
+        }                                                                                 \
+    } while (0)
+
+/** Exact-size heap copy, so ASan sees any read past the end. */
+static uint8_t *copy_input(const uint8_t *data, size_t len) {
+    uint8_t *p = (uint8_t *)malloc(len ? len : 1);
+    if (len) memcpy(p, data, len);
+    return p;
+}
+
+static int count_sink(const char *, size_t len, void *ctx) {
+    *(size_t *)ctx += len;
+    return 0;
+}
+
+/** A decoded text must be null-terminated right at its length, and fit. */
+static void check_text(const char *text, int len, size_t textSize) {
+    if (len < 0) return;
+    FUZZ_CHECK((size_t)len < textSize);
+    FUZZ_CHECK(text[len] == '\0');
+}
+
+/**
+ * Decode with a buffered decoder at textSize and at the full size, and
+ * check the result against the size-only pass, a buffer one byte short
+ * and the stream decoder (when given).
+ */
+template <typename Decode, typename Length, typename Stream>
+static void check_decoder(const uint8_t *in, size_t len, size_t textSize, Decode decode, Length length,
+                          Stream stream) {
+    char *text = (char *)malloc(textSize ? textSize : 1);
+    int n = decode(in, len, text, textSize);
+    check_text(text, n, textSize);
+    free(text);
+
+    static char full[65536];
+    int fullLen = decode(in, len, full, sizeof(full));
+    check_text(full, fullLen, sizeof(full));
+    int sized = length(in, len);
+    if (sized >= (int)sizeof(full)) return;  // Longer than any real frame decodes to
+    FUZZ_CHECK(sized == fullLen);
+    if (fullLen >= 0) {
+        // Fits textSize exactly when there is room for the terminator
+        FUZZ_CHECK((n >= 0) == ((size_t)fullLen < textSize));
+        if (n >= 0) FUZZ_CHECK(n == fullLen);
+
+        char *shortBuf = (char *)malloc((size_t)fullLen);
+        FUZZ_CHECK(decode(in, len, shortBuf, (size_t)fullLen) < 0);
+        free(shortBuf);
+    } else {
+        FUZZ_CHECK(n < 0);
+    }
+
+    size_t streamed = 0;
+    int s = stream(in, len, count_sink, &streamed);
+    FUZZ_CHECK(s == fullLen);
+    if (s >= 0) FUZZ_CHECK(streamed == (size_t)s);
+}
+
+static void fuzz_parse(const uint8_t *in, size_t len) {
+    static MeshXTParseResult result;
+    int rc = meshxt_parse_packet(in, len, &result);
+    if (rc == 0) {
+        FUZZ_CHECK(result.valid);
+        check_text(result.message, result.messageLen, sizeof(result.message));
+    }
+
+    // Erasure hints from the frame itself, anywhere in (or past) the packet
+    uint8_t erasures[16];
+    size_t numErasures = len < sizeof(erasures) ? len : sizeof(erasures);
+    memcpy(erasures, in, numErasures);
+    rc = meshxt_parse_packet_erasures(in, len, erasures, numErasures, &result);
+    if (rc == 0) check_text(result.message, result.messageLen, sizeof(result.message));
+
+    meshxt_packet_check(in, len, true);
+}
+
+static void fuzz_inplace(const uint8_t *in, size_t len, size_t textSize) {
+    uint8_t *packet = copy_input(in, len);
+    char *text = (char *)malloc(textSize ? textSize : 1);
+    MeshXTPacketInfo info;
+    int n = meshxt_parse_packet_inplace(packet, len, text, textSize, &info);
+    check_text(text, n, textSize);
+    free(text);
+
+    memcpy(packet, in, len);
+    size_t streamed = 0;
+    int s = meshxt_parse_packet_stream(packet, len, count_sink, &streamed, &info);
+    if (s >= 0) FUZZ_CHECK(streamed == (size_t)s);
+    free(packet);
+}
+
+static void fuzz_history(const uint8_t *in, size_t len, size_t textSize) {
+    static MeshXTHistory history;
+    meshxt_history_init(&history);
+    static const char earlier[] = "Meet at the north gate at 5, bring the radio and a spare battery";
+    meshxt_history_append(&history, earlier, sizeof(earlier) - 1);
+
+    uint8_t *packet = copy_input(in, len);
+    char *text = (char *)malloc(textSize ? textSize : 1);
+    int n = meshxt_parse_history_packet(packet, len, &history, text, textSize, NULL);
+    check_text(text, n, textSize);
+    free(text);
+    free(packet);
+}
+
+static void fuzz_batch(const uint8_t *in, size_t len, size_t textSize) {
+    char *text = (char *)malloc(textSize ? textSize : 1);
+    size_t offset = 0;
+    for (int i = 0; i <= MESHXT_BATCH_MAX_MESSAGES * 4 && offset < len; i++) {
+        size_t before = offset;
+        int n = meshxt_batch_next(in, len, &offset, text, textSize, NULL);
+        check_text(text, n, textSize);
+        if (n < 0) break;
+        FUZZ_CHECK(offset > before && offset <= len);
+    }
+    free(text);
+}
+
+static void fuzz_reassemble(const uint8_t *in, size_t len, size_t textSize) {
+    static MeshXTReassembler reassembler;
+    meshxt_reassembler_init(&reassembler);
+
+    // The input as a run of frames from one sender, each led by its length
+    static char text[4096];
+    size_t pos = 0;
+    for (uint32_t now = 0; pos < len; now += 100) {
+        size_t frameLen = in[pos++];
+        if (frameLen > len - pos) frameLen = len - pos;
+        uint8_t *frame = copy_input(in + pos, frameLen);
+        pos += frameLen;
+
+        uint8_t *message = NULL;
+        int packetLen = meshxt_reassembler_add(&reassembler, 0x1234, frame, frameLen, now, &message);
+        if (packetLen > 0) {
+            uint8_t *packet = copy_input(message, (size_t)packetLen);
+            size_t size = textSize == 256 ? sizeof(text) : textSize;  // Room for a long message
+            int n = meshxt_parse_packet_inplace(packet, (size_t)packetLen, text, size, NULL);
+            check_text(text, n, size);
+            free(packet);
+        }
+        free(frame);
+    }
+}
+
+static int decompress_smaz(const uint8_t *in, size_t len, char *out, size_t outSize) {
+    return meshxt_decompress(in, len, out, outSize);
+}
+
+static int decompress_entropy(const uint8_t *in, size_t len, char *out, size_t outSize) {
+    return meshxt_decompress_entropy(in, len, out, outSize);
+}
+
+static int decode_codebook(const uint8_t *in, size_t len, char *out, size_t outSize) {
+    return meshxt_codebook_decode(in, len, out, outSize);
+}
+
+static int length_codebook(const uint8_t *in, size_t len) {
+    static char text[256];
+    return meshxt_codebook_decode(in, len, text, sizeof(text));
+}
+
+static int stream_codebook(const uint8_t *in, size_t len, MeshXTTextSink sink, void *ctx) {
+    static char text[256];
+    int n = meshxt_codebook_decode(in, len, text, sizeof(text));
+    if (n >= 0 && sink(text, (size_t)n, ctx) != 0) return -1;
+    return n;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 1) return 0;
+
+    // Low bits: target; high bits: text buffer size, small ones included
+    uint8_t target = data[0] % FUZZ_TARGETS;
+    static const size_t textSizes[] = {0, 1, 2, 3, 4, 8, 16, 31, 32, 33, 64, 100, 128, 200, 255, 256};
+    size_t textSize = textSizes[(data[0] >> 3) & 0x0F];
+    if (data[0] & 0x80) textSize = 256;
+
+    uint8_t *in = copy_input(data + 1, size - 1);
+    size_t len = size - 1;
+
+    switch (target) {
+        case 0: fuzz_parse(in, len); break;
+        case 1: fuzz_inplace(in, len, textSize); break;
+        case 2: check_decoder(in, len, textSize, decompress_smaz, meshxt_decompressed_len, meshxt_decompress_stream); break;
+        case 3:
+            check_decoder(in, len, textSize, decompress_entropy, meshxt_decompressed_len_entropy,
+                          meshxt_decompress_entropy_stream);
+            break;
+        case 4: check_decoder(in, len, textSize, decode_codebook, length_codebook, stream_codebook); break;
+        case 5: fuzz_batch(in, len, textSize); break;
+        case 6: fuzz_history(in, len, textSize); break;
+        case 7: fuzz_reassemble(in, len, textSize); break;
+    }
+    free(in);
+    return 0;
+}
+
+#ifndef MESHXT_LIBFUZZER
+
+// ---------------------------------------------------------------------------
+// Standalone driver
+// ---------------------------------------------------------------------------
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+#define SEED_MAX  256
+#define SEED_SIZE 1024  // Room for a run of fragment frames
+
+static uint8_t seeds[SEED_MAX][SEED_SIZE];
+static size_t seedLens[SEED_MAX];
+static size_t numSeeds;
+
+static void add_seed(uint8_t target, const uint8_t *data, size_t len) {
+    if (numSeeds == SEED_MAX || len > sizeof(seeds[0]) - 1 || len == 0) return;
+    seeds[numSeeds][0] = target;
+    memcpy(seeds[numSeeds] + 1, data, len);
+    seedLens[numSeeds++] = len + 1;
+}
+
+struct FragmentSeed {
+    uint8_t buf[SEED_SIZE - 1];
+    size_t len;
+};
+
+static int collect_fragment(const uint8_t *frame, size_t len, void *ctx) {
+    FragmentSeed *seed = (FragmentSeed *)ctx;
+    if (seed->len + 1 + len > sizeof(seed->buf)) return -1;
+    seed->buf[seed->len++] = (uint8_t)len;
+    memcpy(seed->buf + seed->len, frame, len);
+    seed->len += len;
+    return 0;
+}
+
+/** Valid inputs for every target, for the mutator to start from. */
+static void build_seeds(void) {
+    static const char *messages[] = {
+        "Are you free for dinner Thursday?",
+        "ok",
+        "Sending \xF0\x9F\x91\x8D from \xF0\x9F\x93\x8D here",
+        "The quick brown fox jumps over the lazy dog near the old mill by the river",
+    };
+    static const uint8_t comps[] = {MESHXT_COMP_NONE, MESHXT_COMP_SMAZ, MESHXT_COMP_ENTROPY};
+    static const uint8_t fecs[] = {MESHXT_FEC_NONE_CODE, MESHXT_FEC_LOW_CODE, MESHXT_FEC_HIGH_CODE,
+                                   MESHXT_FEC_LOW_CODE | MESHXT_FEC_RATIO,
+                                   MESHXT_FEC_MEDIUM_CODE | MESHXT_FEC_DEPTH(2)};
+    uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+
+    for (const char *msg : messages) {
+        for (uint8_t comp : comps) {
+            for (uint8_t fec : fecs) {
+                int n = meshxt_create_packet(msg, packet, comp, fec);
+                if (n < 0) continue;
+                add_seed(0, packet, (size_t)n);
+                add_seed(1 | 0x80, packet, (size_t)n);
+            }
+        }
+        uint8_t payload[256];
+        int n = meshxt_compress(msg, payload, sizeof(payload));
+        if (n > 0) add_seed(2 | 0x80, payload, (size_t)n);
+        n = meshxt_compress_entropy(msg, payload, sizeof(payload));
+        if (n > 0) add_seed(3 | 0x80, payload, (size_t)n);
+    }
+
+    MeshXTBatch batch;
+    meshxt_batch_init(&batch);
+    for (const char *msg : messages) {
+        int n = meshxt_create_packet(msg, packet, MESHXT_COMP_SMAZ, MESHXT_FEC_NONE_CODE);
+        if (n > 0) meshxt_batch_add(&batch, packet, (size_t)n);
+    }
+    int n = meshxt_create_batch_packet(&batch, packet, MESHXT_FEC_LOW_CODE);
+    if (n > 0) add_seed(1 | 0x80, packet, (size_t)n);
+    n = meshxt_create_batch_packet(&batch, packet, MESHXT_FEC_NONE_CODE);
+    if (n > MESHXT_HEADER_SIZE) add_seed(5 | 0x80, packet + MESHXT_HEADER_SIZE, (size_t)n - MESHXT_HEADER_SIZE);
+
+    MeshXTTemplateParams params;
+    memset(&params, 0, sizeof(params));
+    n = meshxt_codebook_match("I'm OK", packet, sizeof(packet));
+    if (n > 0) add_seed(4 | 0x80, packet, (size_t)n);
+
+    static MeshXTHistory history;
+    meshxt_history_init(&history);
+    static const char earlier[] = "Meet at the north gate at 5, bring the radio and a spare battery";
+    meshxt_history_append(&history, earlier, sizeof(earlier) - 1);
+    n = meshxt_create_history_packet("Meet at the north gate at 6 instead", packet, &history, MESHXT_FEC_LOW_CODE);
+    if (n > 0) add_seed(6 | 0x80, packet, (size_t)n);
+
+    FragmentSeed frag;
+    frag.len = 0;
+    char longText[400];
+    for (size_t i = 0; i < sizeof(longText) - 1; i++) longText[i] = "the radio check at noon "[i % 24];
+    longText[sizeof(longText) - 1] = '\0';
+    if (meshxt_fragment_message(longText, MESHXT_COMP_SMAZ, MESHXT_FEC_LOW_CODE, 7, 50, collect_fragment, &frag) >= 0)
+        add_seed(7 | 0x80, frag.buf, frag.len);
+}
+
+static const uint8_t *currentInput;
+static size_t currentLen;
+
+/** Keep the input that failed a check, for replaying under a debugger. */
+static void save_crash(int sig) {
+    FILE *f = fopen("meshxt-fuzz-crash", "wb");
+    if (f) {
+        fwrite(currentInput, 1, currentLen, f);
+        fclose(f);
+        fprintf(stderr, "meshxt-fuzz: input saved to meshxt-fuzz-crash (%zu bytes)\n", currentLen);
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/** One random edit: flip, set, insert, delete, truncate or change the target byte. */
+static size_t mutate(uint8_t *buf, size_t len, size_t cap) {
+    static const uint8_t edges[] = {0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF};
+    size_t pos = len > 1 ? 1 + rng() % (len - 1) : 1;
+    switch (rng() % 7) {
+        case 0: if (pos < len) buf[pos] ^= (uint8_t)(1u << (rng() % 8)); break;
+        case 1: if (pos < len) buf[pos] = (uint8_t)rng(); break;
+        case 2: if (pos < len) buf[pos] = edges[rng() % sizeof(edges)]; break;
+        case 3:
+            if (len < cap) {
+                memmove(buf + pos + 1, buf + pos, len - pos);
+                buf[pos] = (uint8_t)rng();
+                len++;
+            }
+            break;
+        case 4:
+            if (pos < len) {
+                memmove(buf + pos, buf + pos + 1, len - pos - 1);
+                len--;
+            }
+            break;
+        case 5: len = pos; break;
+        case 6: buf[0] = (uint8_t)((buf[0] & 0x07) | (rng() & 0xF8)); break;
+    }
+    return len;
+}
+
+static int replay(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "meshxt-fuzz: cannot open %s\n", path);
+        return 1;
+    }
+    static uint8_t buf[65536];
+    size_t len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    LLVMFuzzerTestOneInput(buf, len);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && strcmp(argv[1], "-r") == 0) {
+        unsigned long iterations = argc >= 3 ? strtoul(argv[2], NULL, 10) : 100000;
+        rng_state = argc >= 4 ? (uint32_t)strtoul(argv[3], NULL, 10) | 1 : 1;
+        build_seeds();
+        signal(SIGABRT, save_crash);
+        printf("meshxt-fuzz: %zu seeds, %lu iterations, seed %u\n", numSeeds, iterations, rng_state);
+
+        static uint8_t buf[sizeof(seeds[0]) + 64];
+        for (unsigned long i = 0; i < iterations; i++) {
+            size_t s = rng() % numSeeds;
+            size_t len = seedLens[s];
+            memcpy(buf, seeds[s], len);
+            for (uint32_t edits = 1 + rng() % 4; edits > 0; edits--) len = mutate(buf, len, sizeof(buf));
+            // Some runs are pure noise, for the header paths
+            if (rng() % 16 == 0) {
+                len = 1 + rng() % (sizeof(buf) - 1);
+                for (size_t j = 1; j < len; j++) buf[j] = (uint8_t)rng();
+            }
+            currentInput = buf;
+            currentLen = len;
+            LLVMFuzzerTestOneInput(buf, len);
+        }
+        puts("meshxt-fuzz: done");
+        return 0;
+    }
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: meshxt-fuzz <input>... | -r [iterations] [seed]\n");
+        return 2;
+    }
+    int failed = 0;
+    for (int i = 1; i < argc; i++) failed |= replay(argv[i]);
+    return failed;
+}
+
+#endif  // MESHXT_LIBFUZZER
@@ -0,0 +1,126 @@
+#include "MeshXTGateway.h"
+#include <string.h>
+
+#include "MeshXTPacket.h"
+
+/** Decode frame i into slot i of the columns, using `scratch` for the in-place FEC. */
+static bool parse_one(const MeshXTFrame *frame, size_t i, const MeshXTParseColumns *results,
+                      uint8_t *scratch) {
+    char *text = results->text + i * results->textStride;
+    MeshXTPacketInfo info;
+    memset(&info, 0, sizeof(info));
+
+    int textLen = -1;
+    if (frame->len <= MESHXT_MAX_PACKET_SIZE) {
+        memcpy(scratch, frame->data, frame->len);
+        textLen = meshxt_parse_packet_inplace(scratch, frame->len, text, results->textStride, &info);
+    }
+    if (textLen < 0 && results->textStride > 0) text[0] = '\0';
+
+    results->messageLen[i] = (int16_t)(textLen < 0 ? -1 : textLen);
+    if (results->compType) results->compType[i] = info.header.compType;
+    if (results->fecLevel) results->fecLevel[i] = info.header.fecLevel;
+    if (results->fecCorrected) results->fecCorrected[i] = (uint8_t)info.fecCorrected;
+    return textLen >= 0;
+}
+
+size_t meshxt_parse_packets_range(const MeshXTFrame *frames, size_t first, size_t count,
+                                  const MeshXTParseColumns *results) {
+    // Per-thread scratch: the frame being corrected lives on this stack
+    uint8_t scratch[MESHXT_MAX_PACKET_SIZE];
+    size_t decoded = 0;
+    for (size_t i = first; i < first + count; i++) {
+        if (parse_one(&frames[i], i, results, scratch)) decoded++;
+    }
+    return decoded;
+}
+
+size_t meshxt_parse_packets_batch(const MeshXTFrame *frames, size_t n, const MeshXTParseColumns *results) {
+    return meshxt_parse_packets_range(frames, 0, n, results);
+}
+
+// ---------------------------------------------------------------------------
+// Pool
+// ---------------------------------------------------------------------------
+
+/** Claim chunks of the current run until none are left. */
+static void pool_work(MeshXTDecodePool *pool) {
+    size_t decoded = 0;
+    for (;;) {
+        size_t first = pool->next.fetch_add(MESHXT_POOL_CHUNK, std::memory_order_relaxed);
+        if (first >= pool->n) break;
+        size_t count = pool->n - first < MESHXT_POOL_CHUNK ? pool->n - first : MESHXT_POOL_CHUNK;
+        decoded += meshxt_parse_packets_range(pool->frames, first, count, pool->results);
+    }
+    pool->decoded.fetch_add(decoded, std::memory_order_relaxed);
+}
+
+static void pool_thread(MeshXTDecodePool *pool) {
+    uint32_t seen = 0;
+    std::unique_lock<std::mutex> guard(pool->lock);
+    for (;;) {
+        pool->start.wait(guard, [&] { return pool->stop || pool->generation != seen; });
+        if (pool->stop) return;
+        seen = pool->generation;
+
+        guard.unlock();
+        pool_work(pool);
+        guard.lock();
+
+        if (--pool->busy == 0) pool->done.notify_one();
+    }
+}
+
+void meshxt_decode_pool_init(MeshXTDecodePool *pool, unsigned threads) {
+    if (threads == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        threads = cores > 1 ? cores - 1 : 0;
+    }
+    if (threads > MESHXT_POOL_MAX_THREADS) threads = MESHXT_POOL_MAX_THREADS;
+
+    pool->generation = 0;
+    pool->busy = 0;
+    pool->stop = false;
+    pool->frames = NULL;
+    pool->n = 0;
+    pool->results = NULL;
+    pool->next.store(0, std::memory_order_relaxed);
+    pool->decoded.store(0, std::memory_order_relaxed);
+
+    pool->count = threads;
+    for (unsigned i = 0; i < threads; i++) pool->threads[i] = std::thread(pool_thread, pool);
+}
+
+size_t meshxt_decode_pool_run(MeshXTDecodePool *pool, const MeshXTFrame *frames, size_t n,
+                              const MeshXTParseColumns *results) {
+    // A small run is over before a worker would have woken up
+    if (pool->count == 0 || n <= MESHXT_POOL_CHUNK) return meshxt_parse_packets_batch(frames, n, results);
+
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->frames = frames;
+        pool->n = n;
+        pool->results = results;
+        pool->next.store(0, std::memory_order_relaxed);
+        pool->decoded.store(0, std::memory_order_relaxed);
+        pool->busy = pool->count;
+        pool->generation++;
+    }
+    pool->start.notify_all();
+
+    pool_work(pool);
+
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->done.wait(guard, [&] { return pool->busy == 0; });
+    return pool->decoded.load(std::memory_order_relaxed);
+}
+
+void meshxt_decode_pool_shutdown(MeshXTDecodePool *pool) {
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stop = true;
+    }
+    pool->start.notify_all();
+    for (unsigned i = 0; i < pool->count; i++) pool->threads[i].join();
+    pool->count = 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stddef.h>
+#include <thread>
+
+/**
+ * MeshXT Gateway — bulk decode of received frames on a host
+ *
+ * For bridges that take frames from many nodes at once (e.g. over MQTT)
+ * and decode them with the firmware core. Results are written column by
+ * column (MeshXTParseColumns): a caller that only needs the texts and
+ * their lengths walks two flat arrays instead of one MeshXTParseResult
+ * (~280 bytes) per frame, and the frame workers write disjoint ranges.
+ *
+ * Frames are parsed as by meshxt_parse_packet_inplace, on a copy in the
+ * decoding thread's stack scratch, so the input stays unmodified and can
+ * be shared between threads. History packets (compType 6) need the
+ * conversation and fragments (3) a reassembler, so those fail here with
+ * their compType set for the caller to route them. Register trained
+ * dictionaries (meshxt_dict_register) before decoding starts.
+ *
+ * Host only: uses std::thread. Build it with the firmware sources and
+ * -pthread (see "Host / gateway builds" in firmware/README.md).
+ */
+
+#define MESHXT_POOL_MAX_THREADS 32
+#define MESHXT_POOL_CHUNK       32  // Frames a worker claims at once
+
+/** One received frame. */
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} MeshXTFrame;
+
+/**
+ * Caller-owned result columns, one entry per frame. Optional columns may
+ * be NULL. Header columns are filled for every frame whose header could
+ * be read, including ones that then failed to decode (0 otherwise).
+ */
+typedef struct {
+    char *text;              // Frame i's text at text + i * textStride, null-terminated
+    size_t textStride;       // Bytes per text slot, e.g. 256; longer texts fail the frame
+    int16_t *messageLen;     // Text length, or -1 if the frame did not decode
+    uint8_t *compType;       // Header compression type (may be NULL)
+    uint8_t *fecLevel;       // Header FEC level code (may be NULL)
+    uint8_t *fecCorrected;   // Symbols repaired by FEC (may be NULL)
+} MeshXTParseColumns;
+
+/**
+ * Decode frames [first, first + count) on the calling thread.
+ *
+ * @return  Number of those frames that decoded
+ */
+size_t meshxt_parse_packets_range(const MeshXTFrame *frames, size_t first, size_t count,
+                                  const MeshXTParseColumns *results);
+
+/**
+ * Decode n frames on the calling thread.
+ *
+ * @return  Number of frames that decoded
+ */
+size_t meshxt_parse_packets_batch(const MeshXTFrame *frames, size_t n, const MeshXTParseColumns *results);
+
+/**
+ * Worker threads that decode batches of frames together. The calling
+ * thread takes part in each run, so a pool of t threads keeps t + 1
+ * cores busy. Plain data with no heap; make it static or a member, and
+ * use it from one thread at a time.
+ */
+typedef struct {
+    std::thread threads[MESHXT_POOL_MAX_THREADS];
+    unsigned count;
+
+    std::mutex lock;
+    std::condition_variable start;  // Workers wait here for a run
+    std::condition_variable done;   // The caller waits here for the workers
+    uint32_t generation;            // Runs started so far
+    unsigned busy;                  // Workers not yet done with the current run
+    bool stop;
+
+    // Current run
+    const MeshXTFrame *frames;
+    size_t n;
+    const MeshXTParseColumns *results;
+    std::atomic<size_t> next;     // First frame of the next chunk to claim
+    std::atomic<size_t> decoded;
+} MeshXTDecodePool;
+
+/**
+ * Start the workers.
+ *
+ * @param threads  Worker threads (0 = one per core besides the caller's;
+ *                 at most MESHXT_POOL_MAX_THREADS)
+ */
+void meshxt_decode_pool_init(MeshXTDecodePool *pool, unsigned threads);
+
+/**
+ * Decode n frames across the pool and the calling thread; returns when
+ * all are done.
+ *
+ * @return  Number of frames that decoded
+ */
+size_t meshxt_decode_pool_run(MeshXTDecodePool *pool, const MeshXTFrame *frames, size_t n,
+                              const MeshXTParseColumns *results);
+
+/** Stop and join the workers. */
+void meshxt_decode_pool_shutdown(MeshXTDecodePool *pool);
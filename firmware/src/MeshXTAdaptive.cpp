@@ -0,0 +1,226 @@
+#include "MeshXTAdaptive.h"
+#include "MeshXTPacket.h"
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Link model tables
+// ---------------------------------------------------------------------------
+
+/**
+ * Byte error probability versus link margin above the demodulation floor,
+ * one entry per dB from BER_MARGIN_MIN_DB. LoRa packet error curves fall
+ * off over a few dB; these values are deliberately on the pessimistic
+ * side so FEC is added a little early rather than late.
+ */
+#define BER_MARGIN_MIN_DB -6
+#define BER_TABLE_SIZE    15
+
+static constexpr float BYTE_ERROR_RATE[BER_TABLE_SIZE] = {
+    0.5f,    0.35f,   0.2f,    0.1f,    0.05f,   0.025f,  // -6 .. -1 dB
+    0.01f,                                                // 0 dB
+    4e-3f,   1.5e-3f, 5e-4f,   2e-4f,   8e-5f,   3e-5f,   // +1 .. +6 dB
+    1e-5f,   0.0f,                                        // +7, >= +8 dB
+};
+
+static constexpr int FEC_CODES[] = {
+    MESHXT_FEC_NONE_CODE, MESHXT_FEC_LOW_CODE, MESHXT_FEC_MEDIUM_CODE, MESHXT_FEC_HIGH_CODE,
+};
+
+/**
+ * Demodulation SNR floor in quarter dB (SX127x/SX126x datasheets:
+ * -7.5 dB at SF7, 2.5 dB lower per SF step).
+ */
+static int16_t snr_floor_q(uint8_t sf) {
+    return (int16_t)(-30 - 10 * (sf - 7));
+}
+
+/**
+ * Receiver sensitivity in quarter dB, as rxSensitivity() in adaptive.js:
+ * -123 dBm at SF7/125 kHz, 2.5 dB per SF step, ~3 dB per bandwidth halving.
+ */
+static int16_t sensitivity_q(uint8_t sf, uint32_t bwHz) {
+    int q = -492 - 10 * (sf - 7);
+    for (uint32_t bw = 125000; bw < bwHz; bw <<= 1) q += 12;
+    for (uint32_t bw = 125000; bw > bwHz; bw >>= 1) q -= 12;
+    return (int16_t)q;
+}
+
+// ---------------------------------------------------------------------------
+// Airtime
+// ---------------------------------------------------------------------------
+
+static uint32_t symbol_time_us(const MeshXTLoRaParams *radio) {
+    return (uint32_t)((1000000ULL << radio->sf) / radio->bwHz);
+}
+
+static uint32_t airtime_us(const MeshXTLoRaParams *radio, uint32_t tSym, size_t payloadBytes) {
+    // Low data rate optimisation is switched on for symbols >= 16 ms,
+    // as the radio drivers do
+    int de = tSym >= 16000 ? 1 : 0;
+    int sf = radio->sf;
+
+    // Explicit header, CRC on
+    int num = 8 * (int)payloadBytes - 4 * sf + 28 + 16;
+    int den = 4 * (sf - 2 * de);
+    int nPayloadSymbols = 8 + (num > 0 ? (num + den - 1) / den : 0) * radio->cr;
+
+    uint32_t tPreamble = ((4u * radio->preambleLen + 17u) * tSym) / 4u;
+    return tPreamble + (uint32_t)nPayloadSymbols * tSym;
+}
+
+uint32_t meshxt_lora_airtime_us(const MeshXTLoRaParams *radio, size_t payloadBytes) {
+    return airtime_us(radio, symbol_time_us(radio), payloadBytes);
+}
+
+// ---------------------------------------------------------------------------
+// Link tracking
+// ---------------------------------------------------------------------------
+
+void meshxt_adaptive_init(MeshXTAdaptive *ad, const MeshXTLoRaParams *radio, uint8_t defaultFec) {
+    memset(ad, 0, sizeof(MeshXTAdaptive));
+    ad->defaultFec = defaultFec;
+    meshxt_adaptive_set_radio(ad, radio);
+}
+
+void meshxt_adaptive_set_radio(MeshXTAdaptive *ad, const MeshXTLoRaParams *radio) {
+    ad->radio = *radio;
+    ad->symbolUs = symbol_time_us(radio);
+}
+
+static bool is_fresh(const MeshXTNeighbour *n, uint32_t nowMs) {
+    return n->node != 0 && (uint32_t)(nowMs - n->lastSeenMs) <= MESHXT_ADAPTIVE_STALE_MS;
+}
+
+void meshxt_adaptive_observe(MeshXTAdaptive *ad, uint32_t node, int16_t snrQ, int16_t rssi,
+                             uint32_t nowMs) {
+    if (node == 0 || node == MESHXT_NODE_BROADCAST) return;
+
+    // Find the node, remembering a free or least recently heard slot
+    MeshXTNeighbour *slot = nullptr;
+    MeshXTNeighbour *victim = nullptr;
+    uint32_t victimAge = 0;
+    for (int i = 0; i < MESHXT_ADAPTIVE_MAX_NEIGHBOURS; i++) {
+        MeshXTNeighbour *n = &ad->neighbours[i];
+        if (n->node == node) { slot = n; break; }
+        uint32_t age = n->node == 0 ? UINT32_MAX : (uint32_t)(nowMs - n->lastSeenMs);
+        if (!victim || age > victimAge) {
+            victim = n;
+            victimAge = age;
+        }
+    }
+
+    int16_t rssiQ = (int16_t)(rssi * 4);
+    if (!slot) {
+        // New link: start with a 2 dB fade margin until deviation is measured
+        slot = victim;
+        slot->node = node;
+        slot->snrQ = snrQ;
+        slot->snrDevQ = 8;
+        slot->rssiQ = rssiQ;
+        slot->samples = 1;
+        slot->lastSeenMs = nowMs;
+        return;
+    }
+
+    // Exponential moving averages, alpha = 1/4
+    int dev = snrQ - slot->snrQ;
+    int absDev = dev < 0 ? -dev : dev;
+    slot->snrQ = (int16_t)(slot->snrQ + dev / 4);
+    slot->snrDevQ = (int16_t)(slot->snrDevQ + (absDev - slot->snrDevQ) / 4);
+    slot->rssiQ = (int16_t)(slot->rssiQ + (rssiQ - slot->rssiQ) / 4);
+    if (slot->samples < UINT16_MAX) slot->samples++;
+    slot->lastSeenMs = nowMs;
+}
+
+static int16_t neighbour_margin(const MeshXTAdaptive *ad, const MeshXTNeighbour *n) {
+    int snrMargin = (n->snrQ - n->snrDevQ) - snr_floor_q(ad->radio.sf);
+    int rssiMargin = n->rssiQ - sensitivity_q(ad->radio.sf, ad->radio.bwHz);
+    return (int16_t)(snrMargin < rssiMargin ? snrMargin : rssiMargin);
+}
+
+bool meshxt_adaptive_link_margin(const MeshXTAdaptive *ad, uint32_t dest, uint32_t nowMs,
+                                 int16_t *margin) {
+    bool found = false;
+    int16_t worst = 0;
+    for (int i = 0; i < MESHXT_ADAPTIVE_MAX_NEIGHBOURS; i++) {
+        const MeshXTNeighbour *n = &ad->neighbours[i];
+        if (!is_fresh(n, nowMs)) continue;
+        if (dest != MESHXT_NODE_BROADCAST && n->node != dest) continue;
+        int16_t m = neighbour_margin(ad, n);
+        if (!found || m < worst) worst = m;
+        found = true;
+    }
+    if (found) *margin = worst;
+    return found;
+}
+
+// ---------------------------------------------------------------------------
+// Selection
+// ---------------------------------------------------------------------------
+
+static float byte_error_rate(int16_t marginQ) {
+    // Floor division to whole dB
+    int db = marginQ >= 0 ? marginQ / 4 : -((-marginQ + 3) / 4);
+    int idx = db - BER_MARGIN_MIN_DB;
+    if (idx < 0) idx = 0;
+    if (idx >= BER_TABLE_SIZE) idx = BER_TABLE_SIZE - 1;
+    return BYTE_ERROR_RATE[idx];
+}
+
+static float ipow(float x, int n) {
+    float r = 1.0f;
+    while (n > 0) {
+        if (n & 1) r *= x;
+        x *= x;
+        n >>= 1;
+    }
+    return r;
+}
+
+/**
+ * P(at most t of n bytes are corrupted), independent errors with rate p.
+ */
+static float binomial_cdf(int n, int t, float p) {
+    if (p <= 0.0f) return 1.0f;
+    float q = 1.0f - p;
+    float term = ipow(q, n);
+    float sum = term;
+    float ratio = p / q;
+    for (int k = 0; k < t && k < n; k++) {
+        term *= ratio * (float)(n - k) / (float)(k + 1);
+        sum += term;
+    }
+    return sum > 1.0f ? 1.0f : sum;
+}
+
+uint8_t meshxt_adaptive_select_fec(const MeshXTAdaptive *ad, uint32_t dest, size_t payloadLen,
+                                   uint32_t nowMs) {
+    int16_t margin;
+    if (!meshxt_adaptive_link_margin(ad, dest, nowMs, &margin)) return ad->defaultFec;
+
+    float p = byte_error_rate(margin);
+    // Bytes outside the RS codeword: radio-level overhead + MeshXT header
+    float clearHeader = ipow(1.0f - p, MESHXT_LORA_OVERHEAD + MESHXT_HEADER_SIZE);
+
+    int best = -1;
+    uint32_t bestAir = 0;
+    float bestOk = 0.0f;
+    for (size_t i = 0; i < sizeof(FEC_CODES) / sizeof(FEC_CODES[0]); i++) {
+        uint8_t nsym = meshxt_fec_nsym_from_code(FEC_CODES[i]);
+        if (MESHXT_HEADER_SIZE + payloadLen + nsym > MESHXT_MAX_PACKET_SIZE) break;
+        if (ad->parityRatio) nsym = meshxt_fec_ratio_nsym(FEC_CODES[i], payloadLen);
+        size_t frameLen = MESHXT_HEADER_SIZE + payloadLen + nsym;
+
+        uint32_t air = airtime_us(&ad->radio, ad->symbolUs, MESHXT_LORA_OVERHEAD + frameLen);
+        float ok = clearHeader * binomial_cdf((int)(payloadLen + nsym), nsym / 2, p);
+
+        // Expected airtime until delivery is air / ok; compare without dividing.
+        // With every level hopeless (ok == 0) the strongest one that fits wins.
+        if (best < 0 || (float)air * bestOk < (float)bestAir * ok || (bestOk == 0.0f && ok == 0.0f)) {
+            best = FEC_CODES[i];
+            bestAir = air;
+            bestOk = ok;
+        }
+    }
+    return best < 0 ? ad->defaultFec : (uint8_t)best;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Adaptive FEC Selection
+ *
+ * Tracks per-neighbour link quality (SNR/RSSI of packets heard directly)
+ * and picks the FEC level that minimises the expected airtime per
+ * delivered message, retransmits included. Port of the airtime and
+ * sensitivity models in src/adaptive.js, using integer airtime math and
+ * constant tables (no pow/log).
+ *
+ * Expected cost of a level = airtime(level) / P(packet decodes), i.e. the
+ * mean airtime spent until one copy gets through.
+ */
+
+#define MESHXT_ADAPTIVE_MAX_NEIGHBOURS 16
+#define MESHXT_ADAPTIVE_STALE_MS       (30UL * 60UL * 1000UL)  // ignore links not heard for 30 min
+
+// Meshtastic header, protobuf framing and MIC carried over the air with every MeshXT frame
+#define MESHXT_LORA_OVERHEAD 20
+
+#define MESHXT_NODE_BROADCAST 0xFFFFFFFFUL
+
+/**
+ * LoRa modem parameters.
+ */
+typedef struct {
+    uint8_t sf;            // Spreading factor (7–12)
+    uint32_t bwHz;         // Bandwidth (62500, 125000, 250000, 500000)
+    uint8_t cr;            // Coding rate denominator (5–8, i.e. 4/5 to 4/8)
+    uint8_t preambleLen;   // Preamble length in symbols
+} MeshXTLoRaParams;
+
+/**
+ * Link state for one neighbour. SNR/RSSI are kept in quarter-dB units.
+ */
+typedef struct {
+    uint32_t node;         // Node number (0 = free slot)
+    int16_t snrQ;          // Smoothed SNR
+    int16_t snrDevQ;       // Smoothed mean absolute SNR deviation (fade margin)
+    int16_t rssiQ;         // Smoothed RSSI
+    uint16_t samples;      // Packets observed
+    uint32_t lastSeenMs;   // Time of last observation
+} MeshXTNeighbour;
+
+/**
+ * Adaptive selector state. Plain data; allocate statically or as a member.
+ */
+typedef struct {
+    MeshXTLoRaParams radio;
+    uint32_t symbolUs;     // Cached symbol time for radio
+    uint8_t defaultFec;    // FEC level code for unknown links
+    bool parityRatio;      // Levels will be sent with MESHXT_FEC_RATIO (set after init)
+    MeshXTNeighbour neighbours[MESHXT_ADAPTIVE_MAX_NEIGHBOURS];
+} MeshXTAdaptive;
+
+/**
+ * Initialise selector state.
+ *
+ * @param ad          State to initialise
+ * @param radio       Modem parameters used for airtime and sensitivity
+ * @param defaultFec  FEC level code (MESHXT_FEC_*_CODE) used with no link data
+ */
+void meshxt_adaptive_init(MeshXTAdaptive *ad, const MeshXTLoRaParams *radio, uint8_t defaultFec);
+
+/**
+ * Change modem parameters (e.g. after a preset change). Link history is kept.
+ */
+void meshxt_adaptive_set_radio(MeshXTAdaptive *ad, const MeshXTLoRaParams *radio);
+
+/**
+ * Record a packet heard directly (zero hops) from a neighbour.
+ * The least recently heard entry is replaced when the table is full.
+ *
+ * @param snrQ    Packet SNR in quarter dB
+ * @param rssi    Packet RSSI in dBm
+ * @param nowMs   Monotonic time in ms
+ */
+void meshxt_adaptive_observe(MeshXTAdaptive *ad, uint32_t node, int16_t snrQ, int16_t rssi,
+                             uint32_t nowMs);
+
+/**
+ * Pick the FEC level code for a frame to `dest`.
+ *
+ * Broadcasts are sized for the weakest fresh neighbour. Destinations with
+ * no fresh link data get the default level.
+ *
+ * @param dest        Destination node (MESHXT_NODE_BROADCAST for broadcast)
+ * @param payloadLen  Compressed payload length (before FEC)
+ * @param nowMs       Monotonic time in ms
+ * @return            FEC level code (MESHXT_FEC_*_CODE)
+ */
+uint8_t meshxt_adaptive_select_fec(const MeshXTAdaptive *ad, uint32_t dest, size_t payloadLen,
+                                   uint32_t nowMs);
+
+/**
+ * Link margin above the demodulation floor for `dest`, in quarter dB.
+ *
+ * @param margin  Set to the margin when link data is available
+ * @return        true if fresh link data exists
+ */
+bool meshxt_adaptive_link_margin(const MeshXTAdaptive *ad, uint32_t dest, uint32_t nowMs,
+                                 int16_t *margin);
+
+/**
+ * LoRa time on air for an explicit-header packet with CRC.
+ *
+ * @param payloadBytes  LoRa payload size in bytes
+ * @return              Airtime in microseconds
+ */
+uint32_t meshxt_lora_airtime_us(const MeshXTLoRaParams *radio, size_t payloadBytes);
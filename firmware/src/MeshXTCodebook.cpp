@@ -0,0 +1,430 @@
+#include "MeshXTCodebook.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// ---------------------------------------------------------------------------
+// Template definitions (must match src/codebook.js)
+// ---------------------------------------------------------------------------
+
+#define SIMPLE(id, name, text) { id, name, text, MESHXT_PARAM_NONE, text, "" }
+
+static constexpr MeshXTTemplate TEMPLATES[MESHXT_TEMPLATE_COUNT] = {
+    // ----- Simple templates (1 byte each) -----
+    SIMPLE(0x00, "ok",            "I'm OK"),
+    SIMPLE(0x01, "need_help",     "Need help"),
+    SIMPLE(0x02, "emergency",     "Emergency!"),
+    SIMPLE(0x03, "yes",           "Yes"),
+    SIMPLE(0x04, "no",            "No"),
+    SIMPLE(0x05, "maybe",         "Maybe"),
+    SIMPLE(0x06, "on_my_way",     "On my way"),
+    SIMPLE(0x07, "call_me",       "Call me"),
+    SIMPLE(0x08, "copy",          "Copy"),
+    SIMPLE(0x09, "roger",         "Roger"),
+    SIMPLE(0x0A, "thanks",        "Thanks"),
+    SIMPLE(0x0B, "please",        "Please"),
+    SIMPLE(0x0C, "sorry",         "Sorry"),
+    SIMPLE(0x0D, "hello",         "Hello"),
+    SIMPLE(0x0E, "goodbye",       "Goodbye"),
+    SIMPLE(0x0F, "good_morning",  "Good morning"),
+    SIMPLE(0x10, "good_night",    "Good night"),
+    SIMPLE(0x11, "safe",          "I'm safe"),
+    SIMPLE(0x12, "help_coming",   "Help is coming"),
+    SIMPLE(0x13, "stay_put",      "Stay put"),
+    SIMPLE(0x14, "move_out",      "Move out"),
+    SIMPLE(0x15, "all_clear",     "All clear"),
+    SIMPLE(0x16, "danger",        "Danger"),
+    SIMPLE(0x17, "stop",          "Stop"),
+    SIMPLE(0x18, "go",            "Go"),
+    SIMPLE(0x19, "wait",          "Wait"),
+    SIMPLE(0x1A, "affirmative",   "Affirmative"),
+    SIMPLE(0x1B, "negative",      "Negative"),
+    SIMPLE(0x1C, "check_in",      "Checking in"),
+    SIMPLE(0x1D, "heading_home",  "Heading home"),
+    SIMPLE(0x1E, "arrived",       "Arrived"),
+    SIMPLE(0x1F, "leaving_now",   "Leaving now"),
+    SIMPLE(0x20, "be_right_back", "Be right back"),
+    SIMPLE(0x21, "brb",           "BRB"),
+    SIMPLE(0x22, "sos",           "SOS"),
+    SIMPLE(0x23, "mayday",        "Mayday"),
+    SIMPLE(0x24, "send_help",     "Send help"),
+    SIMPLE(0x25, "lost",          "I'm lost"),
+    SIMPLE(0x26, "found_it",      "Found it"),
+    SIMPLE(0x27, "send_coords",   "Send coordinates"),
+    SIMPLE(0x28, "low_battery",   "Low battery"),
+    SIMPLE(0x29, "charging",      "Charging"),
+    SIMPLE(0x2A, "no_signal",     "No signal"),
+    SIMPLE(0x2B, "weak_signal",   "Weak signal"),
+    SIMPLE(0x2C, "strong_signal", "Strong signal"),
+    SIMPLE(0x2D, "rain",          "Rain"),
+    SIMPLE(0x2E, "clear_sky",     "Clear sky"),
+    SIMPLE(0x2F, "overcast",      "Overcast"),
+    SIMPLE(0x30, "windy",         "Windy"),
+    SIMPLE(0x31, "fog",           "Fog"),
+    SIMPLE(0x32, "snow",          "Snow"),
+    SIMPLE(0x33, "storm",         "Storm"),
+    SIMPLE(0x34, "understood",    "Understood"),
+    SIMPLE(0x35, "repeat",        "Say again"),
+    SIMPLE(0x36, "over_out",      "Over and out"),
+    SIMPLE(0x37, "standing_by",   "Standing by"),
+    SIMPLE(0x38, "busy",          "Busy"),
+    SIMPLE(0x39, "free",          "Free"),
+    SIMPLE(0x3A, "meet_up",       "Meet up?"),
+    SIMPLE(0x3B, "come_here",     "Come here"),
+    SIMPLE(0x3C, "run",           "Run!"),
+    SIMPLE(0x3D, "hide",          "Hide"),
+    SIMPLE(0x3E, "quiet",         "Be quiet"),
+    SIMPLE(0x3F, "listen",        "Listen"),
+
+    // ----- Parameterised templates -----
+    { 0x40, "location",       "At location",    MESHXT_PARAM_LATLON,  "At location [",     "]" },
+    { 0x41, "eta",            "ETA",            MESHXT_PARAM_U8,      "ETA ",              " minutes" },
+    { 0x42, "weather",        "Weather",        MESHXT_PARAM_WEATHER, "Weather: ",         "" },
+    { 0x43, "switch_channel", "Switch channel", MESHXT_PARAM_MASK8,   "Switch to channel ", "" },
+    { 0x44, "heading",        "Heading",        MESHXT_PARAM_BEARING, "Heading ",          "\xC2\xB0" },
+    { 0x45, "altitude",       "Altitude",       MESHXT_PARAM_I16,     "Altitude ",         "m" },
+    { 0x46, "speed",          "Speed",          MESHXT_PARAM_U8,      "Speed ",            " km/h" },
+    { 0x47, "battery",        "Battery",        MESHXT_PARAM_PERCENT, "Battery ",          "%" },
+    { 0x48, "headcount",      "Headcount",      MESHXT_PARAM_U8,      "",                  " people" },
+    { 0x49, "short_text",     "Short text",     MESHXT_PARAM_TEXT,    "",                  "" },
+};
+
+#undef SIMPLE
+
+static constexpr bool templates_indexed_by_id() {
+    for (int i = 0; i < MESHXT_TEMPLATE_COUNT; i++) {
+        if (TEMPLATES[i].id != i) return false;
+    }
+    return true;
+}
+static_assert(templates_indexed_by_id(), "TEMPLATES must be ordered by contiguous ID");
+
+#define WEATHER_COUNT    20
+#define SHORT_TEXT_MAX   32
+
+static constexpr const char *WEATHER_CODES[WEATHER_COUNT] = {
+    "clear", "cloudy", "rain", "heavy rain", "drizzle", "snow",
+    "sleet", "hail", "fog", "mist", "wind", "storm", "thunder",
+    "tornado", "hurricane", "hot", "cold", "freezing", "mild", "warm",
+};
+
+// Largest |coordinate| that is formatted; keeps the integer part in range
+#define LATLON_FORMAT_LIMIT 1e12
+
+// ---------------------------------------------------------------------------
+// Lookup
+// ---------------------------------------------------------------------------
+
+const MeshXTTemplate *meshxt_codebook_by_id(uint8_t id) {
+    return id < MESHXT_TEMPLATE_COUNT ? &TEMPLATES[id] : nullptr;
+}
+
+const MeshXTTemplate *meshxt_codebook_find(const char *name) {
+    for (int i = 0; i < MESHXT_TEMPLATE_COUNT; i++) {
+        if (strcmp(TEMPLATES[i].name, name) == 0) return &TEMPLATES[i];
+    }
+    return nullptr;
+}
+
+static int weather_index(const char *type) {
+    for (int i = 0; i < WEATHER_COUNT; i++) {
+        if (strcmp(WEATHER_CODES[i], type) == 0) return i;
+    }
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Encoding
+// ---------------------------------------------------------------------------
+
+static uint8_t clamp_u8(int32_t v, int32_t hi) {
+    return (uint8_t)(v < 0 ? 0 : (v > hi ? hi : v));
+}
+
+static void put_float_be(uint8_t *buf, float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    buf[0] = (uint8_t)(bits >> 24);
+    buf[1] = (uint8_t)(bits >> 16);
+    buf[2] = (uint8_t)(bits >> 8);
+    buf[3] = (uint8_t)bits;
+}
+
+static float get_float_be(const uint8_t *buf) {
+    uint32_t bits = ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+                    ((uint32_t)buf[2] << 8) | buf[3];
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static int encode_template(const MeshXTTemplate *tmpl, const MeshXTTemplateParams *params,
+                           uint8_t *output, size_t outSize) {
+    uint8_t buf[2 + SHORT_TEXT_MAX];
+    size_t len = 0;
+    buf[len++] = tmpl->id;
+
+    if (tmpl->param != MESHXT_PARAM_NONE && !params) return -1;
+
+    switch (tmpl->param) {
+        case MESHXT_PARAM_NONE:
+            break;
+        case MESHXT_PARAM_LATLON:
+            put_float_be(buf + 1, params->lat);
+            put_float_be(buf + 5, params->lon);
+            len += 8;
+            break;
+        case MESHXT_PARAM_U8:
+            buf[len++] = clamp_u8(params->value, 255);
+            break;
+        case MESHXT_PARAM_PERCENT:
+            buf[len++] = clamp_u8(params->value, 100);
+            break;
+        case MESHXT_PARAM_MASK8:
+            buf[len++] = (uint8_t)(params->value & 0xFF);
+            break;
+        case MESHXT_PARAM_WEATHER: {
+            int idx = params->text ? weather_index(params->text) : -1;
+            if (idx < 0) return -1;
+            buf[len++] = (uint8_t)idx;
+            break;
+        }
+        case MESHXT_PARAM_BEARING: {
+            uint16_t b = (uint16_t)(params->value & 0x1FF);
+            buf[len++] = (uint8_t)(b >> 8);
+            buf[len++] = (uint8_t)b;
+            break;
+        }
+        case MESHXT_PARAM_I16: {
+            if (params->value < -32768 || params->value > 32767) return -1;
+            uint16_t m = (uint16_t)(int16_t)params->value;
+            buf[len++] = (uint8_t)(m >> 8);
+            buf[len++] = (uint8_t)m;
+            break;
+        }
+        case MESHXT_PARAM_TEXT: {
+            if (!params->text) return -1;
+            size_t textLen = strlen(params->text);
+            if (textLen > SHORT_TEXT_MAX) return -1;
+            buf[len++] = (uint8_t)textLen;
+            memcpy(buf + len, params->text, textLen);
+            len += textLen;
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    if (len > outSize) return -1;
+    memcpy(output, buf, len);
+    return (int)len;
+}
+
+int meshxt_codebook_encode(const char *name, const MeshXTTemplateParams *params,
+                           uint8_t *output, size_t outSize) {
+    const MeshXTTemplate *tmpl = meshxt_codebook_find(name);
+    if (!tmpl) return -1;
+    return encode_template(tmpl, params, output, outSize);
+}
+
+// ---------------------------------------------------------------------------
+// Decoding
+// ---------------------------------------------------------------------------
+
+/**
+ * Bounded text builder; `ok` drops to false once anything fails to fit.
+ * With a null buf it only counts, which is used to validate before writing.
+ */
+struct TextOut {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool ok;
+
+    void put(const char *s, size_t n) {
+        if (!ok || len + n >= size) { ok = false; return; }
+        if (buf) memcpy(buf + len, s, n);
+        len += n;
+    }
+    void putStr(const char *s) { put(s, strlen(s)); }
+    void putUint(uint64_t v) {
+        char digits[20];
+        int n = 0;
+        do { digits[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+        while (n > 0) put(&digits[--n], 1);
+    }
+    void putInt(int32_t v) {
+        if (v < 0) { put("-", 1); putUint((uint64_t)(-(int64_t)v)); }
+        else putUint((uint64_t)v);
+    }
+    // Same text as JS Number.prototype.toFixed(6). Integer-only so it does
+    // not depend on printf float support (absent from newlib-nano).
+    void putFixed6(double v) {
+        if (!(v < LATLON_FORMAT_LIMIT && v > -LATLON_FORMAT_LIMIT)) { ok = false; return; }
+        bool neg = v < 0;
+        if (neg) v = -v;
+        uint64_t scaled = (uint64_t)(v * 1e6 + 0.5);
+        if (neg) put("-", 1);
+        putUint(scaled / 1000000);
+        put(".", 1);
+        char frac[6];
+        uint32_t f = (uint32_t)(scaled % 1000000);
+        for (int i = 5; i >= 0; i--) { frac[i] = (char)('0' + f % 10); f /= 10; }
+        put(frac, 6);
+    }
+};
+
+/**
+ * Format an encoded template into `out`. Trailing bytes after the params
+ * are ignored, as in the JS decoder.
+ */
+static bool format_template(const uint8_t *input, size_t inLen, TextOut *out) {
+    if (inLen == 0) return false;
+    const MeshXTTemplate *tmpl = meshxt_codebook_by_id(input[0]);
+    if (!tmpl) return false;
+
+    const uint8_t *p = input + 1;
+    size_t avail = inLen - 1;
+
+    out->putStr(tmpl->prefix);
+    switch (tmpl->param) {
+        case MESHXT_PARAM_NONE:
+            break;
+        case MESHXT_PARAM_LATLON:
+            if (avail < 8) return false;
+            out->putFixed6(get_float_be(p));
+            out->putStr(", ");
+            out->putFixed6(get_float_be(p + 4));
+            break;
+        case MESHXT_PARAM_U8:
+        case MESHXT_PARAM_PERCENT:
+        case MESHXT_PARAM_MASK8:
+            if (avail < 1) return false;
+            out->putUint(p[0]);
+            break;
+        case MESHXT_PARAM_WEATHER:
+            if (avail < 1 || p[0] >= WEATHER_COUNT) return false;
+            out->putStr(WEATHER_CODES[p[0]]);
+            break;
+        case MESHXT_PARAM_BEARING:
+            if (avail < 2) return false;
+            out->putUint(((p[0] & 0x01) << 8) | p[1]);
+            break;
+        case MESHXT_PARAM_I16:
+            if (avail < 2) return false;
+            out->putInt((int16_t)((p[0] << 8) | p[1]));
+            break;
+        case MESHXT_PARAM_TEXT:
+            if (avail < 1 || avail - 1 < p[0]) return false;
+            out->put((const char *)(p + 1), p[0]);
+            break;
+        default:
+            return false;
+    }
+    out->putStr(tmpl->suffix);
+    return out->ok;
+}
+
+int meshxt_codebook_decode(const uint8_t *input, size_t inLen, char *text, size_t textSize) {
+    // Measure first so text is only written when the whole frame is valid
+    TextOut measure = { nullptr, SIZE_MAX, 0, true };
+    if (!format_template(input, inLen, &measure) || measure.len >= textSize) return -1;
+
+    TextOut out = { text, textSize, 0, true };
+    format_template(input, inLen, &out);
+    text[out.len] = '\0';
+    return (int)out.len;
+}
+
+// ---------------------------------------------------------------------------
+// Text matching
+// ---------------------------------------------------------------------------
+
+/**
+ * Parse a decimal integer occupying exactly [s, end). Leading '-' only,
+ * no '+', no spaces — anything the formatter would not emit is rejected
+ * later by the round-trip check anyway.
+ */
+static bool parse_int(const char *s, const char *end, int32_t *value) {
+    bool neg = false;
+    if (s < end && *s == '-') { neg = true; s++; }
+    if (s == end || end - s > 6) return false;
+    int32_t v = 0;
+    for (; s < end; s++) {
+        if (*s < '0' || *s > '9') return false;
+        v = v * 10 + (*s - '0');
+    }
+    *value = neg ? -v : v;
+    return true;
+}
+
+static bool parse_latlon(const char *s, const char *end, MeshXTTemplateParams *params) {
+    char *stop;
+    double lat = strtod(s, &stop);
+    if (stop == s || end - stop < 2 || stop[0] != ',' || stop[1] != ' ') return false;
+    const char *lonStart = stop + 2;
+    double lon = strtod(lonStart, &stop);
+    if (stop == lonStart || stop != end) return false;
+    params->lat = (float)lat;
+    params->lon = (float)lon;
+    return true;
+}
+
+int meshxt_codebook_match(const char *text, uint8_t *output, size_t outSize) {
+    size_t textLen = strlen(text);
+    if (textLen == 0 || textLen >= MESHXT_TEMPLATE_MAX_TEXT) return -1;
+
+    for (int i = 0; i < MESHXT_TEMPLATE_COUNT; i++) {
+        const MeshXTTemplate *tmpl = &TEMPLATES[i];
+        if (tmpl->param == MESHXT_PARAM_TEXT) continue;
+
+        size_t preLen = strlen(tmpl->prefix);
+        size_t sufLen = strlen(tmpl->suffix);
+        if (textLen < preLen + sufLen) continue;
+        if (memcmp(text, tmpl->prefix, preLen) != 0) continue;
+        if (memcmp(text + textLen - sufLen, tmpl->suffix, sufLen) != 0) continue;
+
+        const char *value = text + preLen;
+        const char *valueEnd = text + textLen - sufLen;
+        MeshXTTemplateParams params = {};
+        char weather[16];
+        bool parsed;
+
+        switch (tmpl->param) {
+            case MESHXT_PARAM_NONE:
+                parsed = value == valueEnd;
+                break;
+            case MESHXT_PARAM_LATLON:
+                parsed = parse_latlon(value, valueEnd, &params);
+                break;
+            case MESHXT_PARAM_WEATHER: {
+                size_t n = (size_t)(valueEnd - value);
+                parsed = n < sizeof(weather);
+                if (parsed) {
+                    memcpy(weather, value, n);
+                    weather[n] = '\0';
+                    params.text = weather;
+                }
+                break;
+            }
+            default:
+                parsed = parse_int(value, valueEnd, &params.value);
+                break;
+        }
+        if (!parsed) continue;
+
+        // Only accept encodings that reproduce the text byte for byte
+        uint8_t encoded[2 + SHORT_TEXT_MAX];
+        int encLen = encode_template(tmpl, &params, encoded, sizeof(encoded));
+        if (encLen < 0) continue;
+
+        char check[MESHXT_TEMPLATE_MAX_TEXT];
+        int checkLen = meshxt_codebook_decode(encoded, encLen, check, sizeof(check));
+        if (checkLen != (int)textLen || memcmp(check, text, textLen) != 0) continue;
+
+        if ((size_t)encLen > outSize) return -1;
+        memcpy(output, encoded, encLen);
+        return encLen;
+    }
+    return -1;
+}
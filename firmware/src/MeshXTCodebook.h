@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Codebook — Predefined Message Templates
+ *
+ * Ultra-compact encoding for common Meshtastic messages (compType 2).
+ * A single byte (template ID) optionally followed by parameter bytes.
+ * Wire format and texts match src/codebook.js.
+ *
+ * Template IDs 0x00–0x3F: simple (no params, 1 byte total)
+ * Template IDs 0x40–0x49: parameterised (variable length)
+ */
+
+#define MESHXT_TEMPLATE_COUNT     74
+#define MESHXT_TEMPLATE_PARAM_MIN 0x40
+
+// Buffer size that holds any text meshxt_codebook_encode can produce (incl. null)
+#define MESHXT_TEMPLATE_MAX_TEXT  64
+
+// Parameter encodings
+#define MESHXT_PARAM_NONE     0  // no params
+#define MESHXT_PARAM_LATLON   1  // 2 x float32 big-endian (lat, lon)
+#define MESHXT_PARAM_U8       2  // 1 byte, clamped to 0..255
+#define MESHXT_PARAM_WEATHER  3  // 1 byte index into the weather names
+#define MESHXT_PARAM_MASK8    4  // 1 byte, value & 0xFF
+#define MESHXT_PARAM_BEARING  5  // 2 bytes, 9-bit bearing
+#define MESHXT_PARAM_I16      6  // int16 big-endian
+#define MESHXT_PARAM_PERCENT  7  // 1 byte, clamped to 0..100
+#define MESHXT_PARAM_TEXT     8  // 1 byte length + up to 32 bytes of text
+
+/**
+ * Template definition. Decoded text is prefix + formatted param + suffix
+ * (simple templates are just their prefix).
+ */
+typedef struct {
+    uint8_t id;
+    const char *name;     // Template key, e.g. "eta"
+    const char *text;     // Human-readable label (full text for simple templates)
+    uint8_t param;        // MESHXT_PARAM_*
+    const char *prefix;
+    const char *suffix;
+} MeshXTTemplate;
+
+/**
+ * Parameters for meshxt_codebook_encode. Only the fields used by the
+ * template's param type are read.
+ */
+typedef struct {
+    float lat;            // location
+    float lon;            // location
+    int32_t value;        // eta, switch_channel, heading, altitude, speed, battery, headcount
+    const char *text;     // weather type name, short_text
+} MeshXTTemplateParams;
+
+/**
+ * Look up a template by name or ID. Returns NULL if unknown.
+ */
+const MeshXTTemplate *meshxt_codebook_find(const char *name);
+const MeshXTTemplate *meshxt_codebook_by_id(uint8_t id);
+
+/**
+ * Encode a template message.
+ *
+ * @param name     Template name (e.g. "ok", "location", "eta")
+ * @param params   Parameters (ignored for simple templates, may be NULL for them)
+ * @param output   Output buffer
+ * @param outSize  Size of output buffer
+ * @return         Encoded length, or -1 on error
+ */
+int meshxt_codebook_encode(const char *name, const MeshXTTemplateParams *params,
+                           uint8_t *output, size_t outSize);
+
+/**
+ * Encode free text as a template if, and only if, it decodes back to
+ * exactly the same text (e.g. "Copy", "ETA 15 minutes", "Battery 42%").
+ * short_text is never chosen here.
+ *
+ * @param text     Input text (null-terminated)
+ * @param output   Output buffer
+ * @param outSize  Size of output buffer
+ * @return         Encoded length, or -1 if no template reproduces the text
+ */
+int meshxt_codebook_match(const char *text, uint8_t *output, size_t outSize);
+
+/**
+ * Decode a template message into text.
+ *
+ * @param input     Encoded bytes
+ * @param inLen     Length of encoded bytes
+ * @param text      Output text buffer (null-terminated); only written on success
+ * @param textSize  Size of text buffer
+ * @return          Text length (excluding null), or -1 on error
+ */
+int meshxt_codebook_decode(const uint8_t *input, size_t inLen, char *text, size_t textSize);
@@ -6,7 +6,7 @@
  * Index in this array IS the encoded byte value.
  * Sorted roughly by frequency in short conversational English.
  */
-static const char *CODEBOOK[MESHXT_CODEBOOK_SIZE] = {
+static constexpr const char *CODEBOOK[MESHXT_CODEBOOK_SIZE] = {
     /* 0x00 */ " ",
     /* 0x01 */ "e",
     /* 0x02 */ "t",
@@ -263,21 +263,99 @@ static const char *CODEBOOK[MESHXT_CODEBOOK_SIZE] = {
     /* 0xFD */ "? ",
 };
 
-// Length cache for codebook entries
-static uint8_t codebook_lens[MESHXT_CODEBOOK_SIZE];
-static bool codebook_init = false;
+// Entry lengths, computed at compile time (flash)
+struct CodebookLens {
+    uint8_t len[MESHXT_CODEBOOK_SIZE];
+};
 
-static void init_codebook_lens() {
-    if (codebook_init) return;
+static constexpr CodebookLens build_codebook_lens() {
+    CodebookLens t{};
     for (int i = 0; i < MESHXT_CODEBOOK_SIZE; i++) {
-        codebook_lens[i] = (uint8_t)strlen(CODEBOOK[i]);
+        uint8_t n = 0;
+        while (CODEBOOK[i][n]) n++;
+        t.len[i] = n;
     }
-    codebook_init = true;
+    return t;
 }
 
-int meshxt_compress(const char *input, uint8_t *output, size_t outSize) {
-    init_codebook_lens();
+static constexpr CodebookLens CODEBOOK_LENS = build_codebook_lens();
+static constexpr const uint8_t *codebook_lens = CODEBOOK_LENS.len;
+
+/**
+ * First-byte bucket index over the codebook, built at compile time and
+ * stored as const data (flash).
+ *
+ * Entries starting with byte b are order[start[b] .. start[b+1]), sorted
+ * longest first (ties by lower index). The first hit in a bucket is
+ * therefore the greedy longest match, identical to a full linear scan.
+ */
+struct CodebookIndex {
+    uint8_t start[257];
+    uint8_t order[MESHXT_CODEBOOK_SIZE];
+};
+
+static constexpr size_t ct_strlen(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+static constexpr CodebookIndex build_codebook_index() {
+    CodebookIndex ix{};
 
+    int count[256] = {};
+    for (int i = 0; i < MESHXT_CODEBOOK_SIZE; i++) {
+        count[(uint8_t)CODEBOOK[i][0]]++;
+    }
+
+    int acc = 0;
+    for (int b = 0; b < 256; b++) {
+        ix.start[b] = (uint8_t)acc;
+        acc += count[b];
+    }
+    ix.start[256] = (uint8_t)acc;
+
+    // Insertion sort into each bucket: length descending, index ascending
+    int filled[256] = {};
+    for (int i = 0; i < MESHXT_CODEBOOK_SIZE; i++) {
+        uint8_t b = (uint8_t)CODEBOOK[i][0];
+        size_t len = ct_strlen(CODEBOOK[i]);
+        int k = ix.start[b] + filled[b]++;
+        while (k > ix.start[b] && ct_strlen(CODEBOOK[ix.order[k - 1]]) < len) {
+            ix.order[k] = ix.order[k - 1];
+            k--;
+        }
+        ix.order[k] = (uint8_t)i;
+    }
+
+    return ix;
+}
+
+static constexpr CodebookIndex CODEBOOK_INDEX = build_codebook_index();
+
+/**
+ * Dictionary accessors for the shared Smaz routines below: the built-in
+ * codebook (const tables, no indirection) and loaded dictionaries.
+ */
+struct BuiltinDict {
+    int count() const { return MESHXT_CODEBOOK_SIZE; }
+    const char *entry(uint8_t i) const { return CODEBOOK[i]; }
+    uint8_t len(uint8_t i) const { return codebook_lens[i]; }
+    int start(int b) const { return CODEBOOK_INDEX.start[b]; }
+    uint8_t order(int k) const { return CODEBOOK_INDEX.order[k]; }
+};
+
+struct LoadedDict {
+    const MeshXTDictionary *d;
+    int count() const { return d->count; }
+    const char *entry(uint8_t i) const { return (const char *)d->blob + d->offset[i]; }
+    uint8_t len(uint8_t i) const { return d->len[i]; }
+    int start(int b) const { return d->start[b]; }
+    uint8_t order(int k) const { return d->order[k]; }
+};
+
+template <typename Dict>
+static int compress_greedy(const Dict &dict, const char *input, uint8_t *output, size_t outSize) {
     size_t inLen = strlen(input);
     size_t pos = 0;
     size_t outPos = 0;
@@ -301,17 +379,18 @@ int meshxt_compress(const char *input, uint8_t *output, size_t outSize) {
     } while(0)
 
     while (pos < inLen) {
-        // Greedy longest match
+        // Greedy longest match: first hit in the bucket for this byte
         int bestIdx = -1;
         uint8_t bestLen = 0;
 
-        for (int i = 0; i < MESHXT_CODEBOOK_SIZE; i++) {
-            uint8_t cLen = codebook_lens[i];
-            if (cLen > bestLen && pos + cLen <= inLen) {
-                if (memcmp(&input[pos], CODEBOOK[i], cLen) == 0) {
-                    bestIdx = i;
-                    bestLen = cLen;
-                }
+        uint8_t first = (uint8_t)input[pos];
+        for (int k = dict.start(first); k < dict.start(first + 1); k++) {
+            uint8_t i = dict.order(k);
+            uint8_t cLen = dict.len(i);
+            if (pos + cLen <= inLen && memcmp(&input[pos + 1], dict.entry(i) + 1, cLen - 1) == 0) {
+                bestIdx = i;
+                bestLen = cLen;
+                break;
             }
         }
 
@@ -335,11 +414,77 @@ int meshxt_compress(const char *input, uint8_t *output, size_t outSize) {
     return (int)outPos;
 }
 
-int meshxt_decompress(const uint8_t *input, size_t inLen, char *output, size_t outSize) {
-    init_codebook_lens();
+template <typename Dict>
+static int compress_optimal(const Dict &dict, const char *input, uint8_t *output, size_t outSize) {
+    size_t inLen = strlen(input);
+    if (inLen > MESHXT_OPTIMAL_MAX_INPUT) {
+        return compress_greedy(dict, input, output, outSize);
+    }
+
+    // Shortest path over positions, solved back to front:
+    //   cost[i] = bytes needed to encode input[i..inLen)
+    // Each step is a codebook byte (1 byte) or a literal run of 1..255
+    // bytes (MESHXT_LITERAL_MARKER + length + bytes).
+    uint16_t cost[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepLen[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepCode[MESHXT_OPTIMAL_MAX_INPUT + 1]; // codebook index, or MESHXT_LITERAL_MARKER
 
+    cost[inLen] = 0;
+    for (size_t i = inLen; i-- > 0;) {
+        uint16_t best = 0xFFFF;
+
+        uint8_t first = (uint8_t)input[i];
+        for (int k = dict.start(first); k < dict.start(first + 1); k++) {
+            uint8_t idx = dict.order(k);
+            uint8_t cLen = dict.len(idx);
+            if (i + cLen > inLen) continue;
+            if (memcmp(&input[i + 1], dict.entry(idx) + 1, cLen - 1) != 0) continue;
+            uint16_t c = 1 + cost[i + cLen];
+            if (c < best) {
+                best = c;
+                stepLen[i] = cLen;
+                stepCode[i] = idx;
+            }
+        }
+
+        size_t maxLit = inLen - i > 255 ? 255 : inLen - i;
+        for (size_t L = 1; L <= maxLit; L++) {
+            uint16_t c = (uint16_t)(2 + L + cost[i + L]);
+            if (c < best) {
+                best = c;
+                stepLen[i] = (uint8_t)L;
+                stepCode[i] = MESHXT_LITERAL_MARKER;
+            }
+        }
+
+        cost[i] = best;
+    }
+
+    if (cost[0] > outSize) return -1;
+
+    size_t pos = 0;
+    size_t outPos = 0;
+    while (pos < inLen) {
+        uint8_t len = stepLen[pos];
+        if (stepCode[pos] == MESHXT_LITERAL_MARKER) {
+            output[outPos++] = MESHXT_LITERAL_MARKER;
+            output[outPos++] = len;
+            memcpy(&output[outPos], &input[pos], len);
+            outPos += len;
+        } else {
+            output[outPos++] = stepCode[pos];
+        }
+        pos += len;
+    }
+
+    return (int)outPos;
+}
+
+template <typename Dict>
+static int decompress(const Dict &dict, const uint8_t *input, size_t inLen, char *output, size_t outSize) {
     size_t pos = 0;
     size_t outPos = 0;
+    if (outSize == 0) return -1;  // No room even for the terminator
 
     while (pos < inLen) {
         uint8_t byte = input[pos];
@@ -357,10 +502,10 @@ int meshxt_decompress(const uint8_t *input, size_t inLen, char *output, size_t o
         } else if (byte == 0xFF) {
             return -1; // Reserved
         } else {
-            if (byte >= MESHXT_CODEBOOK_SIZE) return -1;
-            uint8_t cLen = codebook_lens[byte];
+            if (byte >= dict.count()) return -1;
+            uint8_t cLen = dict.len(byte);
             if (outPos + cLen >= outSize) return -1;
-            memcpy(&output[outPos], CODEBOOK[byte], cLen);
+            memcpy(&output[outPos], dict.entry(byte), cLen);
             outPos += cLen;
             pos++;
         }
@@ -369,3 +514,182 @@ int meshxt_decompress(const uint8_t *input, size_t inLen, char *output, size_t o
     output[outPos] = '\0';
     return (int)outPos;
 }
+
+template <typename Dict>
+static int decompressed_len(const Dict &dict, const uint8_t *input, size_t inLen) {
+    size_t pos = 0;
+    size_t outLen = 0;
+
+    while (pos < inLen) {
+        uint8_t byte = input[pos];
+
+        if (byte == MESHXT_LITERAL_MARKER) {
+            pos++;
+            if (pos >= inLen) return -1;
+            uint8_t len = input[pos];
+            pos++;
+            if (pos + len > inLen) return -1;
+            outLen += len;
+            pos += len;
+        } else if (byte >= dict.count()) {
+            return -1; // unused index, or 0xFF reserved
+        } else {
+            outLen += dict.len(byte);
+            pos++;
+        }
+    }
+
+    return (int)outLen;
+}
+
+template <typename Dict>
+static int decompress_stream(const Dict &dict, const uint8_t *input, size_t inLen, MeshXTTextSink sink,
+                             void *ctx) {
+    int total = decompressed_len(dict, input, inLen);
+    if (total < 0) return -1;
+
+    size_t pos = 0;
+    while (pos < inLen) {
+        uint8_t byte = input[pos];
+
+        if (byte == MESHXT_LITERAL_MARKER) {
+            uint8_t len = input[pos + 1];
+            if (len > 0 && sink((const char *)&input[pos + 2], len, ctx) != 0) return -1;
+            pos += 2 + len;
+        } else {
+            if (sink(dict.entry(byte), dict.len(byte), ctx) != 0) return -1;
+            pos++;
+        }
+    }
+
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// Built-in codebook
+// ---------------------------------------------------------------------------
+
+int meshxt_compress(const char *input, uint8_t *output, size_t outSize) {
+    return compress_greedy(BuiltinDict(), input, output, outSize);
+}
+
+int meshxt_compress_optimal(const char *input, uint8_t *output, size_t outSize) {
+    return compress_optimal(BuiltinDict(), input, output, outSize);
+}
+
+int meshxt_decompress(const uint8_t *input, size_t inLen, char *output, size_t outSize) {
+    return decompress(BuiltinDict(), input, inLen, output, outSize);
+}
+
+int meshxt_decompressed_len(const uint8_t *input, size_t inLen) {
+    return decompressed_len(BuiltinDict(), input, inLen);
+}
+
+int meshxt_decompress_stream(const uint8_t *input, size_t inLen, MeshXTTextSink sink, void *ctx) {
+    return decompress_stream(BuiltinDict(), input, inLen, sink, ctx);
+}
+
+const char *meshxt_codebook_entry(uint8_t index, uint8_t *len) {
+    *len = codebook_lens[index];
+    return CODEBOOK[index];
+}
+
+int meshxt_codebook_bucket(uint8_t first, const uint8_t **indices) {
+    *indices = &CODEBOOK_INDEX.order[CODEBOOK_INDEX.start[first]];
+    return CODEBOOK_INDEX.start[first + 1] - CODEBOOK_INDEX.start[first];
+}
+
+// ---------------------------------------------------------------------------
+// Loaded dictionaries
+// ---------------------------------------------------------------------------
+
+int meshxt_dict_load(MeshXTDictionary *dict, const uint8_t *blob, size_t blobLen) {
+    if (blobLen < MESHXT_DICT_HEADER_SIZE) return -1;
+    if (blob[0] != 'M' || blob[1] != 'X' || blob[2] != 'D' || blob[3] != MESHXT_DICT_FORMAT) return -1;
+
+    uint8_t id = blob[4];
+    uint8_t count = blob[5];
+    if (id == MESHXT_DICT_BUILTIN || count == 0 || count > MESHXT_CODEBOOK_SIZE) return -1;
+
+    // Entries: length byte + text, no NULs (entries are C string fragments)
+    size_t pos = MESHXT_DICT_HEADER_SIZE;
+    int bucketCount[256] = {};
+    for (int i = 0; i < count; i++) {
+        if (pos >= blobLen) return -1;
+        uint8_t len = blob[pos++];
+        if (len == 0 || len > MESHXT_DICT_MAX_ENTRY_LEN || pos + len > blobLen) return -1;
+        if (memchr(blob + pos, 0, len)) return -1;
+        dict->offset[i] = (uint16_t)pos;
+        dict->len[i] = len;
+        bucketCount[blob[pos]]++;
+        pos += len;
+    }
+    if (pos != blobLen) return -1;
+
+    // First-byte bucket index, longest first, as for the built-in codebook
+    int acc = 0;
+    for (int b = 0; b < 256; b++) {
+        dict->start[b] = (uint8_t)acc;
+        acc += bucketCount[b];
+    }
+    dict->start[256] = (uint8_t)acc;
+
+    int filled[256] = {};
+    for (int i = 0; i < count; i++) {
+        uint8_t b = blob[dict->offset[i]];
+        int k = dict->start[b] + filled[b]++;
+        while (k > dict->start[b] && dict->len[dict->order[k - 1]] < dict->len[i]) {
+            dict->order[k] = dict->order[k - 1];
+            k--;
+        }
+        dict->order[k] = (uint8_t)i;
+    }
+
+    dict->blob = blob;
+    dict->blobLen = (uint16_t)blobLen;
+    dict->id = id;
+    dict->count = count;
+    return 0;
+}
+
+int meshxt_compress_dict(const MeshXTDictionary *dict, const char *input, uint8_t *output, size_t outSize) {
+    return compress_optimal(LoadedDict{dict}, input, output, outSize);
+}
+
+int meshxt_decompress_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen, char *output,
+                           size_t outSize) {
+    return decompress(LoadedDict{dict}, input, inLen, output, outSize);
+}
+
+int meshxt_decompressed_len_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen) {
+    return decompressed_len(LoadedDict{dict}, input, inLen);
+}
+
+int meshxt_decompress_stream_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen,
+                                  MeshXTTextSink sink, void *ctx) {
+    return decompress_stream(LoadedDict{dict}, input, inLen, sink, ctx);
+}
+
+static const MeshXTDictionary *registered[MESHXT_DICT_MAX_REGISTERED];
+
+int meshxt_dict_register(const MeshXTDictionary *dict) {
+    int freeSlot = -1;
+    for (int i = 0; i < MESHXT_DICT_MAX_REGISTERED; i++) {
+        if (registered[i] && registered[i]->id == dict->id) {
+            const MeshXTDictionary *held = registered[i];
+            bool same = held->blobLen == dict->blobLen && memcmp(held->blob, dict->blob, dict->blobLen) == 0;
+            return same ? 0 : MESHXT_DICT_ID_CLASH;
+        }
+        if (!registered[i] && freeSlot < 0) freeSlot = i;
+    }
+    if (freeSlot < 0) return -1;
+    registered[freeSlot] = dict;
+    return 0;
+}
+
+const MeshXTDictionary *meshxt_dict_find(uint8_t id) {
+    for (int i = 0; i < MESHXT_DICT_MAX_REGISTERED; i++) {
+        if (registered[i] && registered[i]->id == id) return registered[i];
+    }
+    return NULL;
+}
@@ -9,14 +9,43 @@
  * Optimised for short English text messages typical of Meshtastic.
  * Common substrings encoded as single bytes via a 254-entry codebook.
  *
- * Memory-efficient: uses a flat codebook with linear search
- * (fast enough for messages under 237 bytes on ESP32).
+ * Matching uses a compile-time first-byte bucket index (511 bytes of
+ * flash), so each input position only tries codebook entries that start
+ * with the same byte, longest first.
+ *
+ * Trained dictionaries (meshxt_dict_load) replace the built-in codebook
+ * with entries learned from a channel's own traffic, using the same
+ * byte format: indices 0..count-1, literal runs, 0xFF reserved.
  */
 
 #define MESHXT_LITERAL_MARKER 0xFE
 #define MESHXT_CODEBOOK_SIZE 254
 #define MESHXT_MAX_ENTRY_LEN 6
 
+// Longest input meshxt_compress_optimal parses itself (stack-bounded);
+// longer inputs fall back to the greedy parser
+#define MESHXT_OPTIMAL_MAX_INPUT 256
+
+// Trained dictionary blob: "MXD", format, ID, entry count, then per entry
+// a length byte and the entry text
+#define MESHXT_DICT_HEADER_SIZE    6
+#define MESHXT_DICT_FORMAT         1
+#define MESHXT_DICT_MAX_ENTRY_LEN  16
+#define MESHXT_DICT_BUILTIN        0   // Reserved ID: the built-in codebook
+
+// Dictionaries meshxt_dict_register keeps for packet decoding
+#define MESHXT_DICT_MAX_REGISTERED 4
+
+/**
+ * Sink for streamed decompression output.
+ *
+ * @param chunk  Decoded text bytes (not null-terminated)
+ * @param len    Number of bytes in chunk
+ * @param ctx    Caller context passed through unchanged
+ * @return       0 to continue, non-zero to abort decoding
+ */
+typedef int (*MeshXTTextSink)(const char *chunk, size_t len, void *ctx);
+
 /**
  * Compress a UTF-8 text string.
  *
@@ -27,6 +56,21 @@
  */
 int meshxt_compress(const char *input, uint8_t *output, size_t outSize);
 
+/**
+ * Compress with an optimal parse instead of greedy longest-match.
+ *
+ * Picks the sequence of codebook bytes and literal runs with the fewest
+ * output bytes (dynamic programming over input positions, ~1 KB stack).
+ * Output uses the same format as meshxt_compress and decodes with
+ * meshxt_decompress; it is never longer than the greedy result.
+ *
+ * @param input    Input text (null-terminated)
+ * @param output   Output buffer
+ * @param outSize  Size of output buffer
+ * @return         Number of bytes written to output, or -1 on error
+ */
+int meshxt_compress_optimal(const char *input, uint8_t *output, size_t outSize);
+
 /**
  * Decompress a MeshXT-compressed buffer back to text.
  *
@@ -37,3 +81,106 @@ int meshxt_compress(const char *input, uint8_t *output, size_t outSize);
  * @return         Number of chars written (excluding null), or -1 on error
  */
 int meshxt_decompress(const uint8_t *input, size_t inLen, char *output, size_t outSize);
+
+/**
+ * Validate a compressed buffer and return its decompressed length
+ * without writing any output.
+ *
+ * @param input    Compressed data
+ * @param inLen    Length of compressed data
+ * @return         Decompressed length in chars (excluding null), or -1 if malformed
+ */
+int meshxt_decompressed_len(const uint8_t *input, size_t inLen);
+
+/**
+ * Decompress by streaming chunks to a sink instead of a buffer.
+ *
+ * Each chunk points directly at a codebook entry or a literal run inside
+ * `input`, so nothing is copied. The input is validated first: the sink
+ * never sees output from a malformed buffer.
+ *
+ * @param input    Compressed data
+ * @param inLen    Length of compressed data
+ * @param sink     Receives the decoded text in order
+ * @param ctx      Passed to sink
+ * @return         Total chars delivered, or -1 on malformed input or sink abort
+ */
+int meshxt_decompress_stream(const uint8_t *input, size_t inLen, MeshXTTextSink sink, void *ctx);
+
+/**
+ * Built-in codebook entry (not null-terminated when iterating by length).
+ *
+ * @param index  Entry index (< MESHXT_CODEBOOK_SIZE)
+ * @param len    Set to the entry length
+ */
+const char *meshxt_codebook_entry(uint8_t index, uint8_t *len);
+
+/**
+ * Built-in codebook entries that start with a byte, longest first.
+ *
+ * @param first    First byte of the entries
+ * @param indices  Set to the entry indices
+ * @return         Number of entries
+ */
+int meshxt_codebook_bucket(uint8_t first, const uint8_t **indices);
+
+/**
+ * Trained dictionary, parsed from a blob by meshxt_dict_load. Entries are
+ * read from the blob in place (it may live in flash and must outlive the
+ * dictionary); the index tables take ~1.3 KB.
+ */
+typedef struct {
+    const uint8_t *blob;
+    uint16_t blobLen;
+    uint8_t id;                              // 1..255, the only thing packets carry to name it
+    uint8_t count;                           // Entries (1..MESHXT_CODEBOOK_SIZE)
+    uint16_t offset[MESHXT_CODEBOOK_SIZE];   // Entry text in blob
+    uint8_t len[MESHXT_CODEBOOK_SIZE];
+    uint8_t start[257];                      // First-byte buckets into order[]
+    uint8_t order[MESHXT_CODEBOOK_SIZE];     // Entry indices, longest first per bucket
+} MeshXTDictionary;
+
+/**
+ * Parse and index a trained dictionary blob (see `meshxt train`).
+ *
+ * @param dict     Dictionary to fill
+ * @param blob     Blob bytes; referenced, not copied
+ * @param blobLen  Blob length
+ * @return         0 on success, -1 if the blob is malformed
+ */
+int meshxt_dict_load(MeshXTDictionary *dict, const uint8_t *blob, size_t blobLen);
+
+/**
+ * Compress with a trained dictionary (optimal parse, as
+ * meshxt_compress_optimal). Decode with meshxt_decompress_dict and the
+ * same dictionary.
+ */
+int meshxt_compress_dict(const MeshXTDictionary *dict, const char *input, uint8_t *output, size_t outSize);
+
+/** meshxt_decompress with a trained dictionary. */
+int meshxt_decompress_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen, char *output,
+                           size_t outSize);
+
+/** meshxt_decompressed_len with a trained dictionary. */
+int meshxt_decompressed_len_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen);
+
+/** meshxt_decompress_stream with a trained dictionary. */
+int meshxt_decompress_stream_dict(const MeshXTDictionary *dict, const uint8_t *input, size_t inLen,
+                                  MeshXTTextSink sink, void *ctx);
+
+// meshxt_dict_register result: the ID is held by a dictionary with other entries
+#define MESHXT_DICT_ID_CLASH -2
+
+/**
+ * Make a dictionary available to packet decoding by ID. Registering a
+ * dictionary whose blob matches the one held under its ID does nothing.
+ * A different blob under a held ID is refused: packets name a dictionary
+ * only by ID, so one of the two would decode the other's packets wrongly.
+ *
+ * @return  0 on success, MESHXT_DICT_ID_CLASH, or -1 if
+ *          MESHXT_DICT_MAX_REGISTERED are already held
+ */
+int meshxt_dict_register(const MeshXTDictionary *dict);
+
+/** Registered dictionary with this ID, or NULL. */
+const MeshXTDictionary *meshxt_dict_find(uint8_t id);
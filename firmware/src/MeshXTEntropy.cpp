@@ -0,0 +1,301 @@
+#include "MeshXTEntropy.h"
+#include <string.h>
+
+#include "MeshXTEntropyModel.h"
+
+// Symbols after the 254 codebook indices
+#define SYM_ESCAPE 254  // literal byte follows, coded with ENTROPY_LIT_CUM
+#define SYM_END    255
+
+#define CODE_HALF    0x80000000UL
+#define CODE_QUARTER 0x40000000UL
+
+// A valid stream is finished within 32 bits past its last byte (the
+// decoder's lookahead); reading further means the input is malformed
+#define MAX_OVERRUN_BITS 32
+
+// Longest text decoded, bounding the work a malformed input can cause
+#define MAX_TEXT 0xFFFF
+
+/**
+ * Context of a symbol: class of the character before it (prev < 0 at
+ * the start). Must match contextOf() in tools/gen-entropy-model.js.
+ */
+static int entropy_context(int prev) {
+    if (prev < 0) return 0;
+    if (prev == ' ') return 1;
+    if (prev == 'a' || prev == 'e' || prev == 'i' || prev == 'o' || prev == 'u') return 2;
+    if (prev >= 'a' && prev <= 'z') return 3;
+    if (prev >= 'A' && prev <= 'Z') return 4;
+    if (prev >= '0' && prev <= '9') return 5;
+    if (prev == '.' || prev == '!' || prev == '?') return 6;
+    return 7;
+}
+
+// ---------------------------------------------------------------------------
+// Encoding
+// ---------------------------------------------------------------------------
+
+// round(16 * log2(1 + m/16))
+static const uint8_t LOG2_FRAC[16] = {0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15};
+
+/** Cost of a symbol with this frequency, in 1/16 bits. */
+static uint16_t bit_cost(uint32_t freq) {
+    int n = 0;
+    while ((freq >> (n + 1)) != 0) n++;
+    uint32_t mant = ((freq << 4) >> n) & 0x0F;
+    return (uint16_t)((MESHXT_ENTROPY_PROB_BITS - n) * 16 - LOG2_FRAC[mant]);
+}
+
+static uint16_t sym_cost(const uint16_t *cum, int sym) {
+    return bit_cost(cum[sym + 1] - cum[sym]);
+}
+
+typedef struct {
+    uint32_t low;
+    uint32_t high;
+    uint32_t pending;   // Underflow bits waiting for the next resolved bit
+    uint8_t *out;
+    size_t size;
+    size_t bitPos;
+    bool overflow;
+} Encoder;
+
+static void put_bit(Encoder *e, int bit) {
+    size_t byte = e->bitPos >> 3;
+    if (byte >= e->size) {
+        e->overflow = true;
+        return;
+    }
+    if ((e->bitPos & 7) == 0) e->out[byte] = 0;
+    if (bit) e->out[byte] |= (uint8_t)(0x80 >> (e->bitPos & 7));
+    e->bitPos++;
+}
+
+static void put_bit_pending(Encoder *e, int bit) {
+    put_bit(e, bit);
+    for (; e->pending > 0; e->pending--) put_bit(e, !bit);
+}
+
+static void encode_symbol(Encoder *e, const uint16_t *cum, int sym) {
+    uint64_t range = (uint64_t)(e->high - e->low) + 1;
+    e->high = e->low + (uint32_t)((range * cum[sym + 1]) >> MESHXT_ENTROPY_PROB_BITS) - 1;
+    e->low = e->low + (uint32_t)((range * cum[sym]) >> MESHXT_ENTROPY_PROB_BITS);
+
+    for (;;) {
+        if (e->high < CODE_HALF) {
+            put_bit_pending(e, 0);
+        } else if (e->low >= CODE_HALF) {
+            put_bit_pending(e, 1);
+            e->low -= CODE_HALF;
+            e->high -= CODE_HALF;
+        } else if (e->low >= CODE_QUARTER && e->high < CODE_HALF + CODE_QUARTER) {
+            e->pending++;
+            e->low -= CODE_QUARTER;
+            e->high -= CODE_QUARTER;
+        } else {
+            break;
+        }
+        e->low <<= 1;
+        e->high = (e->high << 1) | 1;
+    }
+}
+
+/**
+ * Finish with the fewest bits whose zero-padded value lies in
+ * [low, high], i.e. low rounded up to the coarsest multiple that fits.
+ */
+static void encode_finish(Encoder *e) {
+    for (int k = 1; k <= 32; k++) {
+        uint64_t unit = (uint64_t)1 << (32 - k);
+        uint64_t v = ((uint64_t)e->low + unit - 1) & ~(unit - 1);
+        if (v > e->high) continue;
+
+        put_bit_pending(e, (int)((v >> 31) & 1));
+        for (int b = 30; b >= 32 - k; b--) put_bit(e, (int)((v >> b) & 1));
+        return;
+    }
+}
+
+int meshxt_compress_entropy(const char *input, uint8_t *output, size_t outSize) {
+    size_t inLen = strlen(input);
+    const uint8_t *in = (const uint8_t *)input;
+
+    Encoder e = {0, 0xFFFFFFFFUL, 0, output, outSize, 0, false};
+
+    // Cheapest parse under the model, solved back to front per segment:
+    //   cost[i] = 1/16 bits needed to encode input[i..segment end)
+    // The context of position i is fixed by input[i - 1], so the cost of a
+    // symbol does not depend on the parse before it.
+    uint32_t cost[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepLen[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepSym[MESHXT_OPTIMAL_MAX_INPUT + 1];
+
+    for (size_t seg = 0; seg < inLen; seg += MESHXT_OPTIMAL_MAX_INPUT) {
+        size_t n = inLen - seg > MESHXT_OPTIMAL_MAX_INPUT ? MESHXT_OPTIMAL_MAX_INPUT : inLen - seg;
+        const uint8_t *s = in + seg;
+
+        cost[n] = seg + n == inLen ? sym_cost(ENTROPY_SYM_CUM[entropy_context(in[inLen - 1])], SYM_END) : 0;
+        for (size_t i = n; i-- > 0;) {
+            int ctx = entropy_context(seg + i > 0 ? in[seg + i - 1] : -1);
+            const uint16_t *cum = ENTROPY_SYM_CUM[ctx];
+
+            uint32_t best = sym_cost(cum, SYM_ESCAPE) + sym_cost(ENTROPY_LIT_CUM[ctx], s[i]) + cost[i + 1];
+            stepLen[i] = 1;
+            stepSym[i] = SYM_ESCAPE;
+
+            const uint8_t *indices;
+            int count = meshxt_codebook_bucket(s[i], &indices);
+            for (int k = 0; k < count; k++) {
+                uint8_t cLen;
+                const char *entry = meshxt_codebook_entry(indices[k], &cLen);
+                if (i + cLen > n || memcmp(&s[i + 1], entry + 1, cLen - 1) != 0) continue;
+                uint32_t c = sym_cost(cum, indices[k]) + cost[i + cLen];
+                if (c < best) {
+                    best = c;
+                    stepLen[i] = cLen;
+                    stepSym[i] = indices[k];
+                }
+            }
+            cost[i] = best;
+        }
+
+        for (size_t i = 0; i < n; i += stepLen[i]) {
+            int ctx = entropy_context(seg + i > 0 ? in[seg + i - 1] : -1);
+            encode_symbol(&e, ENTROPY_SYM_CUM[ctx], stepSym[i]);
+            if (stepSym[i] == SYM_ESCAPE) encode_symbol(&e, ENTROPY_LIT_CUM[ctx], s[i]);
+        }
+        if (e.overflow) return -1;
+    }
+
+    encode_symbol(&e, ENTROPY_SYM_CUM[entropy_context(inLen > 0 ? in[inLen - 1] : -1)], SYM_END);
+    encode_finish(&e);
+    if (e.overflow) return -1;
+
+    return (int)((e.bitPos + 7) >> 3);
+}
+
+// ---------------------------------------------------------------------------
+// Decoding
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t low;
+    uint32_t high;
+    uint32_t value;
+    const uint8_t *in;
+    size_t inLen;
+    size_t bitPos;
+} Decoder;
+
+static int get_bit(Decoder *d) {
+    size_t byte = d->bitPos >> 3;
+    int bit = byte < d->inLen ? (d->in[byte] >> (7 - (d->bitPos & 7))) & 1 : 0;
+    d->bitPos++;
+    return bit;
+}
+
+/** Decode one symbol; -1 once the input is overrun (malformed). */
+static int decode_symbol(Decoder *d, const uint16_t *cum) {
+    uint64_t range = (uint64_t)(d->high - d->low) + 1;
+    uint32_t count =
+        (uint32_t)(((((uint64_t)(d->value - d->low) + 1) << MESHXT_ENTROPY_PROB_BITS) - 1) / range);
+
+    int lo = 0;
+    int hi = 256;  // cum[lo] <= count < cum[hi]
+    while (hi - lo > 1) {
+        int mid = (lo + hi) >> 1;
+        if (cum[mid] <= count) lo = mid;
+        else hi = mid;
+    }
+
+    d->high = d->low + (uint32_t)((range * cum[lo + 1]) >> MESHXT_ENTROPY_PROB_BITS) - 1;
+    d->low = d->low + (uint32_t)((range * cum[lo]) >> MESHXT_ENTROPY_PROB_BITS);
+
+    for (;;) {
+        if (d->high < CODE_HALF) {
+            // nothing to subtract
+        } else if (d->low >= CODE_HALF) {
+            d->low -= CODE_HALF;
+            d->high -= CODE_HALF;
+            d->value -= CODE_HALF;
+        } else if (d->low >= CODE_QUARTER && d->high < CODE_HALF + CODE_QUARTER) {
+            d->low -= CODE_QUARTER;
+            d->high -= CODE_QUARTER;
+            d->value -= CODE_QUARTER;
+        } else {
+            break;
+        }
+        d->low <<= 1;
+        d->high = (d->high << 1) | 1;
+        d->value = (d->value << 1) | (uint32_t)get_bit(d);
+    }
+
+    if (d->bitPos > d->inLen * 8 + MAX_OVERRUN_BITS) return -1;
+    return lo;
+}
+
+/**
+ * Decode to a sink (NULL = count only). Each codebook symbol is one chunk;
+ * literal bytes are delivered one at a time.
+ */
+static int entropy_decode(const uint8_t *input, size_t inLen, MeshXTTextSink sink, void *ctx) {
+    Decoder d = {0, 0xFFFFFFFFUL, 0, input, inLen, 0};
+    for (int i = 0; i < 32; i++) d.value = (d.value << 1) | (uint32_t)get_bit(&d);
+
+    int total = 0;
+    int prev = -1;
+    while (total <= MAX_TEXT) {
+        int c = entropy_context(prev);
+        int sym = decode_symbol(&d, ENTROPY_SYM_CUM[c]);
+        if (sym < 0) return -1;
+        if (sym == SYM_END) return total;
+
+        if (sym == SYM_ESCAPE) {
+            int byte = decode_symbol(&d, ENTROPY_LIT_CUM[c]);
+            if (byte <= 0) return -1;  // overrun, or a NUL the encoder never writes
+            char ch = (char)byte;
+            if (sink && sink(&ch, 1, ctx) != 0) return -1;
+            total++;
+            prev = byte;
+        } else {
+            uint8_t len;
+            const char *entry = meshxt_codebook_entry((uint8_t)sym, &len);
+            if (sink && sink(entry, len, ctx) != 0) return -1;
+            total += len;
+            prev = (uint8_t)entry[len - 1];
+        }
+    }
+    return -1;
+}
+
+typedef struct {
+    char *out;
+    size_t size;
+    size_t pos;
+} BufferSink;
+
+static int buffer_sink(const char *chunk, size_t len, void *ctx) {
+    BufferSink *b = (BufferSink *)ctx;
+    if (b->pos + len >= b->size) return -1;
+    memcpy(b->out + b->pos, chunk, len);
+    b->pos += len;
+    return 0;
+}
+
+int meshxt_decompress_entropy(const uint8_t *input, size_t inLen, char *output, size_t outSize) {
+    if (outSize == 0) return -1;
+    BufferSink b = {output, outSize, 0};
+    int len = entropy_decode(input, inLen, buffer_sink, &b);
+    output[len < 0 ? 0 : len] = '\0';
+    return len;
+}
+
+int meshxt_decompressed_len_entropy(const uint8_t *input, size_t inLen) {
+    return entropy_decode(input, inLen, NULL, NULL);
+}
+
+int meshxt_decompress_entropy_stream(const uint8_t *input, size_t inLen, MeshXTTextSink sink, void *ctx) {
+    if (meshxt_decompressed_len_entropy(input, inLen) < 0) return -1;
+    return entropy_decode(input, inLen, sink, ctx);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "MeshXTCompress.h"
+
+/**
+ * MeshXT Entropy Coding — Smaz tokens through an arithmetic coder
+ *
+ * The text is split into built-in codebook symbols and escaped literal
+ * bytes, as for Smaz, but the symbols are then arithmetic-coded with a
+ * static order-1 model instead of taking a byte each. The context of a
+ * symbol is the class of the character before it (start, space, vowel,
+ * consonant, uppercase, digit, sentence end, other), so a common symbol
+ * in its usual context costs a few bits.
+ *
+ * The model (~8 KB of const tables in flash) is generated from a chat
+ * corpus by firmware/tools/gen-entropy-model.js. The encoder picks the
+ * parse with the fewest model bits, so it costs more CPU than Smaz
+ * (dynamic programming per message, ~1.5 KB stack); decoding is one
+ * binary search per symbol. Integer-only, no heap.
+ *
+ * Stream: 32-bit arithmetic code, most significant bit first, ended by
+ * an end-of-message symbol and the fewest bits that identify it. Bits
+ * after the last byte read as zero.
+ */
+
+#define MESHXT_ENTROPY_CONTEXTS  8
+#define MESHXT_ENTROPY_PROB_BITS 15
+
+/**
+ * Compress text with the entropy coder.
+ *
+ * @param input    Input text (null-terminated)
+ * @param output   Output buffer
+ * @param outSize  Size of output buffer
+ * @return         Number of bytes written, or -1 if it does not fit
+ */
+int meshxt_compress_entropy(const char *input, uint8_t *output, size_t outSize);
+
+/**
+ * Decompress entropy-coded data to text.
+ *
+ * @param input    Compressed data
+ * @param inLen    Length of compressed data
+ * @param output   Output text buffer (null-terminated)
+ * @param outSize  Size of output buffer
+ * @return         Number of chars written (excluding null), or -1 on error
+ */
+int meshxt_decompress_entropy(const uint8_t *input, size_t inLen, char *output, size_t outSize);
+
+/**
+ * Validate entropy-coded data and return its decompressed length.
+ *
+ * @return  Decompressed length in chars, or -1 if malformed
+ */
+int meshxt_decompressed_len_entropy(const uint8_t *input, size_t inLen);
+
+/**
+ * Decompress entropy-coded data to a sink. The input is validated first,
+ * so the sink never sees output from a malformed buffer.
+ *
+ * @return  Total chars delivered, or -1 on malformed input or sink abort
+ */
+int meshxt_decompress_entropy_stream(const uint8_t *input, size_t inLen, MeshXTTextSink sink, void *ctx);
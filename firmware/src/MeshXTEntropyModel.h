@@ -0,0 +1,399 @@
+#pragma once
+
+// Generated by firmware/tools/gen-entropy-model.js from chat-corpus.txt; do not edit.
+// 198 training messages. Held out (50): 1343 bytes, Smaz 1214, entropy ~622.
+//
+// Cumulative frequencies (total 2^15) per context: codebook symbols
+// 0..253, escape (254) and end of message (255); then escaped literal bytes.
+
+#include <stdint.h>
+
+static constexpr uint16_t ENTROPY_SYM_CUM[MESHXT_ENTROPY_CONTEXTS][257] = {
+    {
+        0, 132, 201, 243, 285, 324, 356, 374, 421, 462, 481, 510,
+        536, 537, 542, 545, 553, 560, 570, 575, 583, 592, 604, 609,
+        612, 632, 639, 643, 649, 651, 653, 659, 661, 676, 683, 697,
+        704, 707, 710, 716, 717, 720, 723, 724, 727, 728, 729, 732,
+        733, 739, 740, 750, 751, 752, 753, 754, 758, 759, 762, 763,
+        764, 765, 766, 768, 769, 770, 771, 772, 773, 774, 775, 776,
+        778, 785, 788, 789, 790, 791, 792, 793, 794, 795, 797, 801,
+        802, 803, 804, 806, 807, 808, 809, 810, 811, 812, 813, 814,
+        815, 816, 817, 818, 819, 820, 821, 823, 825, 826, 827, 828,
+        829, 835, 836, 840, 841, 842, 843, 844, 845, 846, 847, 848,
+        849, 850, 875, 876, 877, 878, 879, 880, 881, 882, 883, 884,
+        885, 886, 887, 888, 890, 891, 892, 893, 895, 896, 898, 899,
+        900, 901, 902, 904, 905, 906, 907, 908, 911, 912, 913, 914,
+        915, 916, 917, 918, 919, 920, 921, 922, 923, 924, 925, 926,
+        927, 928, 929, 930, 931, 932, 933, 934, 935, 936, 937, 938,
+        939, 940, 941, 942, 945, 946, 947, 948, 949, 950, 951, 952,
+        953, 954, 955, 956, 958, 959, 960, 961, 962, 963, 964, 965,
+        966, 967, 968, 969, 970, 971, 972, 973, 974, 975, 976, 978,
+        979, 980, 981, 982, 983, 984, 985, 986, 987, 988, 989, 991,
+        992, 993, 994, 995, 996, 997, 998, 999, 1001, 1002, 1003, 1004,
+        1005, 1006, 1007, 1008, 1009, 1010, 1011, 1012, 1013, 1014, 1015, 1016,
+        1017, 1036, 1037, 32699, 32768,
+    },
+    {
+        0, 48, 538, 2006, 2021, 2384, 2686, 3680, 6137, 6907, 8018, 9133,
+        9956, 9957, 9959, 9960, 9963, 9965, 9969, 10087, 10090, 10093, 10736, 10738,
+        10739, 12199, 12202, 12320, 12322, 12323, 12382, 12500, 12501, 12506, 12508, 12513,
+        12515, 12516, 12517, 12519, 12520, 12521, 12522, 12523, 12524, 12525, 12526, 12527,
+        12585, 12587, 12645, 12649, 12650, 12825, 12826, 12827, 13177, 13178, 13179, 13237,
+        13238, 13471, 13472, 13763, 13764, 13765, 13766, 13882, 13883, 13884, 13885, 13886,
+        13887, 13890, 13949, 13950, 13951, 13952, 13953, 13954, 13955, 13956, 13957, 13958,
+        13959, 14075, 14076, 14135, 14368, 14369, 14485, 14486, 14487, 14545, 14546, 14547,
+        14548, 14664, 14665, 14666, 14667, 14842, 14843, 14844, 15193, 15194, 15195, 15196,
+        15197, 15199, 15200, 15202, 15203, 15204, 15205, 15380, 15381, 15497, 15498, 15499,
+        15500, 15501, 15510, 15511, 15512, 15513, 15514, 15515, 15516, 15632, 15633, 15691,
+        15692, 15693, 15694, 15695, 16103, 16104, 16105, 16106, 16397, 16398, 16747, 16748,
+        16923, 16924, 16925, 16926, 16927, 16928, 16929, 16930, 16931, 16932, 16933, 16934,
+        17167, 17168, 17169, 17170, 17171, 17172, 17173, 17174, 17349, 17350, 17408, 17409,
+        17410, 17411, 17412, 17413, 17414, 17415, 17416, 17591, 17592, 17593, 17594, 17595,
+        17596, 17597, 17598, 17599, 17832, 17833, 17834, 17892, 17893, 18068, 18069, 18070,
+        18128, 18129, 18130, 18131, 18422, 18423, 18481, 18482, 18540, 18541, 18542, 18600,
+        18601, 18602, 18660, 18661, 18777, 18778, 18836, 18837, 18838, 18954, 18955, 19130,
+        19131, 19132, 19133, 19308, 19309, 19425, 19426, 19427, 19428, 19429, 19430, 19431,
+        19432, 19433, 19434, 19435, 19436, 19437, 19438, 19439, 19672, 19673, 19674, 19675,
+        19676, 19677, 19678, 19679, 19680, 19681, 19682, 19683, 19684, 19685, 19743, 19744,
+        19745, 19752, 19753, 32743, 32768,
+    },
+    {
+        0, 4663, 5336, 6739, 7897, 8522, 9104, 9518, 10964, 13473, 13519, 15042,
+        17015, 17016, 17099, 17141, 17143, 17472, 17475, 17476, 17683, 17972, 18303, 18837,
+        18879, 19212, 19337, 19420, 19545, 19546, 19588, 19590, 19591, 19636, 19638, 19969,
+        20216, 20299, 20300, 20343, 20466, 20467, 20591, 20673, 20756, 20757, 20758, 20841,
+        20842, 20926, 20927, 21380, 21381, 21382, 21383, 21384, 21385, 21386, 21510, 21511,
+        21512, 21513, 21514, 21515, 21516, 21517, 21558, 21559, 21600, 21601, 21642, 21643,
+        21684, 21727, 21728, 21729, 21730, 21731, 21732, 21733, 21734, 21735, 21736, 21737,
+        21738, 21739, 21740, 21822, 21823, 21824, 21825, 21826, 21827, 21828, 21829, 21911,
+        21912, 21913, 21914, 21915, 21916, 21917, 21918, 22082, 22083, 22084, 22085, 22086,
+        22087, 22088, 22089, 22172, 22173, 22174, 22175, 22176, 22177, 22178, 22179, 22180,
+        22181, 22182, 22639, 22640, 22641, 22642, 22643, 22644, 22645, 22646, 22647, 22648,
+        22689, 22690, 22691, 22692, 22693, 22694, 22695, 22696, 22697, 22698, 22699, 22700,
+        22701, 22702, 22703, 22785, 22826, 22827, 22828, 22829, 22830, 22831, 22832, 22833,
+        22834, 22875, 22876, 22877, 22878, 22879, 22880, 22881, 22882, 22883, 22884, 22885,
+        22886, 22887, 22888, 22889, 22890, 22891, 22892, 22893, 22894, 22895, 22896, 22897,
+        22898, 22899, 22900, 22901, 23025, 23026, 23027, 23028, 23029, 23030, 23031, 23072,
+        23073, 23114, 23115, 23156, 23157, 23158, 23159, 23160, 23161, 23162, 23163, 23164,
+        23165, 23166, 23167, 23168, 23169, 23170, 23171, 23172, 23173, 23174, 23175, 23216,
+        23257, 23258, 23259, 23260, 23261, 23262, 23263, 23264, 23265, 23266, 23267, 23349,
+        23350, 23351, 23352, 23353, 23354, 23355, 23356, 23357, 23358, 23359, 23360, 23361,
+        23362, 23403, 23404, 23405, 23406, 23407, 23448, 23449, 23450, 23451, 23452, 23575,
+        23576, 24113, 24114, 31480, 32768,
+    },
+    {
+        0, 4426, 6978, 7975, 9495, 10636, 11849, 12212, 13192, 13864, 14371, 14807,
+        15026, 15027, 15226, 15371, 15552, 15697, 16221, 16384, 16674, 17036, 17236, 17237,
+        17382, 17727, 18053, 18198, 18397, 18506, 18597, 18796, 18905, 19665, 19991, 20516,
+        20751, 20878, 21023, 21330, 21348, 21493, 21584, 21585, 21694, 21695, 21696, 21805,
+        21806, 22095, 22096, 22404, 22405, 22406, 22407, 22408, 22463, 22517, 22608, 22609,
+        22627, 22628, 22629, 22630, 22631, 22632, 22633, 22634, 22635, 22636, 22637, 22638,
+        22710, 23072, 23181, 23217, 23218, 23236, 23237, 23238, 23239, 23311, 23401, 23582,
+        23583, 23584, 23585, 23586, 23587, 23588, 23589, 23590, 23591, 23592, 23610, 23628,
+        23646, 23647, 23648, 23666, 23684, 23685, 23686, 23704, 23705, 23706, 23707, 23708,
+        23709, 23908, 23909, 24090, 24091, 24092, 24093, 24094, 24095, 24096, 24097, 24115,
+        24116, 24117, 25221, 25222, 25223, 25224, 25225, 25226, 25227, 25228, 25246, 25247,
+        25265, 25266, 25267, 25268, 25269, 25270, 25271, 25272, 25273, 25274, 25275, 25276,
+        25277, 25278, 25296, 25368, 25369, 25370, 25371, 25372, 25463, 25481, 25482, 25483,
+        25484, 25485, 25486, 25487, 25488, 25489, 25490, 25491, 25492, 25493, 25494, 25495,
+        25496, 25497, 25498, 25499, 25500, 25501, 25502, 25503, 25504, 25505, 25541, 25542,
+        25543, 25544, 25562, 25616, 25634, 25635, 25636, 25637, 25638, 25639, 25640, 25658,
+        25659, 25660, 25714, 25732, 25733, 25734, 25735, 25736, 25737, 25738, 25739, 25740,
+        25741, 25742, 25743, 25744, 25745, 25746, 25747, 25748, 25766, 25767, 25785, 25803,
+        25821, 25822, 25823, 25824, 25825, 25826, 25827, 25828, 25829, 25830, 25831, 25867,
+        25868, 25869, 25870, 25871, 25872, 25873, 25874, 25875, 25893, 25894, 25930, 25931,
+        25967, 25968, 25969, 25970, 25971, 25972, 25990, 25991, 25992, 26028, 26029, 26030,
+        26048, 26790, 26808, 30414, 32768,
+    },
+    {
+        0, 704, 5586, 6498, 7847, 12106, 13155, 13900, 14380, 15437, 16328, 16937,
+        16961, 16962, 16966, 16969, 18724, 19021, 19030, 19471, 19770, 19779, 20226, 20230,
+        20233, 20833, 20840, 20844, 21432, 21580, 21582, 22316, 22318, 22332, 22484, 22642,
+        22648, 22651, 22654, 22660, 22661, 22664, 22667, 22668, 22671, 22672, 22673, 22676,
+        22677, 22683, 22684, 22693, 22694, 22695, 22696, 22988, 23137, 23138, 23141, 23142,
+        23143, 23144, 23145, 23147, 23148, 23149, 23150, 23151, 23589, 23590, 23591, 23592,
+        23594, 23601, 23749, 23750, 23751, 23752, 23753, 23754, 23755, 23756, 23904, 23907,
+        23908, 23909, 23910, 24203, 24204, 24642, 24643, 24644, 24645, 24646, 24647, 24648,
+        24649, 24650, 24651, 24652, 24653, 24800, 24801, 24803, 24805, 24806, 24807, 24808,
+        24809, 25542, 25688, 25692, 25693, 25694, 25695, 25696, 25697, 25698, 25699, 25700,
+        25992, 25993, 26016, 26017, 26018, 26019, 26020, 26021, 26022, 26023, 26024, 26025,
+        26026, 26027, 26028, 26029, 26031, 26032, 26033, 26034, 26036, 26037, 26039, 26040,
+        26041, 26042, 26043, 26045, 26046, 26047, 26048, 26049, 26488, 26489, 26635, 26636,
+        26637, 26638, 26639, 26640, 26641, 26642, 26643, 26644, 26645, 26937, 26938, 26939,
+        26940, 26941, 26942, 26943, 26944, 26945, 26946, 26947, 26948, 26949, 26950, 26951,
+        26952, 26953, 26954, 26955, 26958, 26959, 26960, 26961, 26962, 26963, 26964, 26965,
+        26966, 27112, 27113, 27114, 27116, 27117, 27118, 27119, 27120, 27121, 27122, 27123,
+        27124, 27125, 27126, 27127, 27128, 27129, 27130, 27131, 27132, 27133, 27134, 27136,
+        27137, 27138, 27139, 27140, 27141, 27142, 27143, 27144, 27145, 27146, 27147, 27149,
+        27150, 27151, 27152, 27153, 27154, 27155, 27156, 27157, 27159, 27160, 27453, 27454,
+        27455, 27456, 28040, 28041, 28479, 28480, 28481, 28482, 28483, 28630, 28631, 28632,
+        28633, 28651, 28652, 32559, 32768,
+    },
+    {
+        0, 8039, 8436, 8675, 8916, 9141, 9326, 9430, 9697, 9932, 10040, 10208,
+        10356, 10357, 10383, 10401, 10445, 10483, 10541, 10569, 10615, 10669, 10735, 10761,
+        10779, 10891, 10933, 10957, 10993, 11007, 11021, 11057, 11069, 11155, 11193, 12181,
+        12219, 12237, 12253, 12289, 12297, 12313, 12329, 12333, 12349, 12350, 12351, 12367,
+        12369, 12405, 12407, 12463, 12464, 12470, 12471, 12475, 12495, 12501, 12517, 12519,
+        12521, 12529, 12530, 12540, 12541, 12542, 12544, 12548, 12556, 12557, 12559, 12560,
+        12570, 12612, 12628, 12632, 12633, 12635, 12636, 12637, 12638, 12646, 12658, 12678,
+        12679, 12683, 12684, 12694, 12702, 12708, 12712, 12713, 12714, 12716, 12718, 12724,
+        12726, 12730, 12731, 12733, 12735, 12743, 12744, 12754, 12766, 12767, 12768, 12769,
+        12770, 12802, 12804, 12828, 12829, 12830, 12831, 12837, 12838, 12842, 12843, 12845,
+        12849, 12850, 12994, 12995, 12996, 12997, 12998, 12999, 13000, 13004, 13006, 13008,
+        13012, 13013, 13014, 13015, 13029, 13030, 13031, 13032, 13042, 13043, 13055, 13056,
+        13062, 13063, 13065, 13077, 13079, 13080, 13081, 13082, 13098, 13100, 13102, 13103,
+        13111, 13113, 13114, 13115, 13116, 13117, 13118, 13119, 13125, 13129, 13131, 13132,
+        13133, 13134, 13135, 13136, 13137, 13138, 13139, 13145, 13146, 13147, 13151, 13152,
+        13153, 13154, 13156, 13162, 13178, 13179, 13180, 13182, 13183, 13189, 13190, 13194,
+        13196, 13200, 13206, 13210, 13220, 13221, 13223, 13224, 13226, 13227, 13228, 13230,
+        13231, 13232, 13234, 13235, 13239, 13240, 13242, 13243, 13245, 13249, 13251, 13261,
+        13265, 13266, 13267, 13273, 13274, 13278, 13279, 13280, 13281, 13282, 13283, 13293,
+        13294, 13295, 13296, 13297, 13298, 13299, 13300, 13301, 13311, 13312, 13320, 13321,
+        13325, 13327, 13335, 13336, 13342, 13343, 13347, 13348, 13349, 13355, 13357, 13363,
+        13365, 14385, 14387, 23334, 32768,
+    },
+    {
+        0, 1667, 2064, 2303, 2544, 2769, 2954, 3058, 3325, 3560, 3668, 3836,
+        3984, 3985, 4011, 4029, 4073, 4111, 4169, 4197, 4243, 4297, 4363, 4389,
+        4407, 4519, 4561, 4585, 4621, 4635, 4649, 4685, 4697, 4783, 4821, 4899,
+        4937, 4955, 4971, 5007, 5015, 5031, 5047, 5051, 5067, 5068, 5069, 5085,
+        5087, 5123, 5125, 5181, 5182, 5188, 5189, 5193, 5213, 5219, 5235, 5237,
+        5239, 5247, 5248, 5258, 5259, 5260, 5262, 5266, 5274, 5275, 5277, 5278,
+        5288, 5330, 5346, 5350, 5351, 5353, 5354, 5355, 5356, 5364, 5376, 5396,
+        5397, 5401, 5402, 5412, 5420, 5426, 5430, 5431, 5432, 5434, 5436, 5442,
+        5444, 5448, 5449, 5451, 5453, 5461, 5462, 5472, 5484, 5485, 5486, 5487,
+        5488, 5520, 5522, 5546, 5547, 5548, 5549, 5555, 5556, 5560, 5561, 5563,
+        5567, 5568, 5712, 5713, 5714, 5715, 5716, 5717, 5718, 5722, 5724, 5726,
+        5730, 5731, 5732, 5733, 5747, 5748, 5749, 5750, 5760, 5761, 5773, 5774,
+        5780, 5781, 5783, 5795, 5797, 5798, 5799, 5800, 5816, 5818, 5820, 5821,
+        5829, 5831, 5832, 5833, 5834, 5835, 5836, 5837, 5843, 5847, 5849, 5850,
+        5851, 5852, 5853, 5854, 5855, 5856, 5857, 5863, 5864, 5865, 5869, 5870,
+        5871, 5872, 5874, 5880, 5896, 5897, 5898, 5900, 5901, 5907, 5908, 5912,
+        5914, 5918, 5924, 5928, 5938, 5939, 5941, 5942, 5944, 5945, 5946, 5948,
+        5949, 5950, 5952, 5953, 5957, 5958, 5960, 5961, 5963, 5967, 5969, 5979,
+        5983, 5984, 5985, 5991, 5992, 5996, 5997, 5998, 5999, 6000, 6001, 6011,
+        6012, 6013, 6014, 6015, 6016, 6017, 6018, 6019, 6029, 6030, 6038, 6039,
+        6043, 6045, 6053, 6054, 6060, 6061, 6065, 6066, 6067, 6073, 6075, 6081,
+        6083, 6193, 6195, 8771, 32768,
+    },
+    {
+        0, 5420, 6718, 7501, 8290, 9027, 9634, 9974, 10848, 11618, 11971, 12519,
+        13002, 13003, 13088, 13147, 13291, 16394, 16584, 16676, 16827, 17004, 17220, 17305,
+        17364, 17730, 17868, 17947, 18065, 18111, 18157, 18275, 18315, 18596, 18721, 18976,
+        19101, 19160, 19213, 19331, 19358, 19411, 19464, 19478, 19531, 19532, 19533, 19586,
+        19593, 19711, 19718, 19901, 19902, 19922, 19923, 19937, 20003, 20023, 20076, 20083,
+        20090, 20117, 20118, 20151, 20152, 20153, 20160, 20174, 20201, 20202, 20209, 20210,
+        20243, 20381, 20434, 20448, 20449, 20456, 20457, 20458, 20459, 20486, 20526, 20592,
+        20593, 20607, 20608, 20641, 20668, 20688, 20702, 20703, 20704, 20711, 20718, 20738,
+        20745, 20759, 20760, 20767, 20774, 20801, 20802, 20835, 20875, 20876, 20877, 20878,
+        20879, 20984, 20991, 21070, 21071, 21072, 21073, 21093, 21094, 21108, 21109, 21116,
+        21130, 21131, 21601, 21602, 21603, 21604, 21605, 21606, 21607, 21621, 21628, 21635,
+        21649, 21650, 21651, 21652, 21698, 21699, 21700, 21701, 21734, 21735, 21775, 21776,
+        21796, 21797, 21804, 21844, 21851, 21852, 21853, 21854, 21907, 21914, 21921, 21922,
+        21949, 21956, 21957, 21958, 21959, 21960, 21961, 21962, 21982, 21996, 22003, 22004,
+        22005, 22006, 22007, 22008, 22009, 22010, 22011, 22031, 22032, 22033, 22047, 22048,
+        22049, 22050, 22057, 22077, 22130, 22131, 22132, 22139, 22140, 22160, 22161, 22175,
+        22182, 22196, 22216, 22230, 22263, 22264, 22271, 22272, 22279, 22280, 22281, 22288,
+        22289, 22290, 22297, 22298, 22312, 22313, 22320, 22321, 22328, 22342, 22349, 22382,
+        22396, 22397, 22398, 22418, 22419, 22433, 22434, 22435, 22436, 22437, 22438, 25450,
+        25451, 25452, 25453, 25454, 25455, 25456, 25457, 25458, 25491, 25492, 25519, 25520,
+        25534, 25541, 25568, 25569, 25589, 25590, 25604, 25605, 25606, 25626, 25633, 25653,
+        25660, 26019, 26026, 31477, 32768,
+    },
+};
+
+static constexpr uint16_t ENTROPY_LIT_CUM[MESHXT_ENTROPY_CONTEXTS][257] = {
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 37, 38,
+        39, 40, 41, 42, 43, 44, 45, 46, 47, 49, 51, 55,
+        56, 62, 67, 78, 84, 89, 94, 95, 99, 103, 104, 106,
+        107, 108, 109, 110, 145, 146, 1753, 3680, 6249, 7373, 8016, 8819,
+        10426, 11712, 14282, 14764, 14766, 15890, 17014, 19104, 19748, 21195, 21197, 22486,
+        25382, 28910, 29232, 29233, 31641, 31642, 31803, 31804, 31805, 31806, 31807, 31808,
+        31809, 31810, 31811, 31872, 32003, 32004, 32005, 32066, 32131, 32132, 32133, 32134,
+        32195, 32196, 32290, 32291, 32292, 32387, 32391, 32392, 32393, 32394, 32464, 32499,
+        32538, 32540, 32630, 32635, 32636, 32637, 32638, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 36, 37,
+        38, 39, 40, 41, 42, 43, 44, 45, 46, 48, 50, 53,
+        54, 60, 488, 1204, 1633, 2061, 2348, 2349, 2635, 2921, 2922, 2924,
+        2925, 2926, 2927, 2928, 2959, 2960, 2975, 2991, 3012, 3022, 3028, 3035,
+        3191, 3344, 3508, 3512, 3514, 3524, 3534, 3695, 3843, 3856, 3999, 4155,
+        4607, 4781, 4784, 4785, 4805, 4806, 4808, 4809, 4810, 4811, 4812, 4813,
+        4814, 4815, 4816, 9390, 14419, 14420, 14421, 16876, 18205, 18206, 18207, 18208,
+        18968, 18969, 24137, 24138, 24139, 26907, 27051, 27052, 27053, 27054, 29093, 29830,
+        31984, 31986, 32631, 32635, 32636, 32637, 32638, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 37, 38,
+        39, 40, 41, 42, 43, 44, 45, 46, 47, 222, 224, 228,
+        229, 236, 241, 253, 260, 265, 270, 271, 275, 279, 280, 455,
+        456, 457, 458, 459, 1359, 1360, 1378, 1397, 1423, 1435, 1442, 1451,
+        1469, 1484, 1511, 1516, 1518, 1530, 1542, 1566, 1575, 1591, 1593, 1611,
+        1646, 1686, 1690, 1691, 1715, 1716, 1718, 1719, 1720, 1721, 1722, 1723,
+        1724, 1725, 1726, 2482, 9185, 9186, 9187, 11323, 14671, 14672, 14673, 14674,
+        16810, 16811, 19500, 19501, 19502, 25642, 25818, 25819, 25820, 25821, 25896, 29038,
+        29943, 30118, 32285, 32635, 32636, 32637, 32638, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 355, 356,
+        357, 358, 359, 360, 361, 362, 363, 364, 365, 367, 528, 691,
+        692, 698, 703, 714, 720, 725, 730, 731, 735, 739, 740, 742,
+        743, 744, 745, 746, 3803, 3804, 3821, 3839, 3863, 3874, 3880, 3888,
+        3905, 3919, 3944, 3949, 3951, 3962, 3973, 3995, 4003, 4018, 4020, 4037,
+        4069, 4106, 4110, 4111, 4133, 4134, 4136, 4137, 4138, 4139, 4140, 4141,
+        4142, 4143, 4144, 4841, 7517, 7518, 7519, 9489, 12099, 12100, 12101, 12102,
+        16140, 16141, 18144, 18145, 18146, 19673, 19677, 19678, 19679, 19680, 24044, 24079,
+        25232, 25234, 32471, 32635, 32636, 32637, 32638, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 36, 58, 62,
+        66, 70, 74, 78, 82, 86, 90, 94, 98, 111, 124, 146,
+        150, 190, 221, 288, 328, 359, 390, 394, 416, 438, 442, 455,
+        459, 463, 467, 471, 690, 694, 1790, 1902, 2050, 2117, 2157, 2206,
+        2309, 2394, 2551, 2582, 3588, 3655, 3722, 4854, 4903, 5990, 6003, 8092,
+        9287, 10508, 10530, 10534, 10673, 10677, 10690, 10694, 10698, 10702, 10706, 10710,
+        10714, 10718, 10722, 13089, 13909, 13913, 13917, 15291, 16692, 16696, 16700, 16704,
+        17085, 17089, 19662, 19666, 19670, 23245, 23267, 23271, 23275, 23279, 30561, 31773,
+        32019, 32032, 32592, 32623, 32627, 32631, 32635, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 41, 87, 96,
+        105, 114, 123, 132, 141, 150, 159, 168, 177, 205, 233, 2327,
+        2336, 10517, 10582, 14817, 14900, 14965, 17078, 17087, 17133, 17179, 17188, 17216,
+        17225, 17234, 17243, 17252, 17705, 17714, 17926, 18157, 18462, 18601, 18684, 18786,
+        18998, 19174, 19497, 19562, 19590, 19729, 19868, 20154, 20256, 20450, 20478, 20690,
+        21106, 21577, 21623, 21632, 21918, 21927, 21955, 21964, 21973, 21982, 21991, 22000,
+        22009, 22018, 22027, 22812, 24503, 24512, 24521, 25306, 26147, 26156, 26165, 26174,
+        26959, 26968, 28178, 28187, 28196, 29425, 29471, 29480, 29489, 29498, 30394, 30847,
+        31355, 31383, 32538, 32603, 32612, 32621, 32630, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 48, 130, 146,
+        162, 178, 194, 210, 226, 242, 258, 274, 290, 339, 388, 470,
+        486, 634, 749, 995, 4748, 4863, 4978, 4994, 5076, 5158, 5174, 5223,
+        5239, 5255, 5271, 5287, 6092, 6108, 6486, 6897, 7439, 7685, 7833, 8014,
+        8392, 8704, 9279, 9394, 9443, 9689, 9935, 10444, 10625, 10970, 11019, 11397,
+        12136, 12974, 13056, 13072, 13581, 13597, 13646, 13662, 13678, 13694, 13710, 13726,
+        13742, 13758, 13774, 15170, 18176, 18192, 18208, 19604, 21099, 21115, 21131, 21147,
+        22543, 22559, 24711, 24727, 24743, 26927, 27009, 27025, 27041, 27057, 28650, 29455,
+        30358, 30407, 32460, 32575, 32591, 32607, 32623, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+        24, 25, 26, 27, 28, 29, 30, 31, 32, 50, 142, 160,
+        178, 196, 214, 232, 250, 268, 286, 304, 322, 377, 432, 524,
+        542, 708, 837, 1114, 1280, 1409, 1538, 1556, 1648, 1740, 1758, 1813,
+        1831, 1849, 1867, 1885, 2790, 2808, 3233, 3695, 4305, 4582, 4748, 4951,
+        5376, 5727, 6374, 6503, 6558, 6835, 7112, 7685, 7888, 8276, 8331, 8756,
+        9587, 10529, 10621, 10639, 11212, 11230, 11285, 11303, 11321, 11339, 11357, 11375,
+        11393, 11411, 11429, 13000, 16370, 16388, 16406, 17977, 19658, 19676, 19694, 19712,
+        21283, 21301, 23721, 23739, 23757, 26214, 26306, 26324, 26342, 26360, 28152, 29057,
+        30073, 30128, 32438, 32567, 32585, 32603, 32621, 32639, 32640, 32641, 32642, 32643,
+        32644, 32645, 32646, 32647, 32648, 32649, 32650, 32651, 32652, 32653, 32654, 32655,
+        32656, 32657, 32658, 32659, 32660, 32661, 32662, 32663, 32664, 32665, 32666, 32667,
+        32668, 32669, 32670, 32671, 32672, 32673, 32674, 32675, 32676, 32677, 32678, 32679,
+        32680, 32681, 32682, 32683, 32684, 32685, 32686, 32687, 32688, 32689, 32690, 32691,
+        32692, 32693, 32694, 32695, 32696, 32697, 32698, 32699, 32700, 32701, 32702, 32703,
+        32704, 32705, 32706, 32707, 32708, 32709, 32710, 32711, 32712, 32713, 32714, 32715,
+        32716, 32717, 32718, 32719, 32720, 32721, 32722, 32723, 32724, 32725, 32726, 32727,
+        32728, 32729, 32730, 32731, 32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739,
+        32740, 32741, 32742, 32743, 32744, 32745, 32746, 32747, 32748, 32749, 32750, 32751,
+        32752, 32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32762, 32763,
+        32764, 32765, 32766, 32767, 32768,
+    },
+};
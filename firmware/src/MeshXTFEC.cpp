@@ -1,37 +1,101 @@
 #include "MeshXTFEC.h"
 #include <string.h>
 
+// Host SIMD syndrome kernel for gateway builds (x86 with -mssse3 or
+// -march=native, AArch64). MCU targets have neither and keep the scalar path.
+#if !defined(MESHXT_FEC_NO_SIMD)
+#if defined(__SSSE3__)
+#define MESHXT_FEC_SIMD_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define MESHXT_FEC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(MESHXT_FEC_SIMD_SSSE3) || defined(MESHXT_FEC_SIMD_NEON)
+#define MESHXT_FEC_SIMD
+#endif
+
+// Exact-size code for the three standard levels (see MeshXT::RS). On by
+// default for host builds; microcontrollers keep one copy for all parity
+// counts unless built with -DMESHXT_FEC_FIXED_LEVELS=1.
+#ifndef MESHXT_FEC_FIXED_LEVELS
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_NRF52) || defined(NRF52_SERIES)
+#define MESHXT_FEC_FIXED_LEVELS 0
+#else
+#define MESHXT_FEC_FIXED_LEVELS 1
+#endif
+#endif
+
 /**
  * Reed-Solomon over GF(2^8) with primitive polynomial 0x11D
  *
  * Compact implementation suitable for ESP32/nRF52.
  * Uses 512+256 bytes for exp/log tables.
+ *
+ * Build with -DMESHXT_FEC_SPLIT_TABLES to switch the encode and syndrome
+ * inner loops to 4-bit split multiply tables (32 bytes per constant,
+ * ~5.6 KB of const data in flash, no extra RAM): no zero branches and no
+ * dependent log/exp lookups.
+ *
+ * Host builds with SSSE3 or NEON additionally evaluate syndromes 16 bytes
+ * per step with shuffle-based split-table multiplies (disable with
+ * -DMESHXT_FEC_NO_SIMD).
+ *
+ * The codeword routines are templates on the parity count. NSYM > 0
+ * fixes it at compile time, so loops over the parity can be unrolled and
+ * the stack buffers are sized exactly; NSYM = 0 takes it from the nsym
+ * argument, for any multiple of MESHXT_FEC_STEP.
  */
 
+// Buffer size for NSYM parity symbols (the most there can be for NSYM = 0)
+#define RS_CAP(NSYM) ((NSYM) ? (NSYM) : MESHXT_FEC_HIGH)
+
+// Instantiation used for a standard level N
+#if MESHXT_FEC_FIXED_LEVELS
+#define RS_FIXED(N) (N)
+#else
+#define RS_FIXED(N) 0
+#endif
+
 #define GF_SIZE 256
 #define PRIM_POLY 0x11D
 
-static uint8_t gf_exp[512];
-static uint8_t gf_log[256];
-static bool fec_initialized = false;
-
-void meshxt_fec_init(void) {
-    if (fec_initialized) return;
+/**
+ * Exponent and log tables, built at compile time and stored as const data
+ * (flash on ESP32 and nRF52), so there is nothing to initialise and no
+ * shared state to race on. gf_exp is doubled so gf_mul can index
+ * log(a) + log(b) without a modulo; gf_log[0] is unused.
+ */
+struct GFTables {
+    uint8_t exp[512];
+    uint8_t log[256];
+};
 
+static constexpr GFTables gf_build_tables() {
+    GFTables t{};
     int x = 1;
     for (int i = 0; i < 255; i++) {
-        gf_exp[i] = (uint8_t)x;
-        gf_log[x] = (uint8_t)i;
+        t.exp[i] = (uint8_t)x;
+        t.log[x] = (uint8_t)i;
         x <<= 1;
         if (x & 0x100) x ^= PRIM_POLY;
     }
     for (int i = 255; i < 512; i++) {
-        gf_exp[i] = gf_exp[i - 255];
+        t.exp[i] = t.exp[i - 255];
     }
-
-    fec_initialized = true;
+    return t;
 }
 
+static constexpr GFTables GF_TABLES = gf_build_tables();
+static constexpr const uint8_t *gf_exp = GF_TABLES.exp;
+static constexpr const uint8_t *gf_log = GF_TABLES.log;
+
+static_assert(GF_TABLES.exp[8] == (PRIM_POLY & 0xFF) && GF_TABLES.log[2] == 1, "GF(2^8) tables");
+
+void meshxt_fec_init(void) {}
+
 static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
     if (a == 0 || b == 0) return 0;
     return gf_exp[gf_log[a] + gf_log[b]];
@@ -42,53 +106,321 @@ static inline uint8_t gf_div(uint8_t a, uint8_t b) {
     return gf_exp[(gf_log[a] + 255 - gf_log[b]) % 255];
 }
 
+// Table-free GF(2^8) helpers for constant evaluation only
+static constexpr uint8_t ct_gf_mul(uint8_t a, uint8_t b) {
+    uint8_t r = 0;
+    while (b) {
+        if (b & 1) r ^= a;
+        b >>= 1;
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? (PRIM_POLY & 0xFF) : 0));
+    }
+    return r;
+}
+
+static constexpr uint8_t ct_gf_log(uint8_t v) {
+    uint8_t x = 1;
+    for (int i = 0; i < 255; i++) {
+        if (x == v) return (uint8_t)i;
+        x = ct_gf_mul(x, 2);
+    }
+    return 0;
+}
+
 /**
- * Compute RS parity symbols.
- * Generator polynomial built on the fly to save RAM.
  * g(x) = (x - alpha^0)(x - alpha^1)...(x - alpha^(nsym-1))
- * Coefficients stored with gen[0] = x^nsym coefficient (always 1)
+ * coef[k] is the x^k coefficient (coef[nsym] = 1).
  */
-static void rs_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsym) {
-    // Build generator polynomial
-    uint8_t gen[65]; // max nsym = 64, so gen has nsym+1 coefficients
-    memset(gen, 0, sizeof(gen));
-    gen[0] = 1;
-    int genLen = 1;
-
+static constexpr void ct_rs_generator(int nsym, uint8_t *coef) {
+    for (int k = 0; k <= nsym; k++) coef[k] = 0;
+    coef[0] = 1;
+    uint8_t root = 1; // alpha^i
     for (int i = 0; i < nsym; i++) {
-        // Multiply gen by (x - alpha^i)
-        // New polynomial has genLen+1 coefficients
-        for (int j = genLen; j > 0; j--) {
-            gen[j] = gen[j - 1] ^ gf_mul(gen[j], gf_exp[i]);
+        // Multiply g by (x - alpha^i)
+        for (int j = i + 1; j > 0; j--) {
+            coef[j] = coef[j - 1] ^ ct_gf_mul(coef[j], root);
+        }
+        coef[0] = ct_gf_mul(coef[0], root);
+        root = ct_gf_mul(root, 2);
+    }
+}
+
+/**
+ * Generator polynomials for every supported parity count (multiples of
+ * MESHXT_FEC_STEP up to MESHXT_FEC_HIGH), built at compile time and stored
+ * as const data (flash on ESP32 and nRF52 — no PROGMEM accessors needed
+ * on either). 544 bytes for all 16.
+ *
+ * shiftLog holds log(coef[nsym-1-j]) for j < nsym, i.e. log-domain in
+ * shift-register order, so the encoder multiplies with a single gf_exp
+ * lookup. Generator k (nsym = (k+1) * MESHXT_FEC_STEP) starts at offset[k].
+ */
+#define RS_GEN_COUNT (MESHXT_FEC_HIGH / MESHXT_FEC_STEP)
+#define RS_GEN_TOTAL (MESHXT_FEC_STEP * RS_GEN_COUNT * (RS_GEN_COUNT + 1) / 2)
+
+struct RSGeneratorSet {
+    uint16_t offset[RS_GEN_COUNT];
+    uint8_t shiftLog[RS_GEN_TOTAL];
+    bool nonzero;  // no zero coefficients in any g(x)
+};
+
+static constexpr RSGeneratorSet rs_build_generator_set() {
+    RSGeneratorSet set{};
+    set.nonzero = true;
+    int off = 0;
+    for (int k = 0; k < RS_GEN_COUNT; k++) {
+        int nsym = (k + 1) * MESHXT_FEC_STEP;
+        uint8_t coef[MESHXT_FEC_HIGH + 1] = {};
+        ct_rs_generator(nsym, coef);
+        for (int j = 0; j <= nsym; j++) {
+            if (coef[j] == 0) set.nonzero = false;
         }
-        gen[0] = gf_mul(gen[0], gf_exp[i]);
-        genLen++;
+        set.offset[k] = (uint16_t)off;
+        for (int j = 0; j < nsym; j++) {
+            set.shiftLog[off + j] = ct_gf_log(coef[nsym - 1 - j]);
+        }
+        off += nsym;
+    }
+    return set;
+}
+
+static constexpr RSGeneratorSet GEN_SET = rs_build_generator_set();
+
+// The log-domain encoder has no zero branch on the generator side
+static_assert(GEN_SET.nonzero, "zero coefficient in a generator polynomial");
+
+static bool rs_nsym_valid(uint8_t nsym) {
+    return nsym >= MESHXT_FEC_STEP && nsym <= MESHXT_FEC_HIGH && nsym % MESHXT_FEC_STEP == 0;
+}
+
+static const uint8_t *rs_generator_log(uint8_t nsym) {
+    return GEN_SET.shiftLog + GEN_SET.offset[nsym / MESHXT_FEC_STEP - 1];
+}
+
+#if defined(MESHXT_FEC_SPLIT_TABLES) || defined(MESHXT_FEC_SIMD)
+/**
+ * 4-bit split multiply table for a constant c:
+ *   c * x = lo[x & 0x0F] ^ hi[x >> 4]
+ */
+struct GFSplitTable {
+    uint8_t lo[16];
+    uint8_t hi[16];
+};
+
+static constexpr GFSplitTable ct_split_table(uint8_t c) {
+    GFSplitTable t{};
+    for (int i = 0; i < 16; i++) {
+        t.lo[i] = ct_gf_mul(c, (uint8_t)i);
+        t.hi[i] = ct_gf_mul(c, (uint8_t)(i << 4));
     }
+    return t;
+}
 
-    // Systematic encoding: compute remainder of msg(x) * x^nsym mod gen(x)
-    // Using feedback shift register
-    uint8_t reg[65];
+static inline uint8_t gf_mul_split(const GFSplitTable &t, uint8_t x) {
+    return t.lo[x & 0x0F] ^ t.hi[x >> 4];
+}
+
+// One table per syndrome root (or root power), i < 64
+struct RSSplitRoots {
+    GFSplitTable root[MESHXT_FEC_HIGH];
+};
+#endif
+
+#if defined(MESHXT_FEC_SPLIT_TABLES)
+// One table per generator tap, in shift-register order (tap[j] = coef[nsym-1-j])
+template <int NSYM>
+struct RSSplitGenerator {
+    GFSplitTable tap[NSYM];
+};
+
+template <int NSYM>
+static constexpr RSSplitGenerator<NSYM> rs_build_split_generator() {
+    uint8_t coef[NSYM + 1] = {};
+    ct_rs_generator(NSYM, coef);
+    RSSplitGenerator<NSYM> s{};
+    for (int j = 0; j < NSYM; j++) {
+        s.tap[j] = ct_split_table(coef[NSYM - 1 - j]);
+    }
+    return s;
+}
+
+// Split tables for the syndrome roots alpha^i
+static constexpr RSSplitRoots rs_build_split_roots() {
+    RSSplitRoots r{};
+    uint8_t alpha = 1;
+    for (int i = 0; i < MESHXT_FEC_HIGH; i++) {
+        r.root[i] = ct_split_table(alpha);
+        alpha = ct_gf_mul(alpha, 2);
+    }
+    return r;
+}
+
+// Only the three standard levels get split taps; other parity counts use
+// the log-domain encoder
+static constexpr RSSplitGenerator<MESHXT_FEC_LOW>    SPLIT_GEN_LOW    = rs_build_split_generator<MESHXT_FEC_LOW>();
+static constexpr RSSplitGenerator<MESHXT_FEC_MEDIUM> SPLIT_GEN_MEDIUM = rs_build_split_generator<MESHXT_FEC_MEDIUM>();
+static constexpr RSSplitGenerator<MESHXT_FEC_HIGH>   SPLIT_GEN_HIGH   = rs_build_split_generator<MESHXT_FEC_HIGH>();
+static constexpr RSSplitRoots SPLIT_ROOTS = rs_build_split_roots();
+
+static const GFSplitTable *rs_generator_split(uint8_t nsym) {
+    switch (nsym) {
+        case MESHXT_FEC_LOW:    return SPLIT_GEN_LOW.tap;
+        case MESHXT_FEC_MEDIUM: return SPLIT_GEN_MEDIUM.tap;
+        case MESHXT_FEC_HIGH:   return SPLIT_GEN_HIGH.tap;
+        default:                return NULL;
+    }
+}
+#endif // MESHXT_FEC_SPLIT_TABLES
+
+/**
+ * Compute RS parity symbols.
+ * Systematic encoding: remainder of msg(x) * x^nsym mod g(x), using a
+ * feedback shift register with reg[0] as the highest-degree term.
+ */
+template <int NSYM>
+static void rs_encode(const uint8_t *msg, size_t msgLen, uint8_t *parity, uint8_t nsymArg) {
+    const int nsym = NSYM ? NSYM : nsymArg;
+    uint8_t reg[RS_CAP(NSYM)];
     memset(reg, 0, nsym);
 
+#if defined(MESHXT_FEC_SPLIT_TABLES)
+    const GFSplitTable *tap = rs_generator_split(nsym);
+    if (tap) {
+        for (size_t i = 0; i < msgLen; i++) {
+            uint8_t feedback = msg[i] ^ reg[0];
+            for (int j = 0; j < nsym - 1; j++) {
+                reg[j] = reg[j + 1] ^ gf_mul_split(tap[j], feedback);
+            }
+            reg[nsym - 1] = gf_mul_split(tap[nsym - 1], feedback);
+        }
+        memcpy(parity, reg, nsym);
+        return;
+    }
+#endif
+
+    const uint8_t *genLog = rs_generator_log(nsym);
+
     for (size_t i = 0; i < msgLen; i++) {
         uint8_t feedback = msg[i] ^ reg[0];
+        if (feedback == 0) {
+            memmove(reg, reg + 1, nsym - 1);
+            reg[nsym - 1] = 0;
+            continue;
+        }
+        uint8_t fbLog = gf_log[feedback];
         // Shift register
         for (int j = 0; j < nsym - 1; j++) {
-            reg[j] = reg[j + 1] ^ gf_mul(gen[nsym - 1 - j], feedback);
+            reg[j] = reg[j + 1] ^ gf_exp[genLog[j] + fbLog];
         }
-        reg[nsym - 1] = gf_mul(gen[0], feedback);
+        reg[nsym - 1] = gf_exp[genLog[nsym - 1] + fbLog];
     }
 
     // Parity is the register contents
     memcpy(parity, reg, nsym);
 }
 
+#if defined(MESHXT_FEC_SIMD)
+// Split tables for alpha^(16*i), the per-block step of the strided Horner
+// evaluation in rs_syndromes_simd (2 KB, host builds only)
+static constexpr RSSplitRoots rs_build_stride_roots() {
+    RSSplitRoots r{};
+    uint8_t alpha16 = 1;
+    for (int i = 0; i < 16; i++) alpha16 = ct_gf_mul(alpha16, 2);
+
+    uint8_t step = 1;
+    for (int i = 0; i < MESHXT_FEC_HIGH; i++) {
+        r.root[i] = ct_split_table(step);
+        step = ct_gf_mul(step, alpha16);
+    }
+    return r;
+}
+
+static constexpr RSSplitRoots STRIDE_ROOTS = rs_build_stride_roots();
+
+/**
+ * Vector syndromes.
+ *
+ * The received polynomial is split into 16 interleaved strands (lane m
+ * holds every 16th coefficient), front-padded with zeros to a whole number
+ * of blocks:
+ *   R(x) = sum_m x^(15-m) * Q_m(x^16)
+ * For each root every lane runs Horner on the same constant alpha^(16i),
+ * which is a split-table shuffle multiply applied to 16 message bytes at
+ * once. The 16 lane results are then folded with x^(15-m) in scalar code.
+ */
+static void rs_syndromes_simd(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd) {
+    size_t blocks = (len + 15) / 16;
+    size_t pad = blocks * 16 - len;
+
+    uint8_t first[16];
+    memset(first, 0, pad);
+    memcpy(first + pad, msg, 16 - pad);
+
+    for (int i = 0; i < nsym; i++) {
+        const GFSplitTable &t = STRIDE_ROOTS.root[i];
+        uint8_t lanes[16];
+
+#if defined(MESHXT_FEC_SIMD_SSSE3)
+        const __m128i lo = _mm_loadu_si128((const __m128i *)t.lo);
+        const __m128i hi = _mm_loadu_si128((const __m128i *)t.hi);
+        const __m128i nib = _mm_set1_epi8(0x0F);
+
+        __m128i v = _mm_loadu_si128((const __m128i *)first);
+        for (size_t b = 1; b < blocks; b++) {
+            __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, nib));
+            __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v, 4), nib));
+            __m128i c = _mm_loadu_si128((const __m128i *)(msg + b * 16 - pad));
+            v = _mm_xor_si128(_mm_xor_si128(l, h), c);
+        }
+        _mm_storeu_si128((__m128i *)lanes, v);
+#else
+        const uint8x16_t lo = vld1q_u8(t.lo);
+        const uint8x16_t hi = vld1q_u8(t.hi);
+        const uint8x16_t nib = vdupq_n_u8(0x0F);
+
+        uint8x16_t v = vld1q_u8(first);
+        for (size_t b = 1; b < blocks; b++) {
+            uint8x16_t l = vqtbl1q_u8(lo, vandq_u8(v, nib));
+            uint8x16_t h = vqtbl1q_u8(hi, vshrq_n_u8(v, 4));
+            uint8x16_t c = vld1q_u8(msg + b * 16 - pad);
+            v = veorq_u8(veorq_u8(l, h), c);
+        }
+        vst1q_u8(lanes, v);
+#endif
+
+        // synd[i] = sum_m lanes[m] * alpha^(i*(15-m))
+        uint8_t val = 0;
+        for (int m = 0; m < 16; m++) {
+            val ^= gf_mul(lanes[m], gf_exp[(i * (15 - m)) % 255]);
+        }
+        synd[i] = val;
+    }
+}
+#endif // MESHXT_FEC_SIMD
+
 /**
  * Calculate syndromes.
  * S_i = P(alpha^i) where P is the received polynomial.
  * Using Horner's method: result = (...((msg[0] * x + msg[1]) * x + msg[2]) * x + ...)
  */
-static void rs_syndromes(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *synd) {
+template <int NSYM>
+static void rs_syndromes(const uint8_t *msg, size_t len, uint8_t nsymArg, uint8_t *synd) {
+    const int nsym = NSYM ? NSYM : nsymArg;
+#if defined(MESHXT_FEC_SIMD)
+    if (len >= 32) {
+        rs_syndromes_simd(msg, len, nsym, synd);
+        return;
+    }
+#endif
+#if defined(MESHXT_FEC_SPLIT_TABLES)
+    // Byte-outer order: the nsym Horner chains are independent per byte
+    memset(synd, 0, nsym);
+    for (size_t j = 0; j < len; j++) {
+        uint8_t b = msg[j];
+        for (int i = 0; i < nsym; i++) {
+            synd[i] = gf_mul_split(SPLIT_ROOTS.root[i], synd[i]) ^ b;
+        }
+    }
+#else
     for (int i = 0; i < nsym; i++) {
         uint8_t val = 0;
         uint8_t alpha_i = gf_exp[i];
@@ -97,48 +429,549 @@ static void rs_syndromes(const uint8_t *msg, size_t len, uint8_t nsym, uint8_t *
         }
         synd[i] = val;
     }
+#endif
 }
 
 /**
  * Check if all syndromes are zero (no errors).
  */
-static bool rs_check(const uint8_t *synd, uint8_t nsym) {
+template <int NSYM>
+static bool rs_check(const uint8_t *synd, uint8_t nsymArg) {
+    const int nsym = NSYM ? NSYM : nsymArg;
     for (int i = 0; i < nsym; i++) {
         if (synd[i] != 0) return false;
     }
     return true;
 }
 
-int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
-    meshxt_fec_init();
+/**
+ * Berlekamp-Massey: find the error locator polynomial from the syndromes.
+ * Lambda(x) = 1 + L1*x + ... + Lv*x^v, stored lowest degree first.
+ *
+ * With erasures the iteration is seeded with the erasure locator Gamma(x)
+ * of degree f and starts at step f, so the result locates errors and
+ * erasures together.
+ * Returns the locator degree v, or -1 if 2 * errors + f exceeds nsym.
+ */
+template <int NSYM>
+static int rs_find_error_locator(const uint8_t *synd, uint8_t nsymArg, const uint8_t *gamma,
+                                 int numErasures, uint8_t *lambda) {
+    const int nsym = NSYM ? NSYM : nsymArg;
+    uint8_t prev[RS_CAP(NSYM) + 1]; // B(x) — copy of lambda before the last length change
+    uint8_t tmp[RS_CAP(NSYM) + 1];
+
+    memcpy(lambda, gamma, nsym + 1);
+    memcpy(prev, gamma, nsym + 1);
+
+    int L = numErasures;  // current locator degree
+    int m = 1;            // steps since last length change
+    uint8_t b = 1;        // discrepancy at last length change
+
+    for (int r = numErasures; r < nsym; r++) {
+        // Discrepancy: delta = S_r + sum(L_i * S_(r-i))
+        uint8_t delta = synd[r];
+        for (int i = 1; i <= L; i++) {
+            delta ^= gf_mul(lambda[i], synd[r - i]);
+        }
+
+        if (delta == 0) {
+            m++;
+            continue;
+        }
+
+        uint8_t coef = gf_div(delta, b);
+
+        if (2 * L <= r + numErasures) {
+            memcpy(tmp, lambda, nsym + 1);
+            for (int i = 0; i + m <= nsym; i++) {
+                lambda[i + m] ^= gf_mul(coef, prev[i]);
+            }
+            L = r + 1 + numErasures - L;
+            memcpy(prev, tmp, nsym + 1);
+            b = delta;
+            m = 1;
+        } else {
+            for (int i = 0; i + m <= nsym; i++) {
+                lambda[i + m] ^= gf_mul(coef, prev[i]);
+            }
+            m++;
+        }
+    }
+
+    if (2 * L - numErasures > nsym) return -1;
+    return L;
+}
+
+/**
+ * Evaluate a polynomial stored lowest degree first at x.
+ */
+static uint8_t rs_poly_eval_low(const uint8_t *poly, int degree, uint8_t x) {
+    uint8_t val = poly[degree];
+    for (int i = degree - 1; i >= 0; i--) {
+        val = gf_mul(val, x) ^ poly[i];
+    }
+    return val;
+}
+
+/**
+ * Chien search: find the byte positions of the errors.
+ * Position p in the codeword is the coefficient of x^(len-1-p), so its
+ * locator is X = alpha^(len-1-p) and Lambda(X^-1) == 0 marks an error.
+ * Returns the number of roots found.
+ */
+static int rs_find_errors(const uint8_t *lambda, int numErrors, size_t len, uint8_t *errPos) {
+    int found = 0;
+    for (size_t p = 0; p < len; p++) {
+        size_t power = len - 1 - p;
+        uint8_t xInv = gf_exp[(255 - power) % 255];
+        if (rs_poly_eval_low(lambda, numErrors, xInv) == 0) {
+            if (found == numErrors) return -1;
+            errPos[found++] = (uint8_t)p;
+        }
+    }
+    return found;
+}
+
+/**
+ * Forney algorithm: compute error magnitudes and correct msg in place.
+ * Omega(x) = S(x) * Lambda(x) mod x^nsym
+ * e = X * Omega(X^-1) / Lambda'(X^-1)   (first consecutive root alpha^0)
+ */
+template <int NSYM>
+static bool rs_correct_errors(uint8_t *msg, size_t len, const uint8_t *synd, uint8_t nsymArg,
+                              const uint8_t *lambda, int numErrors, const uint8_t *errPos) {
+    const int nsym = NSYM ? NSYM : nsymArg;
+    uint8_t omega[RS_CAP(NSYM)];
+    memset(omega, 0, nsym);
+    for (int i = 0; i < nsym; i++) {
+        for (int j = 0; j <= numErrors && i + j < nsym; j++) {
+            omega[i + j] ^= gf_mul(synd[i], lambda[j]);
+        }
+    }
+
+    // Formal derivative: in GF(2^m) only the odd-degree terms survive
+    uint8_t lambdaPrime[RS_CAP(NSYM)];
+    int primeDeg = numErrors > 0 ? numErrors - 1 : 0;
+    memset(lambdaPrime, 0, sizeof(lambdaPrime));
+    for (int i = 1; i <= numErrors; i += 2) {
+        lambdaPrime[i - 1] = lambda[i];
+    }
+
+    for (int k = 0; k < numErrors; k++) {
+        size_t power = len - 1 - errPos[k];
+        uint8_t x = gf_exp[power];
+        uint8_t xInv = gf_exp[(255 - power) % 255];
 
+        uint8_t denom = rs_poly_eval_low(lambdaPrime, primeDeg, xInv);
+        if (denom == 0) return false;
+
+        uint8_t num = gf_mul(x, rs_poly_eval_low(omega, nsym - 1, xInv));
+        msg[errPos[k]] ^= gf_div(num, denom);
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Codewords and frames
+// ---------------------------------------------------------------------------
+
+template <int NSYM>
+static int rs_encode_codeword(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
     if (dataLen + nsym > 255) return -1;
-    if (nsym != MESHXT_FEC_LOW && nsym != MESHXT_FEC_MEDIUM && nsym != MESHXT_FEC_HIGH) return -1;
+    if (!rs_nsym_valid(nsym)) return -1;
 
-    memcpy(output, data, dataLen);
-    rs_encode(data, dataLen, output + dataLen, nsym);
+    if (output != data) memcpy(output, data, dataLen);
+    rs_encode<NSYM>(data, dataLen, output + dataLen, nsym);
 
     return (int)(dataLen + nsym);
 }
 
-int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
-    meshxt_fec_init();
+template <int NSYM>
+static int rs_decode_codeword(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                              uint8_t *output, uint8_t nsym, int *corrected) {
+    if (corrected) *corrected = 0;
+    if (nsym == 0 || nsym > MESHXT_FEC_HIGH) return -1;
+    if (dataLen < nsym || dataLen > 255) return -1;
+    for (size_t i = 0; i < numErasures; i++) {
+        if (erasures[i] >= dataLen) return -1;
+    }
 
-    if (dataLen < nsym) return -1;
+    size_t msgLen = dataLen - nsym;
 
-    uint8_t synd[64];
-    rs_syndromes(data, dataLen, nsym, synd);
+    uint8_t synd[RS_CAP(NSYM)];
+    rs_syndromes<NSYM>(data, dataLen, nsym, synd);
 
-    if (rs_check(synd, nsym)) {
-        // No errors — just strip parity
-        size_t msgLen = dataLen - nsym;
-        memcpy(output, data, msgLen);
+    if (rs_check<NSYM>(synd, nsym)) {
+        // No errors — just strip parity (any erased bytes were right after all)
+        memmove(output, data, msgLen);
         return (int)msgLen;
     }
 
-    // Error correction using Berlekamp-Massey + Chien search + Forney
-    // For firmware v0.1, we detect but don't correct — return -1
-    // Full correction will be added in v0.2
-    // (Clean decode works; corrupted packets are flagged for retransmit)
-    return -1;
+    // Erasure locator Gamma(x) = prod(1 + X_j * x), duplicates ignored
+    uint8_t gamma[RS_CAP(NSYM) + 1];
+    uint8_t seen[32];
+    int numErased = 0;
+    memset(gamma, 0, nsym + 1);
+    memset(seen, 0, sizeof(seen));
+    gamma[0] = 1;
+    for (size_t i = 0; i < numErasures; i++) {
+        uint8_t p = erasures[i];
+        if (seen[p >> 3] & (1 << (p & 7))) continue;
+        seen[p >> 3] |= (uint8_t)(1 << (p & 7));
+        if (numErased == nsym) return -1;
+
+        uint8_t x = gf_exp[dataLen - 1 - p];
+        for (int d = numErased + 1; d > 0; d--) {
+            gamma[d] ^= gf_mul(gamma[d - 1], x);
+        }
+        numErased++;
+    }
+
+    // Error correction using Berlekamp-Massey + Chien search + Forney,
+    // on a stack copy of the codeword so parity can be re-checked afterwards
+    uint8_t lambda[RS_CAP(NSYM) + 1];
+    int numErrors = rs_find_error_locator<NSYM>(synd, nsym, gamma, numErased, lambda);
+    if (numErrors <= 0) return -1;
+
+    uint8_t errPos[RS_CAP(NSYM)];
+    if (rs_find_errors(lambda, numErrors, dataLen, errPos) != numErrors) return -1;
+
+    uint8_t codeword[255];
+    memcpy(codeword, data, dataLen);
+    if (!rs_correct_errors<NSYM>(codeword, dataLen, synd, nsym, lambda, numErrors, errPos)) return -1;
+
+    // Verify: a miscorrection beyond capacity leaves non-zero syndromes
+    rs_syndromes<NSYM>(codeword, dataLen, nsym, synd);
+    if (!rs_check<NSYM>(synd, nsym)) return -1;
+
+    // Erased bytes that happened to be right are not counted
+    int fixed = 0;
+    for (int k = 0; k < numErrors; k++) {
+        if (codeword[errPos[k]] != data[errPos[k]]) fixed++;
+    }
+
+    memcpy(output, codeword, msgLen);
+    if (corrected) *corrected = fixed;
+    return (int)msgLen;
+}
+
+/**
+ * Interleaved layout: frame byte k belongs to codeword k % depth. The
+ * first dataLen bytes are the data, unchanged; each codeword's parity
+ * follows at the frame positions >= dataLen of its residue class.
+ */
+static bool interleave_valid(size_t msgLen, uint8_t nsym, uint8_t depth) {
+    if (depth < 1 || depth > MESHXT_FEC_MAX_DEPTH) return false;
+    if (msgLen < depth) return false;  // every codeword carries data
+    size_t longest = (msgLen + depth - 1) / depth + nsym;
+    return longest <= 255;
+}
+
+template <int NSYM>
+static int rs_encode_frame(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym, uint8_t depth) {
+    if (depth == 1) return rs_encode_codeword<NSYM>(data, dataLen, output, nsym);
+
+    if (!rs_nsym_valid(nsym)) return -1;
+    if (!interleave_valid(dataLen, nsym, depth)) return -1;
+
+    if (output != data) memcpy(output, data, dataLen);
+
+    uint8_t codeword[255];
+    uint8_t parity[RS_CAP(NSYM)];
+    for (uint8_t j = 0; j < depth; j++) {
+        size_t n = 0;
+        for (size_t k = j; k < dataLen; k += depth) codeword[n++] = data[k];
+        rs_encode<NSYM>(codeword, n, parity, nsym);
+
+        size_t k = dataLen + (j + depth - dataLen % depth) % depth;
+        for (uint8_t p = 0; p < nsym; p++, k += depth) output[k] = parity[p];
+    }
+
+    return (int)(dataLen + (size_t)depth * nsym);
+}
+
+template <int NSYM>
+static int rs_decode_frame(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                           uint8_t *output, uint8_t nsym, uint8_t depth, int *corrected) {
+    if (depth == 1) {
+        return rs_decode_codeword<NSYM>(data, dataLen, erasures, numErasures, output, nsym, corrected);
+    }
+
+    if (corrected) *corrected = 0;
+    if (nsym == 0 || nsym > MESHXT_FEC_HIGH) return -1;
+    if (depth == 0 || dataLen < (size_t)depth * nsym) return -1;
+
+    size_t msgLen = dataLen - (size_t)depth * nsym;
+    if (!interleave_valid(msgLen, nsym, depth)) return -1;
+
+    // Each codeword is gathered, decoded and scattered back on its own,
+    // so a bad codeword fails fast and per-codeword work stays bounded
+    uint8_t codeword[255];
+    uint8_t cwErasures[255];
+    int total = 0;
+    for (uint8_t j = 0; j < depth; j++) {
+        size_t n = 0;
+        for (size_t k = j; k < dataLen; k += depth) codeword[n++] = data[k];
+
+        // Frame position k is byte k / depth of codeword k % depth
+        size_t numCw = 0;
+        for (size_t i = 0; i < numErasures; i++) {
+            if (erasures[i] >= dataLen) return -1;
+            if (erasures[i] % depth == j && numCw < sizeof(cwErasures)) {
+                cwErasures[numCw++] = (uint8_t)(erasures[i] / depth);
+            }
+        }
+
+        int fixed;
+        int cwMsgLen = rs_decode_codeword<NSYM>(codeword, n, cwErasures, numCw, codeword, nsym, &fixed);
+        if (cwMsgLen < 0) return -1;
+
+        size_t i = 0;
+        for (size_t k = j; k < msgLen; k += depth) output[k] = codeword[i++];
+        total += fixed;
+    }
+
+    if (corrected) *corrected = total;
+    return (int)msgLen;
+}
+
+template <int NSYM>
+static int rs_check_frame(const uint8_t *data, size_t dataLen, uint8_t nsym, uint8_t depth) {
+    if (nsym == 0 || nsym > MESHXT_FEC_HIGH) return -1;
+    if (depth == 0 || dataLen < (size_t)depth * nsym) return -1;
+
+    size_t msgLen = dataLen - (size_t)depth * nsym;
+    if (depth == 1 ? dataLen > 255 : !interleave_valid(msgLen, nsym, depth)) return -1;
+
+    uint8_t codeword[255];
+    uint8_t synd[RS_CAP(NSYM)];
+    uint8_t gamma[RS_CAP(NSYM) + 1];
+    uint8_t lambda[RS_CAP(NSYM) + 1];
+    uint8_t errPos[RS_CAP(NSYM)];
+    int result = 0;
+    for (uint8_t j = 0; j < depth; j++) {
+        const uint8_t *cw = data;
+        size_t n = dataLen;
+        if (depth > 1) {
+            n = 0;
+            for (size_t k = j; k < dataLen; k += depth) codeword[n++] = data[k];
+            cw = codeword;
+        }
+
+        rs_syndromes<NSYM>(cw, n, nsym, synd);
+        if (rs_check<NSYM>(synd, nsym)) continue;
+
+        // More errors than can be fixed show as a locator longer than
+        // nsym/2, or one without a root per error inside the codeword
+        memset(gamma, 0, nsym + 1);
+        gamma[0] = 1;
+        int numErrors = rs_find_error_locator<NSYM>(synd, nsym, gamma, 0, lambda);
+        if (numErrors <= 0) return -1;
+        if (rs_find_errors(lambda, numErrors, n, errPos) != numErrors) return -1;
+        result = 1;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Fixed-level API and C entry points
+// ---------------------------------------------------------------------------
+
+namespace MeshXT {
+
+template <uint8_t NSYM>
+int RS<NSYM>::encode(const uint8_t *data, size_t dataLen, uint8_t *output) {
+    return rs_encode_codeword<RS_FIXED(NSYM)>(data, dataLen, output, NSYM);
+}
+
+template <uint8_t NSYM>
+int RS<NSYM>::decode(const uint8_t *data, size_t dataLen, uint8_t *output, int *corrected) {
+    return rs_decode_codeword<RS_FIXED(NSYM)>(data, dataLen, NULL, 0, output, NSYM, corrected);
+}
+
+template <uint8_t NSYM>
+int RS<NSYM>::decodeErasures(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                             uint8_t *output, int *corrected) {
+    return rs_decode_codeword<RS_FIXED(NSYM)>(data, dataLen, erasures, numErasures, output, NSYM, corrected);
+}
+
+template <uint8_t NSYM>
+int RS<NSYM>::encodeInterleaved(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t depth) {
+    return rs_encode_frame<RS_FIXED(NSYM)>(data, dataLen, output, NSYM, depth);
+}
+
+template <uint8_t NSYM>
+int RS<NSYM>::decodeInterleaved(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                                uint8_t *output, uint8_t depth, int *corrected) {
+    return rs_decode_frame<RS_FIXED(NSYM)>(data, dataLen, erasures, numErasures, output, NSYM, depth, corrected);
+}
+
+template <uint8_t NSYM>
+int RS<NSYM>::check(const uint8_t *data, size_t dataLen, uint8_t depth) {
+    return rs_check_frame<RS_FIXED(NSYM)>(data, dataLen, NSYM, depth);
+}
+
+template struct RS<MESHXT_FEC_LOW>;
+template struct RS<MESHXT_FEC_MEDIUM>;
+template struct RS<MESHXT_FEC_HIGH>;
+
+} // namespace MeshXT
+
+/**
+ * The C functions take the parity count at run time: the standard levels
+ * go to their MeshXT::RS instantiation, other counts to the NSYM = 0 code.
+ */
+#define RS_DISPATCH(nsym, call, ...)                                                   \
+    switch (nsym) {                                                                    \
+        case MESHXT_FEC_LOW:    return MeshXT::RS<MESHXT_FEC_LOW>::call(__VA_ARGS__);    \
+        case MESHXT_FEC_MEDIUM: return MeshXT::RS<MESHXT_FEC_MEDIUM>::call(__VA_ARGS__); \
+        case MESHXT_FEC_HIGH:   return MeshXT::RS<MESHXT_FEC_HIGH>::call(__VA_ARGS__);   \
+        default:                break;                                                 \
+    }
+
+int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
+    RS_DISPATCH(nsym, encode, data, dataLen, output);
+    return rs_encode_codeword<0>(data, dataLen, output, nsym);
+}
+
+int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym) {
+    return meshxt_fec_decode_erasures(data, dataLen, NULL, 0, output, nsym, NULL);
+}
+
+int meshxt_fec_decode_ex(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                         int *corrected) {
+    return meshxt_fec_decode_erasures(data, dataLen, NULL, 0, output, nsym, corrected);
+}
+
+int meshxt_fec_decode_erasures(const uint8_t *data, size_t dataLen, const uint8_t *erasures,
+                               size_t numErasures, uint8_t *output, uint8_t nsym, int *corrected) {
+    RS_DISPATCH(nsym, decodeErasures, data, dataLen, erasures, numErasures, output, corrected);
+    return rs_decode_codeword<0>(data, dataLen, erasures, numErasures, output, nsym, corrected);
+}
+
+int meshxt_fec_encode_interleaved(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                                  uint8_t depth) {
+    RS_DISPATCH(nsym, encodeInterleaved, data, dataLen, output, depth);
+    return rs_encode_frame<0>(data, dataLen, output, nsym, depth);
+}
+
+int meshxt_fec_decode_interleaved(const uint8_t *data, size_t dataLen, const uint8_t *erasures,
+                                  size_t numErasures, uint8_t *output, uint8_t nsym, uint8_t depth,
+                                  int *corrected) {
+    RS_DISPATCH(nsym, decodeInterleaved, data, dataLen, erasures, numErasures, output, depth, corrected);
+    return rs_decode_frame<0>(data, dataLen, erasures, numErasures, output, nsym, depth, corrected);
+}
+
+int meshxt_fec_check(const uint8_t *data, size_t dataLen, uint8_t nsym, uint8_t depth) {
+    RS_DISPATCH(nsym, check, data, dataLen, depth);
+    return rs_check_frame<0>(data, dataLen, nsym, depth);
+}
+
+// ---------------------------------------------------------------------------
+// Cross-packet erasure code (Cauchy Reed-Solomon)
+// ---------------------------------------------------------------------------
+
+/**
+ * Cauchy matrix entry for repair chunk r and data chunk j. Repair indices
+ * start at k, so r != j and r ^ j is never zero.
+ */
+static inline uint8_t cauchy_coef(uint8_t r, uint8_t j) {
+    return gf_div(1, (uint8_t)(r ^ j));
+}
+
+int meshxt_fec_repair_encode(const uint8_t *data, uint8_t k, size_t chunkLen, uint8_t index,
+                             uint8_t *out) {
+    if (k == 0 || k > MESHXT_FEC_MAX_CHUNKS) return -1;
+    if (index < k || index >= k + MESHXT_FEC_MAX_REPAIR) return -1;
+
+    memset(out, 0, chunkLen);
+    for (uint8_t j = 0; j < k; j++) {
+        uint8_t c = cauchy_coef(index, j);
+        const uint8_t *chunk = data + (size_t)j * chunkLen;
+        for (size_t i = 0; i < chunkLen; i++) {
+            out[i] ^= gf_mul(c, chunk[i]);
+        }
+    }
+    return 0;
+}
+
+int meshxt_fec_repair_decode(uint8_t *data, uint8_t k, size_t chunkLen, uint8_t *slotIds) {
+    if (k == 0 || k > MESHXT_FEC_MAX_CHUNKS) return -1;
+
+    // Data chunks must sit in their own slot; repair chunks fill the gaps
+    uint32_t seen = 0;
+    uint8_t lost[MESHXT_FEC_MAX_CHUNKS];   // missing data chunk per repair slot
+    uint8_t repair[MESHXT_FEC_MAX_CHUNKS]; // repair chunk index per repair slot
+    int numLost = 0;
+    for (uint8_t p = 0; p < k; p++) {
+        uint8_t id = slotIds[p];
+        if (id >= k + MESHXT_FEC_MAX_REPAIR || (seen & (1UL << id))) return -1;
+        seen |= 1UL << id;
+        if (id == p) continue;
+        if (id < k) return -1;
+        lost[numLost] = p;
+        repair[numLost] = id;
+        numLost++;
+    }
+    if (numLost == 0) return 0;
+
+    // Invert the Cauchy submatrix A[a][b] = coef(repair[a], lost[b])
+    // (always non-singular) by Gauss-Jordan elimination
+    uint8_t a[MESHXT_FEC_MAX_CHUNKS][MESHXT_FEC_MAX_CHUNKS];
+    uint8_t inv[MESHXT_FEC_MAX_CHUNKS][MESHXT_FEC_MAX_CHUNKS];
+    for (int r = 0; r < numLost; r++) {
+        for (int c = 0; c < numLost; c++) {
+            a[r][c] = cauchy_coef(repair[r], lost[c]);
+            inv[r][c] = r == c ? 1 : 0;
+        }
+    }
+    for (int c = 0; c < numLost; c++) {
+        int pivot = c;
+        while (pivot < numLost && a[pivot][c] == 0) pivot++;
+        if (pivot == numLost) return -1;
+        if (pivot != c) {
+            for (int i = 0; i < numLost; i++) {
+                uint8_t t = a[c][i]; a[c][i] = a[pivot][i]; a[pivot][i] = t;
+                t = inv[c][i]; inv[c][i] = inv[pivot][i]; inv[pivot][i] = t;
+            }
+        }
+        uint8_t scale = gf_div(1, a[c][c]);
+        for (int i = 0; i < numLost; i++) {
+            a[c][i] = gf_mul(a[c][i], scale);
+            inv[c][i] = gf_mul(inv[c][i], scale);
+        }
+        for (int r = 0; r < numLost; r++) {
+            uint8_t f = a[r][c];
+            if (r == c || f == 0) continue;
+            for (int i = 0; i < numLost; i++) {
+                a[r][i] ^= gf_mul(f, a[c][i]);
+                inv[r][i] ^= gf_mul(f, inv[c][i]);
+            }
+        }
+    }
+
+    // A is now the identity; reuse it for the repair rows of the code
+    for (int r = 0; r < numLost; r++) {
+        for (uint8_t j = 0; j < k; j++) a[r][j] = slotIds[j] == j ? cauchy_coef(repair[r], j) : 0;
+    }
+
+    // Column by column: strip the known data from each repair byte, then
+    // solve for the lost bytes. Results overwrite the repair slots.
+    uint8_t known[MESHXT_FEC_MAX_CHUNKS];
+    for (size_t i = 0; i < chunkLen; i++) {
+        for (int r = 0; r < numLost; r++) {
+            uint8_t v = data[(size_t)lost[r] * chunkLen + i];
+            for (uint8_t j = 0; j < k; j++) v ^= gf_mul(a[r][j], data[(size_t)j * chunkLen + i]);
+            known[r] = v;
+        }
+        for (int b = 0; b < numLost; b++) {
+            uint8_t v = 0;
+            for (int r = 0; r < numLost; r++) v ^= gf_mul(inv[b][r], known[r]);
+            data[(size_t)lost[b] * chunkLen + i] = v;
+        }
+    }
+
+    for (int b = 0; b < numLost; b++) slotIds[lost[b]] = lost[b];
+    return 0;
 }
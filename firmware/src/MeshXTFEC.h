@@ -12,15 +12,23 @@
  *   MESHXT_FEC_LOW    — 16 parity symbols, corrects up to  8 errors
  *   MESHXT_FEC_MEDIUM — 32 parity symbols, corrects up to 16 errors
  *   MESHXT_FEC_HIGH   — 64 parity symbols, corrects up to 32 errors
+ *
+ * Any multiple of MESHXT_FEC_STEP up to 64 parity symbols is accepted, for
+ * shortened codes sized to the payload.
  */
 
 #define MESHXT_FEC_LOW    16
 #define MESHXT_FEC_MEDIUM 32
 #define MESHXT_FEC_HIGH   64
+#define MESHXT_FEC_STEP   4
+
+// Most codewords one frame can be interleaved across (4-bit header field)
+#define MESHXT_FEC_MAX_DEPTH 15
 
 /**
- * Initialise GF(2^8) lookup tables. Call once at startup.
- * Safe to call multiple times (idempotent).
+ * Does nothing: the GF(2^8) tables are built at compile time. Kept so
+ * existing callers still build; no call is needed before any function
+ * here, from any thread.
  */
 void meshxt_fec_init(void);
 
@@ -29,8 +37,9 @@ void meshxt_fec_init(void);
  *
  * @param data     Input data
  * @param dataLen  Length of input data
- * @param output   Output buffer (must be at least dataLen + nsym bytes)
- * @param nsym     Number of parity symbols (16, 32, or 64)
+ * @param output   Output buffer (must be at least dataLen + nsym bytes).
+ *                 May equal data to append parity in place.
+ * @param nsym     Number of parity symbols (multiple of 4, 4..64)
  * @return         Total output length (dataLen + nsym), or -1 on error
  */
 int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym);
@@ -38,6 +47,10 @@ int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint
 /**
  * Decode and error-correct Reed-Solomon encoded data.
  *
+ * Up to nsym/2 symbol errors anywhere in the codeword are corrected
+ * (Berlekamp-Massey + Chien search + Forney). Works on fixed-size stack
+ * buffers; output may alias data.
+ *
  * @param data     Input data with parity appended
  * @param dataLen  Total length (message + parity)
  * @param output   Output buffer for corrected message (parity stripped)
@@ -45,3 +58,156 @@ int meshxt_fec_encode(const uint8_t *data, size_t dataLen, uint8_t *output, uint
  * @return         Message length (dataLen - nsym), or -1 if uncorrectable
  */
 int meshxt_fec_decode(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym);
+
+/**
+ * Same as meshxt_fec_decode, additionally reporting how many symbols
+ * were corrected.
+ *
+ * @param corrected  Set to the number of corrected symbols (0 for a clean
+ *                   codeword). May be NULL.
+ */
+int meshxt_fec_decode_ex(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                         int *corrected);
+
+/**
+ * Errors-and-erasures decode. Erasures are codeword positions known or
+ * suspected to be bad (e.g. from a failed radio CRC over a region, or a
+ * missing fragment); each costs one parity symbol instead of two, so any
+ * mix of e errors and f erasures with 2e + f <= nsym is corrected.
+ * Listing a position that turns out to be right is harmless.
+ *
+ * @param erasures     Erased byte positions within data (duplicates ignored).
+ *                     May be NULL if numErasures is 0.
+ * @param numErasures  Number of positions
+ * @param corrected    Set to the number of bytes actually changed (may be NULL)
+ * @return             Message length, or -1 if uncorrectable or a position
+ *                     is out of range
+ */
+int meshxt_fec_decode_erasures(const uint8_t *data, size_t dataLen, const uint8_t *erasures,
+                               size_t numErasures, uint8_t *output, uint8_t nsym, int *corrected);
+
+/**
+ * Encode data as `depth` RS codewords interleaved byte by byte, so a burst
+ * of corrupted bytes is spread across codewords. Each codeword carries
+ * nsym parity symbols and at most 255 bytes. Data bytes stay in place
+ * (systematic); depth * nsym parity bytes follow.
+ *
+ * @param depth    Number of codewords (1 = same as meshxt_fec_encode)
+ * @return         Total output length (dataLen + depth * nsym), or -1 on error
+ */
+int meshxt_fec_encode_interleaved(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t nsym,
+                                  uint8_t depth);
+
+/**
+ * Decode a frame from meshxt_fec_encode_interleaved. Codewords are
+ * corrected independently, each up to nsym/2 errors (or 2e + f <= nsym
+ * with erasures). Output may alias data; its contents are unspecified if
+ * -1 is returned.
+ *
+ * @param dataLen      Total frame length (message + depth * nsym)
+ * @param erasures     Erased byte positions within the frame (may be NULL)
+ * @param numErasures  Number of positions
+ * @param corrected    Total symbols corrected across codewords (may be NULL)
+ * @return             Message length, or -1 if any codeword is uncorrectable
+ */
+int meshxt_fec_decode_interleaved(const uint8_t *data, size_t dataLen, const uint8_t *erasures,
+                                  size_t numErasures, uint8_t *output, uint8_t nsym, uint8_t depth,
+                                  int *corrected);
+
+/**
+ * Integrity check without correction, for relays: syndromes of each
+ * codeword and, for damaged ones, the error locator and its roots. Skips
+ * the Forney step, the copy and the parity re-check of a decode.
+ *
+ * @param dataLen  Frame length (message + depth * nsym)
+ * @param depth    Interleaved codewords (1 = plain codeword)
+ * @return         0 if every codeword is clean, 1 if some have errors
+ *                 within the correction capacity (a decode may still
+ *                 fail), -1 if some codeword is certainly uncorrectable
+ *                 or the layout is invalid
+ */
+int meshxt_fec_check(const uint8_t *data, size_t dataLen, uint8_t nsym, uint8_t depth);
+
+// ---------------------------------------------------------------------------
+// Cross-packet erasure code
+// ---------------------------------------------------------------------------
+
+// Most data / repair chunks in one stripe (4-bit fields in the fragment header)
+#define MESHXT_FEC_MAX_CHUNKS  16
+#define MESHXT_FEC_MAX_REPAIR  15
+
+/**
+ * Systematic Cauchy Reed-Solomon code across k equal-length data chunks:
+ * repair chunk r (index k..k+m-1) is sum_j data_j / (r + j) over GF(2^8).
+ * Any k of the k + m chunks rebuild the data. Chunks are lost whole (a
+ * missing packet), so this is a pure erasure code and needs no syndromes.
+ *
+ * @param data      k chunks of chunkLen bytes, contiguous
+ * @param k         Number of data chunks (1..MESHXT_FEC_MAX_CHUNKS)
+ * @param chunkLen  Bytes per chunk
+ * @param index     Repair chunk index, k..k+MESHXT_FEC_MAX_REPAIR-1
+ * @param out       Output repair chunk (chunkLen bytes)
+ * @return          0 on success, -1 on bad arguments
+ */
+int meshxt_fec_repair_encode(const uint8_t *data, uint8_t k, size_t chunkLen, uint8_t index,
+                             uint8_t *out);
+
+/**
+ * Rebuild data chunks in place from a full stripe of k received chunks.
+ * Slot p of `data` holds chunk slotIds[p]: its own data chunk (index p)
+ * or any repair chunk standing in for it. On success every slot holds
+ * its data chunk and slotIds[p] == p.
+ *
+ * @param data      k slots of chunkLen bytes, contiguous (modified)
+ * @param slotIds   Chunk index held by each slot (modified)
+ * @return          0 on success, -1 if an index is invalid or repeated
+ */
+int meshxt_fec_repair_decode(uint8_t *data, uint8_t k, size_t chunkLen, uint8_t *slotIds);
+
+// ---------------------------------------------------------------------------
+// Fixed-level API
+// ---------------------------------------------------------------------------
+
+namespace MeshXT {
+
+/**
+ * Reed-Solomon with the parity count fixed at compile time, for callers
+ * that always use one level (e.g. a gateway). Same codes and errors as
+ * the meshxt_fec_* functions, which dispatch to these for nsym = 16, 32
+ * and 64; on host builds each level is its own code with exact-size
+ * buffers (MESHXT_FEC_FIXED_LEVELS in MeshXTFEC.cpp).
+ */
+template <uint8_t NSYM>
+struct RS {
+    static_assert(NSYM == MESHXT_FEC_LOW || NSYM == MESHXT_FEC_MEDIUM || NSYM == MESHXT_FEC_HIGH,
+                  "MeshXT::RS is instantiated for the standard FEC levels only");
+
+    static constexpr uint8_t nsym = NSYM;
+    static constexpr size_t maxData = 255 - NSYM;  // Message bytes per codeword
+
+    /** As meshxt_fec_encode. */
+    static int encode(const uint8_t *data, size_t dataLen, uint8_t *output);
+
+    /** As meshxt_fec_decode_ex. */
+    static int decode(const uint8_t *data, size_t dataLen, uint8_t *output, int *corrected = NULL);
+
+    /** As meshxt_fec_decode_erasures. */
+    static int decodeErasures(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                              uint8_t *output, int *corrected = NULL);
+
+    /** As meshxt_fec_encode_interleaved. */
+    static int encodeInterleaved(const uint8_t *data, size_t dataLen, uint8_t *output, uint8_t depth);
+
+    /** As meshxt_fec_decode_interleaved. */
+    static int decodeInterleaved(const uint8_t *data, size_t dataLen, const uint8_t *erasures, size_t numErasures,
+                                 uint8_t *output, uint8_t depth, int *corrected = NULL);
+
+    /** As meshxt_fec_check. */
+    static int check(const uint8_t *data, size_t dataLen, uint8_t depth = 1);
+};
+
+extern template struct RS<MESHXT_FEC_LOW>;
+extern template struct RS<MESHXT_FEC_MEDIUM>;
+extern template struct RS<MESHXT_FEC_HIGH>;
+
+} // namespace MeshXT
@@ -0,0 +1,168 @@
+#include "MeshXTFragment.h"
+#include "MeshXTFEC.h"
+#include <string.h>
+
+#define SLOT_EMPTY 0xFF
+
+// ---------------------------------------------------------------------------
+// Sending
+// ---------------------------------------------------------------------------
+
+int meshxt_fragment_message(const char *message, uint8_t compType, uint8_t fecCode, uint8_t msgId,
+                            uint8_t repairPct, MeshXTPacketSink sink, void *ctx) {
+    // Stripe: 2-byte length, the whole message as one FEC-less packet, padding
+    uint8_t stripe[MESHXT_FRAG_MAX_DATA];
+    int packetLen = meshxt_create_large_packet(message, stripe + 2, sizeof(stripe) - 2, compType);
+    if (packetLen < 0) return -1;
+    stripe[0] = (uint8_t)(packetLen >> 8);
+    stripe[1] = (uint8_t)(packetLen & 0xFF);
+    size_t used = 2 + (size_t)packetLen;
+
+    // Fewest fragments that fit the per-frame FEC, then equal chunks
+    size_t room = meshxt_packet_payload_room(fecCode);
+    if (room <= MESHXT_FRAG_HEADER_SIZE) return -1;
+    room -= MESHXT_FRAG_HEADER_SIZE;
+
+    size_t k = (used + room - 1) / room;
+    if (k > MESHXT_FEC_MAX_CHUNKS) return -1;
+    size_t chunkLen = (used + k - 1) / k;
+    if (k * chunkLen > sizeof(stripe)) return -1;
+    memset(stripe + used, 0, k * chunkLen - used);
+
+    size_t m = (k * repairPct + 99) / 100;
+    if (m > MESHXT_FEC_MAX_REPAIR) m = MESHXT_FEC_MAX_REPAIR;
+
+    uint8_t frame[MESHXT_MAX_PACKET_SIZE];
+    uint8_t *payload = frame + MESHXT_HEADER_SIZE;
+    for (size_t index = 0; index < k + m; index++) {
+        payload[0] = msgId;
+        payload[1] = (uint8_t)index;
+        payload[2] = (uint8_t)(((k - 1) << 4) | m);
+
+        uint8_t *chunk = payload + MESHXT_FRAG_HEADER_SIZE;
+        if (index < k) {
+            memcpy(chunk, stripe + index * chunkLen, chunkLen);
+        } else {
+            meshxt_fec_repair_encode(stripe, (uint8_t)k, chunkLen, (uint8_t)index, chunk);
+        }
+
+        int frameLen = meshxt_create_raw_packet(payload, MESHXT_FRAG_HEADER_SIZE + chunkLen, frame,
+                                                MESHXT_COMP_FRAGMENT, fecCode);
+        if (frameLen < 0) return -1;
+        if (sink(frame, frameLen, ctx) != 0) return -1;
+    }
+
+    return (int)(k + m);
+}
+
+// ---------------------------------------------------------------------------
+// Receiving
+// ---------------------------------------------------------------------------
+
+static void slot_reset(MeshXTReassembly *s, uint32_t from, uint8_t msgId, uint8_t k, uint8_t m,
+                       uint8_t chunkLen, uint32_t nowMs) {
+    s->from = from;
+    s->startMs = nowMs;
+    s->msgId = msgId;
+    s->k = k;
+    s->m = m;
+    s->chunkLen = chunkLen;
+    s->count = 0;
+    s->done = false;
+    memset(s->slotIds, SLOT_EMPTY, sizeof(s->slotIds));
+}
+
+void meshxt_reassembler_init(MeshXTReassembler *r) {
+    memset(r, 0, sizeof(MeshXTReassembler));
+}
+
+static bool slot_expired(const MeshXTReassembly *s, uint32_t nowMs) {
+    return (uint32_t)(nowMs - s->startMs) > MESHXT_FRAG_TIMEOUT_MS;
+}
+
+/**
+ * Slot for (from, msgId): the live one collecting it, else a free slot,
+ * else the one that is least useful to keep (expired or delivered first,
+ * then the oldest partial message).
+ */
+static MeshXTReassembly *slot_for(MeshXTReassembler *r, uint32_t from, uint8_t msgId, uint32_t nowMs,
+                                  bool *isNew) {
+    MeshXTReassembly *victim = nullptr;
+    uint32_t victimScore = 0;
+    for (int i = 0; i < MESHXT_FRAG_SLOTS; i++) {
+        MeshXTReassembly *s = &r->slots[i];
+        bool stale = s->from == 0 || slot_expired(s, nowMs);
+        if (!stale && s->from == from && s->msgId == msgId) {
+            *isNew = false;
+            return s;
+        }
+
+        uint32_t age = (uint32_t)(nowMs - s->startMs);
+        uint32_t score = s->from == 0 ? UINT32_MAX
+                       : (stale || s->done) ? UINT32_MAX / 2 + (age >> 1)
+                       : age >> 1;
+        if (!victim || score > victimScore) {
+            victim = s;
+            victimScore = score;
+        }
+    }
+    *isNew = true;
+    return victim;
+}
+
+int meshxt_reassembler_add(MeshXTReassembler *r, uint32_t from, uint8_t *packet, size_t packetLen,
+                           uint32_t nowMs, uint8_t **message) {
+    MeshXTPacketInfo info;
+    int payloadLen = meshxt_packet_decode_fec(packet, packetLen, &info);
+    if (payloadLen <= MESHXT_FRAG_HEADER_SIZE || info.header.compType != MESHXT_COMP_FRAGMENT) return -1;
+
+    const uint8_t *payload = packet + MESHXT_HEADER_SIZE;
+    uint8_t msgId = payload[0];
+    uint8_t index = payload[1];
+    uint8_t k = (uint8_t)((payload[2] >> 4) + 1);
+    uint8_t m = payload[2] & 0x0F;
+    size_t chunkLen = (size_t)payloadLen - MESHXT_FRAG_HEADER_SIZE;
+    if (index >= k + m || (size_t)k * chunkLen > MESHXT_FRAG_MAX_DATA) return -1;
+
+    bool isNew;
+    MeshXTReassembly *s = slot_for(r, from, msgId, nowMs, &isNew);
+    if (!isNew && (s->k != k || s->m != m || s->chunkLen != chunkLen)) {
+        // Same ID, different shape: the sender moved on to a new message
+        isNew = true;
+    }
+    if (isNew) slot_reset(s, from, msgId, k, m, (uint8_t)chunkLen, nowMs);
+    if (s->done) return 0;
+
+    for (uint8_t p = 0; p < k; p++) {
+        if (s->slotIds[p] == index) return 0;  // duplicate
+    }
+
+    // Data fragment j lives in slot j; repair fragments fill free slots and
+    // move aside when the data fragment for their slot turns up
+    uint8_t target = SLOT_EMPTY;
+    uint8_t freeSlot = 0;
+    while (s->slotIds[freeSlot] != SLOT_EMPTY) freeSlot++;  // count < k, so one is free
+    if (index < k) {
+        target = index;
+        if (s->slotIds[target] != SLOT_EMPTY) {
+            memcpy(s->data + freeSlot * chunkLen, s->data + target * chunkLen, chunkLen);
+            s->slotIds[freeSlot] = s->slotIds[target];
+        }
+    } else {
+        target = freeSlot;
+    }
+    memcpy(s->data + target * chunkLen, payload + MESHXT_FRAG_HEADER_SIZE, chunkLen);
+    s->slotIds[target] = index;
+
+    if (++s->count < k) return 0;
+
+    // Full stripe: rebuild the missing data chunks from the repair chunks
+    s->done = true;
+    if (meshxt_fec_repair_decode(s->data, k, chunkLen, s->slotIds) != 0) return -1;
+
+    size_t len = ((size_t)s->data[0] << 8) | s->data[1];
+    if (len < MESHXT_HEADER_SIZE || len + 2 > (size_t)k * chunkLen) return -1;
+
+    *message = s->data + 2;
+    return (int)len;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "MeshXTFEC.h"
+#include "MeshXTPacket.h"
+
+/**
+ * MeshXT Fragmentation — messages longer than one frame
+ *
+ * A message is encoded as one large packet without FEC (header + compressed
+ * payload), prefixed with its length and split into k equal data chunks.
+ * m repair chunks are added with a Cauchy Reed-Solomon code across chunks
+ * (see meshxt_fec_repair_encode), so any k of the k + m fragments rebuild
+ * the message and lost fragments need no ACK or retransmit.
+ *
+ * Each fragment is a normal MeshXT frame with compType MESHXT_COMP_FRAGMENT
+ * and its own per-frame FEC. Its payload is:
+ *
+ *   Byte 0: Message ID (per sender)
+ *   Byte 1: Fragment index (0..k-1 data, k..k+m-1 repair)
+ *   Byte 2: [KKKK MMMM] k - 1 | m
+ *   Byte 3+: Chunk (same length in every fragment of a message)
+ *
+ * Reassembled stripe: [length hi][length lo][packet][zero padding]
+ */
+
+#define MESHXT_FRAG_HEADER_SIZE 3
+
+// Largest stripe (length prefix + packet + padding) a message may use
+#define MESHXT_FRAG_MAX_DATA    512
+
+// Messages reassembled concurrently, and how long a partial one is kept
+#define MESHXT_FRAG_SLOTS       2
+#define MESHXT_FRAG_TIMEOUT_MS  (2UL * 60UL * 1000UL)
+
+/**
+ * Receives each fragment frame as it is built.
+ *
+ * @return  0 to continue, non-zero to stop
+ */
+typedef int (*MeshXTPacketSink)(const uint8_t *packet, size_t len, void *ctx);
+
+/**
+ * Split a message into data and repair fragment frames.
+ *
+ * @param message    Input text (null-terminated)
+ * @param compType   Compression type (MESHXT_COMP_*), optionally | MESHXT_COMP_OPTIMAL
+ * @param fecCode    Per-fragment FEC, with the same options as meshxt_create_packet
+ * @param msgId      Message ID; must differ between a sender's recent messages
+ * @param repairPct  Repair fragments as a percentage of data fragments,
+ *                   rounded up (0 = none, at most MESHXT_FEC_MAX_REPAIR)
+ * @param sink       Receives each fragment frame, data fragments first
+ * @param ctx        Passed to sink
+ * @return           Number of fragments produced, or -1 if the message is
+ *                   too long, fails to compress, or the sink stopped
+ */
+int meshxt_fragment_message(const char *message, uint8_t compType, uint8_t fecCode, uint8_t msgId,
+                            uint8_t repairPct, MeshXTPacketSink sink, void *ctx);
+
+/**
+ * Partial message being collected from one sender.
+ */
+typedef struct {
+    uint32_t from;                       // Sender node (0 = free slot)
+    uint32_t startMs;                    // First fragment heard
+    uint8_t msgId;
+    uint8_t k;                           // Data fragments
+    uint8_t m;                           // Repair fragments
+    uint8_t chunkLen;
+    uint8_t count;                       // Fragments held (== k once rebuilt)
+    bool done;                           // Delivered; later fragments are ignored
+    uint8_t slotIds[MESHXT_FEC_MAX_CHUNKS]; // Fragment held by each chunk slot (0xFF = empty)
+    uint8_t data[MESHXT_FRAG_MAX_DATA];
+} MeshXTReassembly;
+
+/**
+ * Reassembly state. Plain data; allocate statically or as a member.
+ */
+typedef struct {
+    MeshXTReassembly slots[MESHXT_FRAG_SLOTS];
+} MeshXTReassembler;
+
+void meshxt_reassembler_init(MeshXTReassembler *r);
+
+/**
+ * Feed a received fragment frame. FEC repairs are applied to `packet` in
+ * place. When the k-th distinct fragment of a message arrives, the
+ * message is rebuilt and `*message` points at its packet (without FEC;
+ * parse it with meshxt_parse_packet_inplace). The pointer stays valid
+ * until the next call.
+ *
+ * @param from       Sender node
+ * @param packet     Fragment frame (modified)
+ * @param packetLen  Frame length
+ * @param nowMs      Monotonic time in ms
+ * @param message    Set to the rebuilt packet on completion
+ * @return           Rebuilt packet length, 0 if more fragments are needed
+ *                   (or the message was already delivered), -1 on error
+ */
+int meshxt_reassembler_add(MeshXTReassembler *r, uint32_t from, uint8_t *packet, size_t packetLen,
+                           uint32_t nowMs, uint8_t **message);
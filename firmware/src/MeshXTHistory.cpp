@@ -0,0 +1,197 @@
+#include "MeshXTHistory.h"
+#include <string.h>
+
+void meshxt_history_init(MeshXTHistory *h) {
+    h->len = 0;
+}
+
+void meshxt_history_append(MeshXTHistory *h, const char *text, size_t len) {
+    if (len >= MESHXT_HISTORY_SIZE) {
+        memcpy(h->data, text + len - MESHXT_HISTORY_SIZE, MESHXT_HISTORY_SIZE);
+        h->len = MESHXT_HISTORY_SIZE;
+        return;
+    }
+    if (h->len + len > MESHXT_HISTORY_SIZE) {
+        size_t drop = h->len + len - MESHXT_HISTORY_SIZE;
+        memmove(h->data, h->data + drop, h->len - drop);
+        h->len = (uint16_t)(h->len - drop);
+    }
+    memcpy(h->data + h->len, text, len);
+    h->len = (uint16_t)(h->len + len);
+}
+
+uint16_t meshxt_history_checksum(const MeshXTHistory *h) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < h->len; i++) {
+        crc ^= (uint16_t)h->data[i] << 8;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+// ---------------------------------------------------------------------------
+// Compression
+// ---------------------------------------------------------------------------
+
+/** Byte `pos` of the window: history, then the input being compressed. */
+static inline uint8_t window_at(const MeshXTHistory *h, const uint8_t *in, size_t pos) {
+    return pos < h->len ? h->data[pos] : in[pos - h->len];
+}
+
+int meshxt_compress_history(const MeshXTHistory *h, const char *input, uint8_t *output, size_t outSize) {
+    size_t inLen = strlen(input);
+    if (inLen > MESHXT_OPTIMAL_MAX_INPUT) return -1;
+    const uint8_t *in = (const uint8_t *)input;
+
+    // Shortest path as in meshxt_compress_optimal, with back-references
+    // (3 bytes) to the longest earlier match as a third kind of step
+    uint16_t cost[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepLen[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    uint8_t stepCode[MESHXT_OPTIMAL_MAX_INPUT + 1]; // codebook index, literal marker or MESHXT_HISTORY_REF
+    uint16_t stepDist[MESHXT_OPTIMAL_MAX_INPUT + 1];
+
+    cost[inLen] = 0;
+    for (size_t i = inLen; i-- > 0;) {
+        uint16_t best = 0xFFFF;
+
+        const uint8_t *indices;
+        int count = meshxt_codebook_bucket(in[i], &indices);
+        for (int k = 0; k < count; k++) {
+            uint8_t cLen;
+            const char *entry = meshxt_codebook_entry(indices[k], &cLen);
+            if (i + cLen > inLen || memcmp(&in[i + 1], entry + 1, cLen - 1) != 0) continue;
+            uint16_t c = 1 + cost[i + cLen];
+            if (c < best) {
+                best = c;
+                stepLen[i] = cLen;
+                stepCode[i] = indices[k];
+            }
+        }
+
+        size_t maxLit = inLen - i > 255 ? 255 : inLen - i;
+        for (size_t L = 1; L <= maxLit; L++) {
+            uint16_t c = (uint16_t)(2 + L + cost[i + L]);
+            if (c < best) {
+                best = c;
+                stepLen[i] = (uint8_t)L;
+                stepCode[i] = MESHXT_LITERAL_MARKER;
+            }
+        }
+
+        size_t maxLen = inLen - i > MESHXT_HISTORY_MAX_MATCH ? MESHXT_HISTORY_MAX_MATCH : inLen - i;
+        if (maxLen >= MESHXT_HISTORY_MIN_MATCH) {
+            size_t before = h->len + i;
+            size_t maxDist = before > MESHXT_HISTORY_MAX_DIST ? MESHXT_HISTORY_MAX_DIST : before;
+            size_t matchLen = 0;
+            size_t matchDist = 0;
+            for (size_t d = 1; d <= maxDist && matchLen < maxLen; d++) {
+                size_t L = 0;
+                while (L < maxLen && window_at(h, in, before - d + L) == in[i + L]) L++;
+                if (L > matchLen) {
+                    matchLen = L;
+                    matchDist = d;
+                }
+            }
+            for (size_t L = MESHXT_HISTORY_MIN_MATCH; L <= matchLen; L++) {
+                uint16_t c = (uint16_t)(3 + cost[i + L]);
+                if (c < best) {
+                    best = c;
+                    stepLen[i] = (uint8_t)L;
+                    stepCode[i] = MESHXT_HISTORY_REF;
+                    stepDist[i] = (uint16_t)matchDist;
+                }
+            }
+        }
+
+        cost[i] = best;
+    }
+
+    if (cost[0] > outSize) return -1;
+
+    size_t outPos = 0;
+    for (size_t pos = 0; pos < inLen; pos += stepLen[pos]) {
+        uint8_t len = stepLen[pos];
+        if (stepCode[pos] == MESHXT_LITERAL_MARKER) {
+            output[outPos++] = MESHXT_LITERAL_MARKER;
+            output[outPos++] = len;
+            memcpy(&output[outPos], &in[pos], len);
+            outPos += len;
+        } else if (stepCode[pos] == MESHXT_HISTORY_REF) {
+            uint16_t d = stepDist[pos] - 1;
+            output[outPos++] = MESHXT_HISTORY_REF;
+            output[outPos++] = (uint8_t)(((len - MESHXT_HISTORY_MIN_MATCH) << 2) | (d >> 8));
+            output[outPos++] = (uint8_t)(d & 0xFF);
+        } else {
+            output[outPos++] = stepCode[pos];
+        }
+    }
+
+    return (int)outPos;
+}
+
+// ---------------------------------------------------------------------------
+// Decompression
+// ---------------------------------------------------------------------------
+
+/**
+ * Decode (output != NULL) or only validate and measure (output == NULL).
+ * References may reach into the history and into text decoded so far.
+ */
+static int history_decode(const MeshXTHistory *h, const uint8_t *input, size_t inLen, char *output,
+                          size_t outSize) {
+    size_t pos = 0;
+    size_t outPos = 0;
+
+    while (pos < inLen) {
+        uint8_t byte = input[pos++];
+        size_t n;
+
+        if (byte == MESHXT_LITERAL_MARKER) {
+            if (pos >= inLen) return -1;
+            n = input[pos++];
+            if (pos + n > inLen) return -1;
+            if (output) {
+                if (outPos + n >= outSize) return -1;
+                memcpy(&output[outPos], &input[pos], n);
+            }
+            pos += n;
+        } else if (byte == MESHXT_HISTORY_REF) {
+            if (pos + 2 > inLen) return -1;
+            n = (size_t)(input[pos] >> 2) + MESHXT_HISTORY_MIN_MATCH;
+            size_t d = ((size_t)(input[pos] & 0x03) << 8 | input[pos + 1]) + 1;
+            pos += 2;
+            size_t before = h->len + outPos;
+            if (d > before) return -1;
+            if (output) {
+                if (outPos + n >= outSize) return -1;
+                // Byte by byte: the source may overlap the bytes being written
+                for (size_t k = 0; k < n; k++) {
+                    size_t src = before - d + k;
+                    output[outPos + k] = src < h->len ? (char)h->data[src] : output[src - h->len];
+                }
+            }
+        } else {
+            uint8_t cLen;
+            const char *entry = meshxt_codebook_entry(byte, &cLen);
+            n = cLen;
+            if (output) {
+                if (outPos + n >= outSize) return -1;
+                memcpy(&output[outPos], entry, n);
+            }
+        }
+        outPos += n;
+    }
+
+    if (output) output[outPos] = '\0';
+    return (int)outPos;
+}
+
+int meshxt_decompress_history(const MeshXTHistory *h, const uint8_t *input, size_t inLen, char *output,
+                              size_t outSize) {
+    if (outSize == 0) return -1;
+    return history_decode(h, input, inLen, output, outSize);
+}
+
+int meshxt_decompressed_len_history(const MeshXTHistory *h, const uint8_t *input, size_t inLen) {
+    return history_decode(h, input, inLen, NULL, 0);
+}
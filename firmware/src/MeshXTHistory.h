@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "MeshXTCompress.h"
+
+/**
+ * MeshXT Shared History — back-references into earlier messages
+ *
+ * Sender and receiver each keep the last MESHXT_HISTORY_SIZE bytes of
+ * text exchanged in one direction of a conversation. A message can then
+ * copy runs (names, places, phrasing) from that history instead of
+ * spelling them out again.
+ *
+ * The stream is the Smaz format (built-in codebook) plus back-references
+ * in the byte Smaz reserves:
+ *
+ *   0xFF [LLLLLLDD] [DDDDDDDD]  copy L + 4 bytes (4..67) starting
+ *                               D + 1 bytes (1..1024) back in
+ *                               history + text decoded so far
+ *
+ * Packets carry a checksum of the history they were coded against, so a
+ * receiver whose history differs (lost packet, reboot) detects it rather
+ * than decoding wrong text; see meshxt_parse_history_packet.
+ */
+
+#define MESHXT_HISTORY_SIZE      512
+#define MESHXT_HISTORY_REF       0xFF
+#define MESHXT_HISTORY_MIN_MATCH 4
+#define MESHXT_HISTORY_MAX_MATCH (MESHXT_HISTORY_MIN_MATCH + 63)
+#define MESHXT_HISTORY_MAX_DIST  1024
+
+/**
+ * Sliding window of past text for one direction of a conversation.
+ * Plain data; allocate statically or as a member.
+ */
+typedef struct {
+    uint16_t len;
+    uint8_t data[MESHXT_HISTORY_SIZE];
+} MeshXTHistory;
+
+void meshxt_history_init(MeshXTHistory *h);
+
+/**
+ * Append a delivered (or sent) message, dropping the oldest bytes once
+ * the window is full. Both sides must append the same texts in the same
+ * order.
+ */
+void meshxt_history_append(MeshXTHistory *h, const char *text, size_t len);
+
+/** CRC-16/CCITT of the window contents (0xFFFF for an empty window). */
+uint16_t meshxt_history_checksum(const MeshXTHistory *h);
+
+/**
+ * Compress against a history (optimal parse over codebook symbols,
+ * literal runs and back-references). Inputs longer than
+ * MESHXT_OPTIMAL_MAX_INPUT are not supported.
+ *
+ * @param h        History shared with the receiver
+ * @param input    Input text (null-terminated)
+ * @param output   Output buffer
+ * @param outSize  Size of output buffer
+ * @return         Number of bytes written, or -1 on error
+ */
+int meshxt_compress_history(const MeshXTHistory *h, const char *input, uint8_t *output, size_t outSize);
+
+/**
+ * Decompress against a history.
+ *
+ * @return  Number of chars written (excluding null), or -1 on error
+ */
+int meshxt_decompress_history(const MeshXTHistory *h, const uint8_t *input, size_t inLen, char *output,
+                              size_t outSize);
+
+/**
+ * Validate against a history and return the decompressed length.
+ *
+ * @return  Decompressed length in chars, or -1 if malformed
+ */
+int meshxt_decompressed_len_history(const MeshXTHistory *h, const uint8_t *input, size_t inLen);
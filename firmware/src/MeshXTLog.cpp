@@ -0,0 +1,120 @@
+#include "MeshXTLog.h"
+#include <string.h>
+
+#include "MeshXTCompress.h"
+#include "MeshXTPacket.h"
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static const uint8_t *get32(const uint8_t *p, uint32_t *v) {
+    *v = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    return p + 4;
+}
+
+/** Types that decode without other state, as in a batch. */
+static bool stored_type(uint8_t compType) {
+    return compType == MESHXT_COMP_NONE || compType == MESHXT_COMP_SMAZ || compType == MESHXT_COMP_CODEBOOK ||
+           compType == MESHXT_COMP_DICT || compType == MESHXT_COMP_ENTROPY;
+}
+
+int meshxt_log_record(uint8_t *out, size_t outSize, const MeshXTLogRecord *r, const uint8_t *payload, size_t len) {
+    if (len > 255 || outSize < MESHXT_LOG_HEADER_SIZE + len || !stored_type(r->compType)) return -1;
+
+    uint8_t *p = out;
+    p = put32(p, r->from);
+    p = put32(p, r->to);
+    p = put32(p, r->id);
+    p = put32(p, r->rxTime);
+    *p++ = r->channel;
+    *p++ = r->compType;
+    *p++ = (uint8_t)len;
+    memcpy(p, payload, len);
+    return (int)(MESHXT_LOG_HEADER_SIZE + len);
+}
+
+int meshxt_log_record_text(uint8_t *out, size_t outSize, const MeshXTLogRecord *r, const char *text, size_t len) {
+    if (len > 255) return -1;
+
+    char input[256];
+    memcpy(input, text, len);
+    input[len] = '\0';
+
+    MeshXTLogRecord rec = *r;
+    uint8_t payload[255];
+    int n = meshxt_compress(input, payload, sizeof(payload));
+    if (n >= 0 && (size_t)n < len) {
+        rec.compType = MESHXT_COMP_SMAZ;
+        return meshxt_log_record(out, outSize, &rec, payload, (size_t)n);
+    }
+    rec.compType = MESHXT_COMP_NONE;
+    return meshxt_log_record(out, outSize, &rec, (const uint8_t *)text, len);
+}
+
+int meshxt_log_parse(const uint8_t *in, size_t len, MeshXTLogRecord *r) {
+    if (len < MESHXT_LOG_HEADER_SIZE) return -1;
+
+    const uint8_t *p = in;
+    p = get32(p, &r->from);
+    p = get32(p, &r->to);
+    p = get32(p, &r->id);
+    p = get32(p, &r->rxTime);
+    r->channel = *p++;
+    r->compType = *p++;
+    r->len = *p++;
+    r->payload = p;
+    if (!stored_type(r->compType)) return -1;
+    return MESHXT_LOG_HEADER_SIZE + r->len;
+}
+
+int meshxt_log_text(const uint8_t *in, size_t len, char *text, size_t textSize) {
+    MeshXTLogRecord r;
+    int size = meshxt_log_parse(in, len, &r);
+    if (size < 0 || (size_t)size > len) return -1;
+
+    // [compType][len][bytes] closes the header, as in a batch
+    size_t offset = 0;
+    return meshxt_batch_next(in + MESHXT_LOG_HEADER_SIZE - 2, (size_t)size - (MESHXT_LOG_HEADER_SIZE - 2), &offset,
+                             text, textSize, NULL);
+}
+
+// ---------------------------------------------------------------------------
+// Index
+// ---------------------------------------------------------------------------
+
+void meshxt_log_index_init(MeshXTLogIndex *idx) {
+    idx->head = 0;
+    idx->count = 0;
+}
+
+void meshxt_log_index_add(MeshXTLogIndex *idx, uint32_t from, uint32_t rxTime, uint16_t offset, uint8_t segment) {
+    if (idx->count == MESHXT_LOG_INDEX) {
+        idx->head = (uint8_t)((idx->head + 1) % MESHXT_LOG_INDEX);
+        idx->count--;
+    }
+    MeshXTLogRef *ref = &idx->refs[(idx->head + idx->count) % MESHXT_LOG_INDEX];
+    ref->from = from;
+    ref->rxTime = rxTime;
+    ref->offset = offset;
+    ref->segment = segment;
+    idx->count++;
+}
+
+void meshxt_log_index_rotate(MeshXTLogIndex *idx) {
+    // References are in log order, so the older segment's come first
+    while (idx->count > 0 && idx->refs[idx->head].segment == MESHXT_LOG_OLDER) {
+        idx->head = (uint8_t)((idx->head + 1) % MESHXT_LOG_INDEX);
+        idx->count--;
+    }
+    for (size_t i = 0; i < idx->count; i++) idx->refs[(idx->head + i) % MESHXT_LOG_INDEX].segment = MESHXT_LOG_OLDER;
+}
+
+const MeshXTLogRef *meshxt_log_index_get(const MeshXTLogIndex *idx, size_t i) {
+    if (i >= idx->count) return NULL;
+    return &idx->refs[(idx->head + i) % MESHXT_LOG_INDEX];
+}
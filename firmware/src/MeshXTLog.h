@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Message Log — recent messages kept compressed in flash
+ *
+ * Received messages are appended as records to the newer of two segment
+ * files. When it would pass MESHXT_LOG_SEGMENT_SIZE bytes it replaces the
+ * older one and a new segment is started, so the log holds the last one
+ * to two segments of messages. Writes only ever extend a file; nothing
+ * is rewritten in place.
+ *
+ * Record (little-endian):
+ *
+ *   [from u32] [to u32] [id u32] [rxTime u32] [channel] [compType] [len] [len bytes]
+ *
+ * The last three fields are a batch entry (see MeshXTPacket.h): payloads
+ * of a type that decodes on its own are stored as they arrived, other
+ * text is compressed again with meshxt_compress.
+ *
+ * A small index of (from, time, segment, offset) per record is kept in
+ * RAM and rebuilt from the files at boot, so the last N messages can be
+ * read back without scanning the log.
+ */
+
+#define MESHXT_LOG_HEADER_SIZE  19
+#define MESHXT_LOG_MAX_RECORD   (MESHXT_LOG_HEADER_SIZE + 255)
+#define MESHXT_LOG_SEGMENT_SIZE 4096
+#define MESHXT_LOG_INDEX        32  // Most recent records indexed
+
+// Segments
+#define MESHXT_LOG_OLDER 0
+#define MESHXT_LOG_NEWER 1
+
+/** Fields of a record; payload points into the record's buffer. */
+typedef struct {
+    uint32_t from;
+    uint32_t to;
+    uint32_t id;
+    uint32_t rxTime;
+    uint8_t channel;
+    uint8_t compType;
+    uint8_t len;
+    const uint8_t *payload;
+} MeshXTLogRecord;
+
+/** Where one record is. */
+typedef struct {
+    uint32_t from;
+    uint32_t rxTime;
+    uint16_t offset;  // In its segment
+    uint8_t segment;  // MESHXT_LOG_OLDER or MESHXT_LOG_NEWER
+} MeshXTLogRef;
+
+/** Ring of references, oldest first. Plain data; allocate statically or as a member. */
+typedef struct {
+    MeshXTLogRef refs[MESHXT_LOG_INDEX];
+    uint8_t head;
+    uint8_t count;
+} MeshXTLogIndex;
+
+/**
+ * Write a record for a payload of compType (MESHXT_COMP_NONE for plain
+ * text).
+ *
+ * @return  Record size in bytes, or -1 if it does not fit outSize or len > 255
+ */
+int meshxt_log_record(uint8_t *out, size_t outSize, const MeshXTLogRecord *r, const uint8_t *payload, size_t len);
+
+/**
+ * Write a record for plain text, compressed with meshxt_compress unless
+ * that would not make it shorter.
+ *
+ * @return  Record size in bytes, or -1 on error
+ */
+int meshxt_log_record_text(uint8_t *out, size_t outSize, const MeshXTLogRecord *r, const char *text, size_t len);
+
+/**
+ * Parse a record's header.
+ *
+ * @param in   Record bytes
+ * @param len  Bytes available; the header alone is enough for the size
+ * @return     Record size in bytes, or -1 if the header is malformed.
+ *             r->payload is only valid when len covers the whole record.
+ */
+int meshxt_log_parse(const uint8_t *in, size_t len, MeshXTLogRecord *r);
+
+/**
+ * Decompress a whole record.
+ *
+ * @return  Text length (null-terminated), or -1 on error
+ */
+int meshxt_log_text(const uint8_t *in, size_t len, char *text, size_t textSize);
+
+void meshxt_log_index_init(MeshXTLogIndex *idx);
+
+/** Index a record just appended to the newer segment; drops the oldest reference when full. */
+void meshxt_log_index_add(MeshXTLogIndex *idx, uint32_t from, uint32_t rxTime, uint16_t offset, uint8_t segment);
+
+/** The newer segment became the older one: drop the old one's references and renumber. */
+void meshxt_log_index_rotate(MeshXTLogIndex *idx);
+
+/** Reference i, 0 = oldest indexed; NULL if i >= count. */
+const MeshXTLogRef *meshxt_log_index_get(const MeshXTLogIndex *idx, size_t i);
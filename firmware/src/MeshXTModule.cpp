@@ -2,10 +2,12 @@
 
 #if defined(MESHTASTIC_FIRMWARE)
 
+#include "MeshXTFEC.h"
 #include "MeshService.h"
 #include "NodeDB.h"
 #include "PowerFSM.h"
 #include "Router.h"
+#include "FSCommon.h"
 #include "configuration.h"
 #include "main.h"
 
@@ -18,51 +20,440 @@ MeshXTModule *meshXTModule;
  */
 #define MESHXT_PORTNUM meshtastic_PortNum_PRIVATE_APP
 
+// Meshtastic transmits a 16-symbol preamble on every preset
+#define MESHXT_LORA_PREAMBLE 16
+
+// Longest reassembled text delivered to the phone (in TEXT_MESSAGE_APP-sized pieces)
+#define MESHXT_FRAG_MAX_TEXT 1024
+
+static char fragText[MESHXT_FRAG_MAX_TEXT];
+
+// Message log segments (see MeshXTLog.h), indexed by MESHXT_LOG_OLDER / MESHXT_LOG_NEWER
+static const char *const logPaths[2] = {"/meshxt/log0.bin", "/meshxt/log1.bin"};
+
+// Adafruit's LittleFS (nRF52) opens FILE_O_WRITE at the end of the file;
+// the other file systems need "a" to append
+#if defined(ARDUINO_ARCH_NRF52)
+#define MESHXT_FILE_APPEND FILE_O_WRITE
+#else
+#define MESHXT_FILE_APPEND "a"
+#endif
+
+#ifdef MESHXT_BENCH
+#include "MeshXTBench.h"
+
+static void benchLog(const char *line, void *)
+{
+    LOG_INFO("MeshXT bench: %s", line);
+}
+
+/** Time the core on this CPU at boot (build with -DMESHXT_BENCH and firmware/bench/). */
+static void runBenchmark()
+{
+    static MeshXTBenchResult results[MESHXT_BENCH_MAX_RESULTS];
+    size_t n = meshxt_bench_run(MESHXT_BENCH_CORPUS, MESHXT_BENCH_CORPUS_SIZE, 5, results);
+    meshxt_bench_print(results, n, benchLog, NULL);
+}
+#endif
+
+/**
+ * Modem parameters of the configured LoRa preset, mirroring
+ * RadioInterface::applyModemConfig(). Falls back to LongFast.
+ */
+static void loraParamsFromConfig(MeshXTLoRaParams *radio)
+{
+    const meshtastic_Config_LoRaConfig &lora = config.lora;
+    radio->preambleLen = MESHXT_LORA_PREAMBLE;
+    radio->sf = 11;
+    radio->bwHz = 250000;
+    radio->cr = 5;
+
+    if (!lora.use_preset) {
+        if (lora.spread_factor < 7 || lora.spread_factor > 12 || lora.coding_rate < 5 || lora.coding_rate > 8 ||
+            lora.bandwidth == 0)
+            return;
+        radio->sf = lora.spread_factor;
+        radio->cr = lora.coding_rate;
+        radio->bwHz = lora.bandwidth == 31 ? 31250 : (lora.bandwidth == 62 ? 62500 : lora.bandwidth * 1000);
+        return;
+    }
+
+    switch (lora.modem_preset) {
+    case meshtastic_Config_LoRaConfig_ModemPreset_SHORT_TURBO:
+        radio->sf = 7;
+        radio->bwHz = 500000;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_SHORT_FAST:
+        radio->sf = 7;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_SHORT_SLOW:
+        radio->sf = 8;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_MEDIUM_FAST:
+        radio->sf = 9;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_MEDIUM_SLOW:
+        radio->sf = 10;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_LONG_MODERATE:
+        radio->sf = 11;
+        radio->bwHz = 125000;
+        radio->cr = 8;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_LONG_SLOW:
+        radio->sf = 12;
+        radio->bwHz = 125000;
+        radio->cr = 8;
+        break;
+    case meshtastic_Config_LoRaConfig_ModemPreset_VERY_LONG_SLOW:
+        radio->sf = 12;
+        radio->bwHz = 62500;
+        radio->cr = 8;
+        break;
+    default: // LONG_FAST
+        break;
+    }
+}
+
 MeshXTModule::MeshXTModule()
-    : MeshModule("MeshXT", MESHXT_PORTNUM, MeshModule::SECURITY_PKI)
+    : MeshModule("MeshXT", MESHXT_PORTNUM, MeshModule::SECURITY_PKI), concurrency::OSThread("MeshXT")
 {
     // Default settings
-    compType = MESHXT_COMP_SMAZ;
+    compType = MESHXT_COMP_ENTROPY; // costliest encode, fewest bytes on air
     fecLevel = MESHXT_FEC_LOW_CODE;
     enabled = true;
+    useTemplates = true;
+    adaptiveFec = true;
+    parityRatio = true; // scale parity to the payload: short messages get 4-8 bytes, not 16
+    relayOnly = config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER; // nobody to show text to
+    relayCheckParity = true;
+    useHistory = true;
+    fragRepairPct = 50; // one repair fragment per two data fragments
+    fragMsgId = (uint8_t)random(256);
+    txCoalesceMs = 0; // e.g. 300: texts with want_ack are still sent at once
+    asyncCodec = false;
+    lazyDecode = false; // worth it on headless nodes that are rarely connected to
+    logMessages = false; // one small flash write per message received
+    logReplay = 10;      // with logMessages: replayed to each client that connects
+
+    // Per-neighbour FEC selection; fecLevel is used until a link is heard
+    MeshXTLoRaParams radio;
+    loraParamsFromConfig(&radio);
+    meshxt_adaptive_init(&adaptive, &radio, fecLevel);
+    adaptive.parityRatio = parityRatio;
+
+    meshxt_reassembler_init(&reassembler);
+    memset(peers, 0, sizeof(peers));
+    meshxt_stats_reset(&stats);
+    statsSinceMs = millis();
+    meshxt_batch_init(&batch);
+    batchTextLen = 0;
+    batchDueMs = 0;
+    memset(jobs, 0, sizeof(jobs));
+    meshxt_queue_init(&toWorker);
+    meshxt_queue_init(&fromWorker);
+    worker = NULL;
+    jobsOut = 0;
+    passthrough = false;
+    pendingBytes = 0;
+    pendingCount = 0;
+    clientConnected = false;
+    loadDictionaries();
+    loadLog();
+
+#ifdef MESHXT_BENCH
+    runBenchmark();
+#endif
+}
+
+void MeshXTModule::loadDictionaries()
+{
+    memset(channelDict, MESHXT_DICT_BUILTIN, sizeof(channelDict));
+    numDicts = 0;
+
+#ifdef FSCom
+    // /meshxt/dict<channel>.bin, as written by `meshxt train`. Channels may
+    // share a dictionary; each distinct one is stored once. A different
+    // dictionary under an ID already loaded is refused, since packets could
+    // not tell the two apart.
+    for (uint8_t ch = 0; ch < MESHXT_DICT_CHANNELS; ch++) {
+        char path[24];
+        snprintf(path, sizeof(path), "/meshxt/dict%u.bin", ch);
+        if (!FSCom.exists(path))
+            continue;
+
+        if (numDicts == MESHXT_MODULE_DICTS) {
+            LOG_WARN("MeshXT: No room for dictionary %s", path);
+            continue;
+        }
+        File f = FSCom.open(path, FILE_O_READ);
+        if (!f)
+            continue;
+        size_t len = f.read(dictBlob[numDicts], sizeof(dictBlob[numDicts]));
+        bool whole = f.available() == 0;
+        f.close();
+
+        MeshXTDictionary *dict = &dicts[numDicts];
+        if (!whole || meshxt_dict_load(dict, dictBlob[numDicts], len) != 0) {
+            LOG_WARN("MeshXT: Ignoring bad dictionary %s", path);
+            continue;
+        }
+        int result = meshxt_dict_register(dict);
+        if (result == MESHXT_DICT_ID_CLASH) {
+            LOG_WARN("MeshXT: Ignoring %s: dictionary ID %u is already used by a different dictionary", path,
+                     dict->id);
+            continue;
+        }
+        if (result != 0) {
+            LOG_WARN("MeshXT: No room for dictionary %s", path);
+            continue;
+        }
+        channelDict[ch] = dict->id;
+        if (meshxt_dict_find(dict->id) != dict)
+            continue; // same dictionary as an earlier channel
+
+        numDicts++;
+        LOG_INFO("MeshXT: Channel %u uses dictionary %u (%u entries)", ch, dict->id, dict->count);
+    }
+#endif
+}
+
+uint8_t MeshXTModule::fecArg(uint8_t fec) const
+{
+    return (parityRatio && fec != MESHXT_FEC_NONE_CODE) ? (uint8_t)(fec | MESHXT_FEC_RATIO) : fec;
+}
+
+int MeshXTModule::compressText(const char *text, uint8_t channel, PeerHistory *peer, uint8_t *output)
+{
+    int packetLen = -1;
+
+    // Exact template matches ("Copy", "ETA 15 minutes", ...) are 1-3 bytes
+    if (useTemplates)
+        packetLen = meshxt_create_packet(text, output, MESHXT_COMP_CODEBOOK, MESHXT_FEC_NONE_CODE);
+    if (packetLen < 0)
+        packetLen = meshxt_create_packet(text, output, compType, MESHXT_FEC_NONE_CODE);
+
+    // The channel's trained dictionary, when it beats the built-in codebook
+    const MeshXTDictionary *dict = channel < MESHXT_DICT_CHANNELS ? meshxt_dict_find(channelDict[channel]) : NULL;
+    if (dict) {
+        uint8_t trial[MESHXT_MAX_PACKET_SIZE];
+        int trialLen = meshxt_create_dict_packet(text, trial, dict, MESHXT_FEC_NONE_CODE);
+        if (trialLen >= 0 && (packetLen < 0 || trialLen < packetLen)) {
+            memcpy(output, trial, trialLen);
+            packetLen = trialLen;
+        }
+    }
+
+    // Back-references into what was already sent to this node
+    if (peer && peer->tx.len > 0) {
+        uint8_t trial[MESHXT_MAX_PACKET_SIZE];
+        int trialLen = meshxt_create_history_packet(text, trial, &peer->tx, MESHXT_FEC_NONE_CODE);
+        if (trialLen >= 0 && (packetLen < 0 || trialLen < packetLen)) {
+            memcpy(output, trial, trialLen);
+            packetLen = trialLen;
+        }
+    }
+    return packetLen;
+}
+
+int MeshXTModule::encodeText(const char *text, uint32_t dest, uint8_t channel, uint8_t *output, uint8_t *fecUsed)
+{
+    // Compress without FEC first: the level depends on the compressed size
+    uint32_t start = meshxt_cycles();
+    int packetLen = compressText(text, channel, peerHistory(dest, false), output);
+    meshxt_stats_stage(&stats, MESHXT_STAGE_COMPRESS, meshxt_cycles() - start);
+    if (packetLen < 0)
+        return -1;
+    return addFec(output, packetLen, dest, fecUsed);
+}
+
+int MeshXTModule::addFec(uint8_t *packet, int packetLen, uint32_t dest, uint8_t *fecUsed)
+{
+    uint8_t fec = fecLevel;
+    if (adaptiveFec)
+        fec = meshxt_adaptive_select_fec(&adaptive, dest, packetLen - MESHXT_HEADER_SIZE, millis());
+    if (fecUsed)
+        *fecUsed = fec;
 
-    // Initialise FEC tables
-    meshxt_fec_init();
+    uint32_t start = meshxt_cycles();
+    packetLen = meshxt_packet_add_fec(packet, packetLen, fecArg(fec));
+    meshxt_stats_stage(&stats, MESHXT_STAGE_FEC_ENCODE, meshxt_cycles() - start);
+    return packetLen;
+}
+
+void MeshXTModule::countSent(size_t textLen, size_t frameBytes, uint32_t frames)
+{
+    if (frames == 0)
+        return;
+    stats.packetsEncoded += frames;
+    stats.textBytesSent += textLen;
+    stats.frameBytesSent += frameBytes;
+
+    // Plain text goes out in TEXT_MESSAGE_APP packets of up to a payload each
+    const size_t textPayload = sizeof(devicestate.rx_text_message.decoded.payload.bytes);
+    int64_t plainUs = 0;
+    for (size_t left = textLen; left > 0;) {
+        size_t chunk = left < textPayload ? left : textPayload;
+        plainUs += meshxt_lora_airtime_us(&adaptive.radio, chunk + MESHXT_LORA_OVERHEAD);
+        left -= chunk;
+    }
+    int64_t sentUs = (int64_t)frames * meshxt_lora_airtime_us(&adaptive.radio, frameBytes / frames + MESHXT_LORA_OVERHEAD);
+    stats.airtimeSavedUs += plainUs - sentUs;
 }
 
 bool MeshXTModule::sendCompressed(const char *text, uint32_t dest, uint8_t channel)
 {
-    uint8_t packetBuf[MESHXT_MAX_PACKET_SIZE];
+    // Allocate a MeshPacket and build the MeshXT frame directly in its payload
+    meshtastic_MeshPacket *mp = router->allocForSending();
+    if (!mp) {
+        LOG_ERROR("MeshXT: Failed to allocate packet");
+        return false;
+    }
 
-    int packetLen = meshxt_create_packet(text, packetBuf, compType, fecLevel);
+    uint8_t fec;
+    int packetLen = encodeText(text, dest, channel, mp->decoded.payload.bytes, &fec);
     if (packetLen < 0) {
-        LOG_ERROR("MeshXT: Failed to create packet for message");
-        return false;
+        packetPool.release(mp);
+
+        // Too long for one frame: send as data + repair fragments
+        int fragments = sendFragments(text, dest, channel, nullptr);
+        if (fragments < 0) {
+            LOG_ERROR("MeshXT: Failed to create packet for message");
+            return false;
+        }
+        LOG_DEBUG("MeshXT: TX %d bytes as %d fragments", strlen(text), fragments);
+        rememberSent(dest, text, MESHXT_COMP_FRAGMENT);
+        return true;
     }
+    rememberSent(dest, text, mp->decoded.payload.bytes[0] & 0x0F);
 
-    // Allocate a MeshPacket
+    mp->to = dest;
+    mp->channel = channel;
+    mp->decoded.portnum = MESHXT_PORTNUM;
+    mp->decoded.payload.size = packetLen;
+
+    // Totals go to the stats; the log line stays cheap (no float formatting)
+    size_t originalLen = strlen(text);
+    countSent(originalLen, packetLen, 1);
+    LOG_DEBUG("MeshXT: TX %d bytes → %d bytes (FEC level %d)", originalLen, packetLen, fec);
+
+    service->sendToMesh(mp);
+    return true;
+}
+
+/**
+ * Fragment sink: the first fragment may go into a caller-owned packet,
+ * the rest are sent as packets of their own.
+ */
+struct FragmentSend {
+    uint32_t dest;
+    uint8_t channel;
+    meshtastic_MeshPacket *first;
+    uint32_t frames;  // Fragments handed over so far
+    size_t bytes;
+};
+
+static int sendFragment(const uint8_t *frame, size_t len, void *ctx)
+{
+    FragmentSend *send = (FragmentSend *)ctx;
+    meshtastic_MeshPacket *mp = send->first;
+    send->first = nullptr;
+    if (!mp) {
+        mp = router->allocForSending();
+        if (!mp)
+            return -1;
+        send->frames++;
+        send->bytes += len;
+        mp->to = send->dest;
+        mp->channel = send->channel;
+        mp->decoded.portnum = MESHXT_PORTNUM;
+        memcpy(mp->decoded.payload.bytes, frame, len);
+        mp->decoded.payload.size = len;
+        service->sendToMesh(mp);
+        return 0;
+    }
+
+    send->frames++;
+    send->bytes += len;
+    mp->decoded.portnum = MESHXT_PORTNUM;
+    memcpy(mp->decoded.payload.bytes, frame, len);
+    mp->decoded.payload.size = len;
+    return 0;
+}
+
+int MeshXTModule::sendFragments(const char *text, uint32_t dest, uint8_t channel, meshtastic_MeshPacket *first)
+{
+    // Fragments are close to full frames; size the FEC for a frame's worth
+    // of payload that every level can carry
+    uint8_t fec = fecLevel;
+    if (adaptiveFec)
+        fec = meshxt_adaptive_select_fec(&adaptive, dest, MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - MESHXT_FEC_HIGH,
+                                         millis());
+
+    FragmentSend send = {dest, channel, first, 0, 0};
+    int fragments =
+        meshxt_fragment_message(text, compType, fecArg(fec), fragMsgId++, fragRepairPct, sendFragment, &send);
+    countSent(strlen(text), send.bytes, send.frames);
+    return fragments;
+}
+
+bool MeshXTModule::sendTemplate(const char *name, const MeshXTTemplateParams *params, uint32_t dest,
+                                uint8_t channel)
+{
     meshtastic_MeshPacket *mp = router->allocForSending();
     if (!mp) {
         LOG_ERROR("MeshXT: Failed to allocate packet");
         return false;
     }
 
+    int packetLen = meshxt_create_template_packet(name, params, mp->decoded.payload.bytes, MESHXT_FEC_NONE_CODE);
+    int textLen = 0;
+    if (packetLen >= 0) {
+        // Length of the text the template stands for, for the airtime saved
+        char expanded[MESHXT_TEMPLATE_MAX_TEXT];
+        textLen = meshxt_codebook_decode(mp->decoded.payload.bytes + MESHXT_HEADER_SIZE, packetLen - MESHXT_HEADER_SIZE,
+                                         expanded, sizeof(expanded));
+
+        uint8_t fec = fecLevel;
+        if (adaptiveFec)
+            fec = meshxt_adaptive_select_fec(&adaptive, dest, packetLen - MESHXT_HEADER_SIZE, millis());
+        packetLen = meshxt_packet_add_fec(mp->decoded.payload.bytes, packetLen, fecArg(fec));
+    }
+    if (packetLen < 0) {
+        LOG_ERROR("MeshXT: Failed to encode template '%s'", name);
+        packetPool.release(mp);
+        return false;
+    }
+
     mp->to = dest;
     mp->channel = channel;
     mp->decoded.portnum = MESHXT_PORTNUM;
     mp->decoded.payload.size = packetLen;
-    memcpy(mp->decoded.payload.bytes, packetBuf, packetLen);
 
-    // Log compression stats
-    size_t originalLen = strlen(text);
-    LOG_INFO("MeshXT: TX %d bytes → %d bytes (%.0f%% saved)",
-             originalLen, packetLen,
-             100.0 * (1.0 - (double)packetLen / originalLen));
+    countSent(textLen > 0 ? textLen : 0, packetLen, 1);
+    LOG_DEBUG("MeshXT: TX template '%s' → %d bytes", name, packetLen);
 
     service->sendToMesh(mp);
     return true;
 }
 
+/**
+ * Text of a locally originated TEXT_MESSAGE_APP packet (from phone/CLI,
+ * not relayed), null-terminated. Returns its length, or 0 if there is none.
+ */
+static size_t outgoingText(const meshtastic_MeshPacket *mp, char *text, size_t textSize)
+{
+    if (!mp || mp->decoded.portnum != meshtastic_PortNum_TEXT_MESSAGE_APP) return 0;
+    if (mp->from != 0 && mp->from != nodeDB->getNodeNum()) return 0;
+
+    // The payload is not null-terminated
+    size_t textLen = mp->decoded.payload.size;
+    if (textLen == 0 || textLen >= textSize) return 0; // Too short or malformed
+    memcpy(text, mp->decoded.payload.bytes, textLen);
+    text[textLen] = '\0';
+    return textLen;
+}
+
 bool MeshXTModule::interceptTextMessage(meshtastic_MeshPacket *mp)
 {
     // Called from Router before sending — intercepts outgoing TEXT_MESSAGE_APP
@@ -71,91 +462,991 @@ bool MeshXTModule::interceptTextMessage(meshtastic_MeshPacket *mp)
     // Returns true if the packet was intercepted (caller should NOT send original).
     // Returns false if MeshXT is disabled or compression failed (send as normal).
 
-    if (!enabled) return false;
-    if (!mp) return false;
-    if (mp->decoded.portnum != meshtastic_PortNum_TEXT_MESSAGE_APP) return false;
+    if (!enabled || passthrough) return false;
 
-    // Only intercept locally-originated packets (from phone/CLI, not relayed)
-    if (mp->from != 0 && mp->from != nodeDB->getNodeNum()) return false;
+    // Held messages go out first, so the peer sees them in order
+    flushBatch();
 
-    // Extract the text
-    const char *text = (const char *)mp->decoded.payload.bytes;
-    size_t textLen = mp->decoded.payload.size;
-
-    if (textLen == 0 || textLen > 237) return false; // Too short or too long
+    char text[sizeof(mp->decoded.payload.bytes) + 1];
+    size_t textLen = outgoingText(mp, text, sizeof(text));
+    if (textLen == 0) return false;
 
     // Compress and FEC-encode
     uint8_t packetBuf[MESHXT_MAX_PACKET_SIZE];
-    int packetLen = meshxt_create_packet(text, packetBuf, compType, fecLevel);
+    uint8_t fec;
+    int packetLen = encodeText(text, mp->to, mp->channel, packetBuf, &fec);
 
     if (packetLen < 0) {
+        // Does not fit one frame with FEC: the first fragment replaces the
+        // original, the others are queued behind it
+        int fragments = sendFragments(text, mp->to, mp->channel, mp);
+        if (fragments > 0) {
+            LOG_DEBUG("MeshXT: TX intercepted %d bytes as %d fragments", textLen, fragments);
+            rememberSent(mp->to, text, MESHXT_COMP_FRAGMENT);
+            return true;
+        }
+        if (mp->decoded.portnum == MESHXT_PORTNUM) {
+            // The first fragment is already in mp; the repair fragments may cover the rest
+            LOG_WARN("MeshXT: Only part of the fragments could be queued");
+            rememberSent(mp->to, text, MESHXT_COMP_FRAGMENT);
+            return true;
+        }
         LOG_WARN("MeshXT: Compression failed, sending as plain text");
         return false; // Fall back to normal send
     }
 
     // Only use MeshXT if we actually saved space (or if FEC is worth the overhead)
-    if (packetLen >= (int)textLen && fecLevel == MESHXT_FEC_NONE_CODE) {
-        LOG_INFO("MeshXT: No size benefit, sending as plain text");
+    if (packetLen >= (int)textLen && fec == MESHXT_FEC_NONE_CODE) {
+        LOG_DEBUG("MeshXT: No size benefit, sending as plain text");
         return false;
     }
 
-    LOG_INFO("MeshXT: TX intercepted %d bytes → %d bytes (%.0f%% saved)",
-             textLen, packetLen,
-             100.0 * (1.0 - (double)packetLen / textLen));
+    countSent(textLen, packetLen, 1);
+    LOG_DEBUG("MeshXT: TX intercepted %d bytes → %d bytes", textLen, packetLen);
 
     // Rewrite the packet in-place: change portnum and payload
     mp->decoded.portnum = MESHXT_PORTNUM;
     mp->decoded.payload.size = packetLen;
     memcpy(mp->decoded.payload.bytes, packetBuf, packetLen);
+    rememberSent(mp->to, text, packetBuf[0] & 0x0F);
 
     return true; // Packet modified — send the MeshXT version
 }
 
+bool MeshXTModule::deferTextMessage(meshtastic_MeshPacket *mp)
+{
+    if (!enabled || passthrough || (txCoalesceMs == 0 && !asyncCodec))
+        return false;
+
+    char text[sizeof(mp->decoded.payload.bytes) + 1];
+    size_t textLen = outgoingText(mp, text, sizeof(text));
+    if (textLen == 0)
+        return false;
+
+    // Compressed on the worker and sent from collectJobs()
+    if (txCoalesceMs == 0) {
+        AsyncJob *job = takeJob();
+        if (!job)
+            return false;
+        job->rx = false;
+        job->mp = mp;
+        submitJob(job);
+        return true;
+    }
+
+    // A merged packet's ID never goes on air, so nothing would ACK it and
+    // the router would retransmit it on its own: send those at once
+    if (mp->want_ack)
+        return false;
+
+    // Batched messages must decode on their own: no history. Ones that
+    // would not fit an empty batch are left to interceptTextMessage.
+    uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+    uint32_t start = meshxt_cycles();
+    int packetLen = compressText(text, mp->channel, NULL, packet);
+    meshxt_stats_stage(&stats, MESHXT_STAGE_COMPRESS, meshxt_cycles() - start);
+    if (packetLen < 0 || packetLen - MESHXT_HEADER_SIZE + 2 > MESHXT_BATCH_MAX_PAYLOAD)
+        return false;
+
+    bool sameLink = batch.count > 0 && mp->to == batchDest && mp->channel == batchChannel;
+    if (!sameLink || meshxt_batch_add(&batch, packet, packetLen) != 0) {
+        flushBatch();
+        batchDest = mp->to;
+        batchChannel = mp->channel;
+        meshxt_batch_add(&batch, packet, packetLen);
+
+        // The window opens with the first message held
+        batchDueMs = millis() + txCoalesceMs;
+        OSThread::enabled = true;
+        setIntervalFromNow(jobsOut > 0 ? MESHXT_ASYNC_POLL_MS : txCoalesceMs);
+    }
+    batchPackets[batch.count - 1] = mp;
+    batchTextLen += textLen;
+    rememberSent(mp->to, text, packet[0] & 0x0F);
+
+    if (batch.count == MESHXT_BATCH_MAX_MESSAGES)
+        flushBatch();
+    return true;
+}
+
+void MeshXTModule::flushBatch()
+{
+    if (batch.count == 0)
+        return;
+
+    // The first packet carries the frame, so only its ID goes on air
+    // (and is ACKed); the others are freed
+    meshtastic_MeshPacket *mp = batchPackets[0];
+    for (uint8_t i = 1; i < batch.count; i++)
+        packetPool.release(batchPackets[i]);
+
+    // A lone message goes out as an ordinary frame, without the entry header
+    bool single = batch.count == 1;
+    size_t payloadLen = single ? batch.len - 2 : batch.len;
+    uint8_t fec = fecLevel;
+    if (adaptiveFec)
+        fec = meshxt_adaptive_select_fec(&adaptive, batchDest, payloadLen, millis());
+
+    uint32_t start = meshxt_cycles();
+    int packetLen = single ? meshxt_create_raw_packet(batch.payload + 2, payloadLen, mp->decoded.payload.bytes,
+                                                      batch.payload[0], fecArg(fec))
+                           : meshxt_create_batch_packet(&batch, mp->decoded.payload.bytes, fecArg(fec));
+    meshxt_stats_stage(&stats, MESHXT_STAGE_FEC_ENCODE, meshxt_cycles() - start);
+
+    uint8_t count = batch.count;
+    size_t textLen = batchTextLen;
+    meshxt_batch_init(&batch);
+    batchTextLen = 0;
+
+    if (packetLen < 0) {
+        LOG_ERROR("MeshXT: Failed to frame %d held messages", count);
+        packetPool.release(mp);
+        return;
+    }
+
+    mp->decoded.portnum = MESHXT_PORTNUM;
+    mp->decoded.payload.size = packetLen;
+    countSent(textLen, packetLen, 1);
+    LOG_DEBUG("MeshXT: TX %d messages, %d bytes → %d bytes", count, textLen, packetLen);
+
+    service->sendToMesh(mp);
+}
+
+int32_t MeshXTModule::runOnce()
+{
+    collectJobs();
+    flushPending();
+
+    uint32_t now = millis();
+    if (batch.count > 0 && (int32_t)(now - batchDueMs) >= 0)
+        flushBatch();
+
+    if (jobsOut > 0)
+        return MESHXT_ASYNC_POLL_MS;
+    if (batch.count > 0)
+        return (int32_t)(batchDueMs - now);
+    if (pendingCount > 0 || watchingClient())
+        return MESHXT_RX_POLL_MS; // waiting for a client to connect
+    return disable(); // re-armed by the next message held or job submitted
+}
+
+// ---------------------------------------------------------------------------
+// Codec worker
+// ---------------------------------------------------------------------------
+
+void MeshXTModule::startWorker()
+{
+#ifdef MESHXT_HAS_WORKER
+    TaskHandle_t task = NULL;
+#if defined(ARDUINO_ARCH_ESP32) && !CONFIG_FREERTOS_UNICORE
+    // The core the main loop (and so the radio thread) does not run on
+    BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+    xTaskCreatePinnedToCore(workerTask, "MeshXT", MESHXT_ASYNC_STACK / sizeof(StackType_t), this,
+                            tskIDLE_PRIORITY + 1, &task, core);
+#else
+    xTaskCreate(workerTask, "MeshXT", MESHXT_ASYNC_STACK / sizeof(StackType_t), this, tskIDLE_PRIORITY + 1, &task);
+#endif
+    worker = task;
+    if (!worker)
+        LOG_WARN("MeshXT: Could not start the codec worker, encoding inline");
+#endif
+}
+
+MeshXTModule::AsyncJob *MeshXTModule::takeJob()
+{
+#ifdef MESHXT_HAS_WORKER
+    if (!worker)
+        startWorker();
+    if (!worker)
+        return NULL;
+    for (int i = 0; i < MESHXT_ASYNC_JOBS; i++)
+        if (!jobs[i].busy)
+            return &jobs[i];
+#endif
+    return NULL; // all out, or no worker: the packet takes the inline path
+}
+
+void MeshXTModule::submitJob(AsyncJob *job)
+{
+#ifdef MESHXT_HAS_WORKER
+    job->busy = true;
+    meshxt_queue_push(&toWorker, job); // never full: MESHXT_ASYNC_JOBS <= MESHXT_QUEUE_SIZE
+    jobsOut++;
+    xTaskNotifyGive((TaskHandle_t)worker);
+
+    OSThread::enabled = true;
+    setIntervalFromNow(MESHXT_ASYNC_POLL_MS);
+#else
+    (void)job;
+#endif
+}
+
+#ifdef MESHXT_HAS_WORKER
+void MeshXTModule::workerTask(void *arg)
+{
+    MeshXTModule *self = (MeshXTModule *)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        AsyncJob *job;
+        while ((job = (AsyncJob *)meshxt_queue_pop(&self->toWorker)) != NULL) {
+            self->runJob(job);
+            meshxt_queue_push(&self->fromWorker, job);
+        }
+    }
+}
+#endif
+
+void MeshXTModule::runJob(AsyncJob *job)
+{
+    // Touches only the job, the packet it owns and state that does not
+    // change after boot (settings, FEC tables, dictionaries)
+    uint32_t start = meshxt_cycles();
+    meshtastic_MeshPacket *mp = job->mp;
+    if (job->rx) {
+        job->result = meshxt_packet_decode_fec(job->frame, job->frameLen, &job->info);
+    } else {
+        // The history changes as messages are sent, so it is left out
+        char text[sizeof(mp->decoded.payload.bytes) + 1];
+        size_t len = mp->decoded.payload.size;
+        memcpy(text, mp->decoded.payload.bytes, len);
+        text[len] = '\0';
+        job->result = compressText(text, mp->channel, NULL, job->frame);
+    }
+    job->cycles = meshxt_cycles() - start;
+}
+
+void MeshXTModule::collectJobs()
+{
+    AsyncJob *job;
+    while ((job = (AsyncJob *)meshxt_queue_pop(&fromWorker)) != NULL) {
+        if (job->rx) {
+            meshxt_stats_stage(&stats, MESHXT_STAGE_FEC_DECODE, job->cycles);
+            finishDecode(job->meta, job->frame, job->result, job->info);
+        } else {
+            meshxt_stats_stage(&stats, MESHXT_STAGE_COMPRESS, job->cycles);
+            finishEncode(job);
+        }
+        job->busy = false;
+        jobsOut--;
+    }
+}
+
+void MeshXTModule::finishEncode(AsyncJob *job)
+{
+    meshtastic_MeshPacket *mp = job->mp;
+    char text[sizeof(mp->decoded.payload.bytes) + 1];
+    size_t textLen = outgoingText(mp, text, sizeof(text));
+
+    uint8_t fec = MESHXT_FEC_NONE_CODE;
+    int packetLen = job->result < 0 ? -1 : addFec(job->frame, job->result, mp->to, &fec);
+    if (packetLen < 0) {
+        // Too long for one frame: fragments, built inline
+        interceptTextMessage(mp);
+    } else if (packetLen >= (int)textLen && fec == MESHXT_FEC_NONE_CODE) {
+        LOG_DEBUG("MeshXT: No size benefit, sending as plain text");
+    } else {
+        countSent(textLen, packetLen, 1);
+        LOG_DEBUG("MeshXT: TX %d bytes → %d bytes (worker)", textLen, packetLen);
+        rememberSent(mp->to, text, job->frame[0] & 0x0F);
+        mp->decoded.portnum = MESHXT_PORTNUM;
+        mp->decoded.payload.size = packetLen;
+        memcpy(mp->decoded.payload.bytes, job->frame, packetLen);
+    }
+
+    // Back through the router, which must not hand it to us again
+    passthrough = true;
+    service->sendToMesh(mp);
+    passthrough = false;
+}
+
+MeshXTModule::PeerHistory *MeshXTModule::peerHistory(uint32_t node, bool create)
+{
+    if (!useHistory || node == 0 || node == NODENUM_BROADCAST)
+        return NULL;
+
+    uint32_t now = millis();
+    PeerHistory *victim = &peers[0];
+    for (int i = 0; i < MESHXT_HISTORY_PEERS; i++) {
+        PeerHistory &p = peers[i];
+        if (p.node == node) {
+            p.lastMs = now;
+            return &p;
+        }
+        if (victim->node != 0 && (p.node == 0 || (uint32_t)(now - p.lastMs) > (uint32_t)(now - victim->lastMs)))
+            victim = &p;
+    }
+    if (!create)
+        return NULL;
+
+    // The peer keeps its side of an evicted conversation; the next history
+    // packet from it will fail the checksum and resync both ends
+    victim->node = node;
+    victim->lastMs = now;
+    meshxt_history_init(&victim->tx);
+    meshxt_history_init(&victim->rx);
+    victim->lastTxLen = 0;
+    return victim;
+}
+
+void MeshXTModule::rememberSent(uint32_t dest, const char *text, uint8_t sentType)
+{
+    // Template texts are not decoded byte for byte; both ends leave them out
+    PeerHistory *peer = peerHistory(dest, true);
+    if (!peer || sentType == MESHXT_COMP_CODEBOOK)
+        return;
+
+    size_t len = strlen(text);
+    peer->lastTxLen = 0;
+    if (sentType == MESHXT_COMP_HISTORY) {
+        peer->lastTxChecksum = meshxt_history_checksum(&peer->tx);
+        peer->lastTxLen = (uint16_t)len;
+    }
+    meshxt_history_append(&peer->tx, text, len);
+}
+
+void MeshXTModule::rememberReceived(const RxMeta &mp, const char *text, int len, uint8_t sentType)
+{
+    if (mp.to != nodeDB->getNodeNum() || sentType == MESHXT_COMP_CODEBOOK)
+        return;
+    PeerHistory *peer = peerHistory(mp.from, true);
+    if (peer)
+        meshxt_history_append(&peer->rx, text, len);
+}
+
+void MeshXTModule::requestResync(const RxMeta &mp, PeerHistory *peer, uint16_t checksum)
+{
+    LOG_WARN("MeshXT: History with 0x%0x out of sync, requesting resend", mp.from);
+    meshxt_history_init(&peer->rx);
+
+    meshtastic_MeshPacket *req = router->allocForSending();
+    if (!req)
+        return;
+    int len = meshxt_create_history_resync(req->decoded.payload.bytes, checksum, fecArg(fecLevel));
+    if (len < 0) {
+        packetPool.release(req);
+        return;
+    }
+    req->to = mp.from;
+    req->channel = mp.channel;
+    req->decoded.portnum = MESHXT_PORTNUM;
+    req->decoded.payload.size = len;
+    service->sendToMesh(req);
+}
+
+void MeshXTModule::handleResync(const RxMeta &mp, PeerHistory *peer, uint16_t checksum)
+{
+    // Only the message coded against the rejected history can be resent;
+    // any sent after it, before the request arrived, are lost
+    char text[MESHXT_OPTIMAL_MAX_INPUT + 1];
+    size_t len = 0;
+    if (peer->lastTxLen > 0 && peer->lastTxChecksum == checksum && peer->lastTxLen <= peer->tx.len &&
+        peer->lastTxLen < sizeof(text)) {
+        len = peer->lastTxLen;
+        memcpy(text, peer->tx.data + peer->tx.len - len, len);
+    }
+    text[len] = '\0';
+
+    meshxt_history_init(&peer->tx);
+    peer->lastTxLen = 0;
+
+    if (len > 0) {
+        LOG_INFO("MeshXT: 0x%0x lost our history, resending %d bytes", mp.from, len);
+        sendCompressed(text, mp.from, mp.channel);
+    }
+}
+
+const MeshXTStats &MeshXTModule::getStats()
+{
+    stats.uptimeMs = millis() - statsSinceMs;
+    return stats;
+}
+
+void MeshXTModule::resetStats()
+{
+    meshxt_stats_reset(&stats);
+    statsSinceMs = millis();
+}
+
+bool MeshXTModule::requestStats(uint32_t dest, uint8_t channel)
+{
+    return sendStats(dest, channel, false);
+}
+
+bool MeshXTModule::sendStats(uint32_t dest, uint8_t channel, bool report)
+{
+    meshtastic_MeshPacket *mp = router->allocForSending();
+    if (!mp) {
+        LOG_ERROR("MeshXT: Failed to allocate packet");
+        return false;
+    }
+
+    // No FEC: clients on the phone API read the report right after the header
+    uint8_t *payload = mp->decoded.payload.bytes + MESHXT_HEADER_SIZE;
+    int payloadLen = 0;
+    if (report)
+        payloadLen = meshxt_stats_serialize(&getStats(), payload, sizeof(mp->decoded.payload.bytes) - MESHXT_HEADER_SIZE);
+    int packetLen = payloadLen < 0 ? -1
+                                   : meshxt_create_raw_packet(payload, payloadLen, mp->decoded.payload.bytes,
+                                                              MESHXT_COMP_STATS, MESHXT_FEC_NONE_CODE);
+    if (packetLen < 0) {
+        packetPool.release(mp);
+        return false;
+    }
+
+    mp->to = dest;
+    mp->channel = channel;
+    mp->decoded.portnum = MESHXT_PORTNUM;
+    mp->decoded.payload.size = packetLen;
+    service->sendToMesh(mp);
+    return true;
+}
+
+ProcessMessage MeshXTModule::handleStats(const RxMeta &mp, const uint8_t *payload, int payloadLen)
+{
+    if (payloadLen == 0) {
+        // Only direct requests are answered, so a broadcast cannot make every node reply at once
+        if (mp.to == nodeDB->getNodeNum()) {
+            LOG_INFO("MeshXT: Sending stats to 0x%0x", mp.from);
+            sendStats(mp.from, mp.channel, true);
+        }
+        return ProcessMessage::STOP;
+    }
+
+    MeshXTStats report;
+    if (meshxt_stats_parse(payload, payloadLen, &report) != 0) {
+        LOG_WARN("MeshXT: Bad stats report from 0x%0x", mp.from);
+        return ProcessMessage::CONTINUE;
+    }
+    LOG_INFO("MeshXT: Stats from 0x%0x: TX %u frames %u → %u bytes, RX %u decoded, %u corrected, %u dropped, "
+             "%d ms airtime saved",
+             mp.from, report.packetsEncoded, report.textBytesSent, report.frameBytesSent, report.packetsDecoded,
+             report.fecPacketsCorrected, report.uncorrectable + report.decodeFailures,
+             (int)(report.airtimeSavedUs / 1000));
+    return ProcessMessage::CONTINUE; // the raw report also goes to the phone
+}
+
+void MeshXTModule::observeLink(const meshtastic_MeshPacket &mp)
+{
+    // Only zero-hop packets carry the sender's own SNR/RSSI as seen by us
+    if (mp.via_mqtt || mp.from == 0 || mp.from == nodeDB->getNodeNum())
+        return;
+    if (mp.hop_start == 0 || mp.hop_start != mp.hop_limit)
+        return;
+    meshxt_adaptive_observe(&adaptive, mp.from, (int16_t)(mp.rx_snr * 4), (int16_t)mp.rx_rssi, millis());
+}
+
 ProcessMessage MeshXTModule::handleReceived(const meshtastic_MeshPacket &mp)
 {
-    auto &p = mp.decoded;
+    // Every packet feeds the link table; only MeshXT frames are decoded
+    observeLink(mp);
+    if (mp.decoded.portnum != MESHXT_PORTNUM)
+        return ProcessMessage::CONTINUE;
+
+    // Relay-only nodes never decode: the router forwards the frame as
+    // received. One that is provably broken is pulled from the TX queue
+    // (if its rebroadcast is already there) so it costs no more airtime.
+    if (relayOnly) {
+        if (meshxt_packet_check(mp.decoded.payload.bytes, mp.decoded.payload.size, relayCheckParity) ==
+            MESHXT_CHECK_INVALID) {
+            LOG_WARN("MeshXT: Dropping corrupt frame 0x%0x from 0x%0x", mp.id, mp.from);
+            router->cancelSending(mp.from, mp.id);
+        }
+        return ProcessMessage::CONTINUE;
+    }
+
+    if (mp.decoded.payload.size > 0 && (mp.decoded.payload.bytes[0] & 0x0F) == MESHXT_COMP_FRAGMENT)
+        return handleFragment(mp);
 
-    MeshXTParseResult result;
-    int rc = meshxt_parse_packet(p.payload.bytes, p.payload.size, &result);
+    // The frame is FEC-corrected in place in a buffer of the module's
+    // own, with the few header fields needed to deliver its text, so no
+    // packet is taken from the router's pool to decode
+    stats.frameBytesReceived += mp.decoded.payload.size;
+    size_t frameLen = mp.decoded.payload.size < sizeof(rxFrame) ? mp.decoded.payload.size : sizeof(rxFrame);
+    RxMeta meta = rxMeta(mp);
 
-    if (rc < 0 || !result.valid) {
-        LOG_WARN("MeshXT: Failed to decode packet from 0x%0x", mp.from);
+    // The worker does the FEC and the rest happens in collectJobs()
+    AsyncJob *job = asyncCodec ? takeJob() : NULL;
+    if (job) {
+        job->rx = true;
+        job->meta = meta;
+        memcpy(job->frame, mp.decoded.payload.bytes, frameLen);
+        job->frameLen = frameLen;
+        submitJob(job);
+        return ProcessMessage::STOP;
+    }
+
+    // FEC and decompression run as separate steps so each can be timed
+    memcpy(rxFrame, mp.decoded.payload.bytes, frameLen);
+    MeshXTPacketInfo info;
+    uint32_t start = meshxt_cycles();
+    int payloadLen = meshxt_packet_decode_fec(rxFrame, frameLen, &info);
+    meshxt_stats_stage(&stats, MESHXT_STAGE_FEC_DECODE, meshxt_cycles() - start);
+    return finishDecode(meta, rxFrame, payloadLen, info);
+}
+
+ProcessMessage MeshXTModule::finishDecode(const RxMeta &mp, uint8_t *frame, int payloadLen, MeshXTPacketInfo &info)
+{
+    if (payloadLen < 0) {
+        if (info.header.version == MESHXT_PACKET_VERSION)
+            stats.uncorrectable++;
+        else
+            stats.decodeFailures++;
+        LOG_WARN("MeshXT: Uncorrectable packet from 0x%0x", mp.from);
         return ProcessMessage::CONTINUE;
     }
+    if (info.fecCorrected > 0) {
+        stats.fecSymbolsCorrected += info.fecCorrected;
+        stats.fecPacketsCorrected++;
+    }
+
+    const uint8_t *payload = frame + MESHXT_HEADER_SIZE;
+    if (info.header.compType == MESHXT_COMP_STATS) {
+        return handleStats(mp, payload, payloadLen);
+    }
+
+    if (info.header.compType == MESHXT_COMP_BATCH) {
+        return handleBatch(mp, payload, payloadLen, info.packetSize);
+    }
 
-    LOG_INFO("MeshXT: RX from=0x%0x, %d bytes → \"%s\" (%d chars)",
-             mp.from, p.payload.size, result.message, result.messageLen);
+    // Nobody needs the text yet: the FEC check above is all the validation
+    // done now, and the payload is stored as received, about 40% the size
+    // of its text. History-coded payloads depend on what came before them
+    // and are always decoded in order.
+    if (info.header.compType != MESHXT_COMP_HISTORY && decodeLater(mp)) {
+        LOG_DEBUG("MeshXT: RX from=0x%0x, %d bytes held compressed", mp.from, info.packetSize);
+        holdForPhone(mp, info.header.compType, payload, payloadLen);
+        return ProcessMessage::STOP;
+    }
+
+    // Direct messages may refer back to the conversation so far
+    PeerHistory *peer = mp.to == nodeDB->getNodeNum() ? peerHistory(mp.from, true) : NULL;
 
-    // Re-inject as a standard TEXT_MESSAGE_APP packet so it:
-    // 1. Shows on the device screen
-    // 2. Gets sent to the Meshtastic app via BLE/serial
-    // 3. Appears in message history
-    meshtastic_MeshPacket *textMp = router->allocForSending();
-    if (textMp) {
-        *textMp = mp; // Copy original metadata (from, to, channel, hop count, etc.)
-        textMp->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-        textMp->decoded.payload.size = result.messageLen;
-        memcpy(textMp->decoded.payload.bytes, result.message, result.messageLen);
+    char text[sizeof(meshtastic_Data_payload_t::bytes) + 1];
+    uint32_t start = meshxt_cycles();
+    int textLen = meshxt_packet_decompress(frame, payloadLen, peer ? &peer->rx : NULL, text, sizeof(text), &info);
+    meshxt_stats_stage(&stats, MESHXT_STAGE_DECOMPRESS, meshxt_cycles() - start);
 
-        // Notify the phone/app via BLE/serial
-        service->handleFromRadio(textMp);
+    if (peer && (textLen == MESHXT_HISTORY_DESYNC || textLen == MESHXT_HISTORY_RESYNC)) {
+        uint16_t checksum = (uint16_t)(payload[0] << 8 | payload[1]);
+        if (textLen == MESHXT_HISTORY_DESYNC)
+            requestResync(mp, peer, checksum);
+        else
+            handleResync(mp, peer, checksum);
+        return ProcessMessage::STOP;
+    }
+
+    if (textLen < 0) {
+        stats.decodeFailures++;
+        if (info.header.compType == MESHXT_COMP_DICT && info.payloadSize > 0 && !meshxt_dict_find(payload[0]))
+            LOG_WARN("MeshXT: Packet from 0x%0x uses dictionary %u, which is not installed", mp.from, payload[0]);
+        else
+            LOG_WARN("MeshXT: Failed to decode packet from 0x%0x", mp.from);
+        return ProcessMessage::CONTINUE;
     }
 
-    // Also store for on-device screen display
-    devicestate.rx_text_message = mp;
-    devicestate.rx_text_message.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-    devicestate.rx_text_message.decoded.payload.size = result.messageLen;
-    memcpy(devicestate.rx_text_message.decoded.payload.bytes, result.message, result.messageLen);
+    stats.packetsDecoded++;
+    stats.textBytesReceived += textLen;
+    LOG_DEBUG("MeshXT: RX from=0x%0x, %d bytes → %d chars, %d FEC corrections", mp.from, info.packetSize, textLen,
+              info.fecCorrected);
+
+    rememberReceived(mp, text, textLen, info.header.compType);
+    deliverText(mp, text, textLen);
+    return ProcessMessage::STOP;
+}
+
+ProcessMessage MeshXTModule::handleBatch(const RxMeta &mp, const uint8_t *payload, int payloadLen, int frameLen)
+{
+    char text[sizeof(meshtastic_Data_payload_t::bytes) + 1];
+    bool later = decodeLater(mp);
+    int delivered = 0;
+    for (size_t offset = 0; offset < (size_t)payloadLen;) {
+        // Each message is its own packet to the phone; all but the first
+        // get a new ID so they are not taken for copies of each other
+        RxMeta meta = mp;
+        if (delivered > 0)
+            meta.id = generatePacketId();
+
+        if (later) {
+            // Split only: a batch entry is already in the stored form
+            size_t entryLen = offset + 2 <= (size_t)payloadLen ? 2u + payload[offset + 1] : 0;
+            if (entryLen == 0 || offset + entryLen > (size_t)payloadLen) {
+                stats.decodeFailures++;
+                LOG_WARN("MeshXT: Bad message %d in batch from 0x%0x", delivered + 1, mp.from);
+                break;
+            }
+            holdForPhone(meta, payload[offset], payload + offset + 2, entryLen - 2);
+            offset += entryLen;
+            delivered++;
+            continue;
+        }
+
+        uint8_t sentType;
+        uint32_t start = meshxt_cycles();
+        int textLen = meshxt_batch_next(payload, payloadLen, &offset, text, sizeof(text), &sentType);
+        meshxt_stats_stage(&stats, MESHXT_STAGE_DECOMPRESS, meshxt_cycles() - start);
+        if (textLen < 0) {
+            // The messages before the bad one have been delivered
+            stats.decodeFailures++;
+            LOG_WARN("MeshXT: Bad message %d in batch from 0x%0x", delivered + 1, mp.from);
+            break;
+        }
+        stats.packetsDecoded++;
+        stats.textBytesReceived += textLen;
+        rememberReceived(mp, text, textLen, sentType);
+        deliverText(meta, text, textLen);
+        delivered++;
+    }
+
+    LOG_DEBUG("MeshXT: RX from=0x%0x, %d-byte batch → %d messages", mp.from, frameLen, delivered);
+    return delivered > 0 ? ProcessMessage::STOP : ProcessMessage::CONTINUE;
+}
+
+ProcessMessage MeshXTModule::handleFragment(const meshtastic_MeshPacket &mp)
+{
+    uint8_t frame[MESHXT_MAX_PACKET_SIZE];
+    size_t frameLen = mp.decoded.payload.size < sizeof(frame) ? mp.decoded.payload.size : sizeof(frame);
+    memcpy(frame, mp.decoded.payload.bytes, frameLen);
+
+    uint8_t *packet;
+    stats.frameBytesReceived += frameLen;
+    int packetLen = meshxt_reassembler_add(&reassembler, mp.from, frame, frameLen, millis(), &packet);
+    if (packetLen < 0) {
+        stats.decodeFailures++;
+        LOG_WARN("MeshXT: Bad fragment from 0x%0x", mp.from);
+        return ProcessMessage::CONTINUE;
+    }
+    if (packetLen == 0)
+        return ProcessMessage::STOP; // Waiting for more fragments
+
+    int textLen = meshxt_parse_packet_inplace(packet, packetLen, fragText, sizeof(fragText), NULL);
+    if (textLen < 0) {
+        stats.decodeFailures++;
+        LOG_WARN("MeshXT: Failed to decode fragmented message from 0x%0x", mp.from);
+        return ProcessMessage::CONTINUE;
+    }
+
+    stats.packetsDecoded++;
+    stats.textBytesReceived += textLen;
+    LOG_DEBUG("MeshXT: RX from=0x%0x, %d-byte message from fragments → %d chars", mp.from, packetLen, textLen);
+    RxMeta meta = rxMeta(mp);
+    rememberReceived(meta, fragText, textLen, MESHXT_COMP_FRAGMENT);
+
+    // Deliver in TEXT_MESSAGE_APP-sized pieces, split on UTF-8 boundaries
+    for (int offset = 0; offset < textLen;) {
+        int len = textLen - offset;
+        if (len > (int)sizeof(meshtastic_Data_payload_t::bytes)) {
+            len = sizeof(meshtastic_Data_payload_t::bytes);
+            while (len > 1 && (fragText[offset + len] & 0xC0) == 0x80)
+                len--;
+        }
+        deliverText(meta, fragText + offset, len);
+        offset += len;
+    }
+
+    return ProcessMessage::STOP;
+}
+
+MeshXTModule::RxMeta MeshXTModule::rxMeta(const meshtastic_MeshPacket &mp)
+{
+    RxMeta m;
+    m.from = mp.from;
+    m.to = mp.to;
+    m.id = mp.id;
+    m.rxTime = mp.rx_time;
+    m.rxSnr = mp.rx_snr;
+    m.rxRssi = mp.rx_rssi;
+    m.channel = (uint8_t)mp.channel;
+    m.hopLimit = (uint8_t)mp.hop_limit;
+    m.hopStart = (uint8_t)mp.hop_start;
+    m.viaMqtt = mp.via_mqtt;
+    m.pkiEncrypted = mp.pki_encrypted;
+    return m;
+}
+
+void MeshXTModule::fillTextPacket(meshtastic_MeshPacket *p, const RxMeta &m, const char *text, size_t len)
+{
+    memset(p, 0, sizeof(*p));
+    p->which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p->from = m.from;
+    p->to = m.to;
+    p->id = m.id;
+    p->rx_time = m.rxTime;
+    p->rx_snr = m.rxSnr;
+    p->rx_rssi = m.rxRssi;
+    p->channel = m.channel;
+    p->hop_limit = m.hopLimit;
+    p->hop_start = m.hopStart;
+    p->via_mqtt = m.viaMqtt;
+    p->pki_encrypted = m.pkiEncrypted;
+    p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p->decoded.payload.size = len;
+    memcpy(p->decoded.payload.bytes, text, len);
+}
+
+void MeshXTModule::deliverText(const RxMeta &meta, const char *text, size_t len)
+{
+    // Shown on the device screen at once, from its static copy
+    fillTextPacket(&devicestate.rx_text_message, meta, text, len);
     devicestate.has_rx_text_message = true;
+    holdForPhone(meta, MESHXT_COMP_NONE, (const uint8_t *)text, len);
+}
+
+bool MeshXTModule::decodeLater(const RxMeta &mp) const
+{
+    if (!lazyDecode || service->api_state != MeshService::STATE_DISCONNECTED)
+        return false;
+#if HAS_SCREEN
+    if (screen)
+        return false;
+#endif
+    // Received direct messages extend the history in arrival order
+    return !(useHistory && mp.to == nodeDB->getNodeNum());
+}
 
+void MeshXTModule::holdForPhone(const RxMeta &meta, uint8_t compType, const uint8_t *data, size_t len)
+{
     powerFSM.trigger(EVENT_RECEIVED_MSG);
+    logMessage(meta, compType, data, len);
 
-    return ProcessMessage::STOP;
+    // Kept for the phone/app as [RxMeta][compType][len][bytes], packed
+    // oldest first; the oldest are dropped when the new entry does not fit
+    size_t size = sizeof(RxMeta) + 2 + len;
+    while (pendingCount > 0 && pendingBytes + size > sizeof(pending)) {
+        LOG_WARN("MeshXT: No client for %d messages, dropping the oldest", pendingCount);
+        size_t oldest = sizeof(RxMeta) + 2u + pending[sizeof(RxMeta) + 1];
+        memmove(pending, pending + oldest, pendingBytes - oldest);
+        pendingBytes = (uint16_t)(pendingBytes - oldest);
+        pendingCount--;
+    }
+
+    uint8_t *entry = pending + pendingBytes;
+    memcpy(entry, &meta, sizeof(RxMeta));
+    entry[sizeof(RxMeta)] = compType;
+    entry[sizeof(RxMeta) + 1] = (uint8_t)len;
+    memcpy(entry + sizeof(RxMeta) + 2, data, len);
+    pendingBytes = (uint16_t)(pendingBytes + size);
+    pendingCount++;
+    flushPending();
+}
+
+void MeshXTModule::flushPending()
+{
+    bool connected = service->api_state != MeshService::STATE_DISCONNECTED;
+    bool reconnected = connected && !clientConnected;
+    clientConnected = connected;
+
+    // Texts wait here while no client is connected, instead of as packets
+    // from the router's pool in the phone queue
+    if (!connected) {
+        if ((pendingCount > 0 || watchingClient()) && !OSThread::enabled) {
+            OSThread::enabled = true;
+            setIntervalFromNow(MESHXT_RX_POLL_MS);
+        }
+        return;
+    }
+
+    // A client that just connected gets the recent log first; the held
+    // texts below are skipped there, so none arrives twice
+    if (reconnected && watchingClient()) {
+        int replayed = replayLog(logReplay);
+        if (replayed > 0)
+            LOG_INFO("MeshXT: Replayed %d logged messages", replayed);
+    }
+
+    // Re-injected as standard TEXT_MESSAGE_APP packets, so they reach the
+    // app via BLE/serial and appear in its message history. The service
+    // copies the packet into the phone queue, so one scratch packet does.
+    //
+    // Past the RxMeta an entry has the layout of a batch message, so the
+    // batch walker decompresses the ones held compressed and copies the rest.
+    char text[sizeof(meshtastic_Data_payload_t::bytes) + 1];
+    for (size_t offset = 0; offset < pendingBytes;) {
+        RxMeta meta;
+        memcpy(&meta, pending + offset, sizeof(RxMeta));
+        const uint8_t *entry = pending + offset + sizeof(RxMeta);
+        size_t entryLen = 2u + entry[1];
+        offset += sizeof(RxMeta) + entryLen;
+
+        size_t pos = 0;
+        uint32_t start = meshxt_cycles();
+        int textLen = meshxt_batch_next(entry, entryLen, &pos, text, sizeof(text), NULL);
+        uint32_t cycles = meshxt_cycles() - start;
+        if (textLen < 0) {
+            stats.decodeFailures++;
+            LOG_WARN("MeshXT: Failed to decode held packet from 0x%0x", meta.from);
+            continue;
+        }
+        if (entry[0] != MESHXT_COMP_NONE) {
+            meshxt_stats_stage(&stats, MESHXT_STAGE_DECOMPRESS, cycles);
+            stats.packetsDecoded++;
+            stats.textBytesReceived += textLen;
+        }
+        fillTextPacket(&phoneMp, meta, text, textLen);
+        service->handleFromRadio(&phoneMp);
+    }
+    pendingBytes = 0;
+    pendingCount = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Message log
+// ---------------------------------------------------------------------------
+
+void MeshXTModule::loadLog()
+{
+    meshxt_log_index_init(&logIndex);
+    logBytes = 0;
+
+#ifdef FSCom
+    if (!logMessages)
+        return;
+    if (!FSCom.exists("/meshxt"))
+        FSCom.mkdir("/meshxt");
+
+    // Only the headers are read; each gives the size of its record
+    uint8_t header[MESHXT_LOG_HEADER_SIZE];
+    for (uint8_t seg = MESHXT_LOG_OLDER; seg <= MESHXT_LOG_NEWER; seg++) {
+        File f = FSCom.open(logPaths[seg], FILE_O_READ);
+        if (!f)
+            continue;
+        size_t fileSize = f.size();
+        size_t end = fileSize < MESHXT_LOG_SEGMENT_SIZE ? fileSize : MESHXT_LOG_SEGMENT_SIZE;
+        size_t offset = 0;
+        MeshXTLogRecord r;
+        int size;
+        while (offset + sizeof(header) <= end && f.seek(offset) && f.read(header, sizeof(header)) == sizeof(header) &&
+               (size = meshxt_log_parse(header, sizeof(header), &r)) > 0 && offset + size <= end) {
+            meshxt_log_index_add(&logIndex, r.from, r.rxTime, (uint16_t)offset, seg);
+            offset += size;
+        }
+        f.close();
+
+        // Appending after a torn or corrupt tail would hide the records
+        // behind it: the next message starts a new segment instead
+        if (seg == MESHXT_LOG_NEWER)
+            logBytes = offset == fileSize ? (uint16_t)offset : MESHXT_LOG_SEGMENT_SIZE;
+    }
+    LOG_INFO("MeshXT: %u messages in the log", logIndex.count);
+#endif
+}
+
+void MeshXTModule::logMessage(const RxMeta &meta, uint8_t compType, const uint8_t *data, size_t len)
+{
+    if (!logMessages)
+        return;
+
+    MeshXTLogRecord r;
+    r.from = meta.from;
+    r.to = meta.to;
+    r.id = meta.id;
+    r.rxTime = meta.rxTime;
+    r.channel = meta.channel;
+    r.compType = compType;
+    uint8_t record[MESHXT_LOG_MAX_RECORD];
+    int size = compType == MESHXT_COMP_NONE ? meshxt_log_record_text(record, sizeof(record), &r, (const char *)data, len)
+                                            : meshxt_log_record(record, sizeof(record), &r, data, len);
+    if (size < 0)
+        return;
+
+#ifdef FSCom
+    // A full segment replaces the older one; nothing else is rewritten
+    if (logBytes + size > MESHXT_LOG_SEGMENT_SIZE) {
+        FSCom.remove(logPaths[MESHXT_LOG_OLDER]);
+        FSCom.rename(logPaths[MESHXT_LOG_NEWER], logPaths[MESHXT_LOG_OLDER]);
+        meshxt_log_index_rotate(&logIndex);
+        logBytes = 0;
+    }
+
+    File f = FSCom.open(logPaths[MESHXT_LOG_NEWER], MESHXT_FILE_APPEND);
+    if (!f) {
+        LOG_WARN("MeshXT: Cannot open %s", logPaths[MESHXT_LOG_NEWER]);
+        return;
+    }
+    size_t written = f.write(record, size);
+    f.close();
+    if (written != (size_t)size) {
+        LOG_WARN("MeshXT: Log write failed");
+        logBytes = MESHXT_LOG_SEGMENT_SIZE;
+        return;
+    }
+    meshxt_log_index_add(&logIndex, r.from, r.rxTime, logBytes, MESHXT_LOG_NEWER);
+    logBytes = (uint16_t)(logBytes + size);
+#endif
+}
+
+bool MeshXTModule::watchingClient() const
+{
+    return logMessages && logReplay > 0;
+}
+
+bool MeshXTModule::isPending(uint32_t from, uint32_t id) const
+{
+    for (size_t offset = 0; offset < pendingBytes;) {
+        RxMeta meta;
+        memcpy(&meta, pending + offset, sizeof(RxMeta));
+        if (meta.from == from && meta.id == id)
+            return true;
+        offset += sizeof(RxMeta) + 2u + pending[offset + sizeof(RxMeta) + 1];
+    }
+    return false;
+}
+
+int MeshXTModule::replayLog(size_t count)
+{
+    if (service->api_state == MeshService::STATE_DISCONNECTED)
+        return -1;
+
+    int replayed = 0;
+#ifdef FSCom
+    if (count > logIndex.count)
+        count = logIndex.count;
+    size_t first = logIndex.count - count;
+
+    // References are in log order, so each segment is opened once
+    uint8_t record[MESHXT_LOG_MAX_RECORD];
+    char text[sizeof(meshtastic_Data_payload_t::bytes) + 1];
+    for (uint8_t seg = MESHXT_LOG_OLDER; seg <= MESHXT_LOG_NEWER; seg++) {
+        File f = FSCom.open(logPaths[seg], FILE_O_READ);
+        if (!f)
+            continue;
+        for (size_t i = first; i < logIndex.count; i++) {
+            const MeshXTLogRef *ref = meshxt_log_index_get(&logIndex, i);
+            if (ref->segment != seg || !f.seek(ref->offset))
+                continue;
+            size_t n = f.read(record, sizeof(record));
+
+            MeshXTLogRecord r;
+            int textLen = meshxt_log_text(record, n, text, sizeof(text));
+            if (textLen < 0 || meshxt_log_parse(record, n, &r) < 0) {
+                LOG_WARN("MeshXT: Bad log record at %s:%u", logPaths[seg], ref->offset);
+                continue;
+            }
+            // Still held for the phone: flushPending delivers it
+            if (isPending(r.from, r.id))
+                continue;
+            RxMeta meta = {};
+            meta.from = r.from;
+            meta.to = r.to;
+            meta.id = r.id;
+            meta.rxTime = r.rxTime;
+            meta.channel = r.channel;
+            fillTextPacket(&phoneMp, meta, text, textLen);
+            service->handleFromRadio(&phoneMp);
+            replayed++;
+        }
+        f.close();
+    }
+#else
+    (void)count;
+#endif
+    return replayed;
 }
 
 bool MeshXTModule::wantPacket(const meshtastic_MeshPacket *p)
 {
-    return p->decoded.portnum == MESHXT_PORTNUM;
+    // All packets are seen for link tracking; handleReceived() lets
+    // non-MeshXT ones continue to their own modules
+    return p->decoded.portnum == MESHXT_PORTNUM || adaptiveFec;
 }
 
 #endif // MESHTASTIC_FIRMWARE
@@ -1,10 +1,37 @@
 #pragma once
 
 #include "MeshXTPacket.h"
+#include "MeshXTAdaptive.h"
+#include "MeshXTFragment.h"
+#include "MeshXTStats.h"
+#include "MeshXTQueue.h"
+#include "MeshXTLog.h"
 
 #if defined(MESHTASTIC_FIRMWARE)
 #include "MeshModule.h"
 #include "Router.h"
+#include "concurrency/OSThread.h"
+
+// Trained dictionaries loaded from /meshxt/dict<channel>.bin
+#define MESHXT_DICT_CHANNELS      8
+#define MESHXT_MODULE_DICTS       2
+#define MESHXT_MODULE_DICT_BLOB   2048
+
+// Direct-message conversations with a shared history (see MeshXTHistory.h)
+#define MESHXT_HISTORY_PEERS 4
+
+// Codec worker task (asyncCodec), on FreeRTOS targets only
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_NRF52)
+#define MESHXT_HAS_WORKER 1
+#endif
+#define MESHXT_ASYNC_JOBS    4     // packets in the worker at once (<= MESHXT_QUEUE_SIZE)
+#define MESHXT_ASYNC_STACK   6144  // worker stack, bytes
+#define MESHXT_ASYNC_POLL_MS 2     // how often finished jobs are collected while any are out
+
+// Texts held for the phone/app while no client is connected, as
+// [RxMeta][compType][len][bytes] entries (compressed with lazyDecode)
+#define MESHXT_RX_STORE   2048
+#define MESHXT_RX_POLL_MS 1000     // how often a connection is checked while texts wait
 
 /**
  * MeshXTModule — Meshtastic firmware module for MeshXT compression + FEC
@@ -12,6 +39,30 @@
  * Hooks into the Meshtastic message pipeline:
  * - On send: compresses and FEC-encodes text messages
  * - On receive: FEC-decodes and decompresses incoming MeshXT packets
+ * - Tracks SNR/RSSI of directly heard neighbours and picks the FEC
+ *   level per destination (see MeshXTAdaptive.h)
+ * - Splits messages that do not fit one frame into data + repair
+ *   fragments and reassembles them (see MeshXTFragment.h)
+ * - In relay mode, leaves frames to the router untouched after a header
+ *   (and optional parity) check
+ * - Compresses with a channel's trained dictionary when one is installed
+ *   in LittleFS and it beats the built-in codebook
+ * - In direct messages, refers back to text already exchanged with the
+ *   peer, resynchronising when the two histories diverge
+ * - Counts bytes, corrections and drops and times each stage
+ *   (MeshXTStats.h); reports are sent to nodes that ask for them
+ * - Optionally holds outgoing texts for a short window and sends those
+ *   to the same destination as one batch frame, which the receiver
+ *   splits back into separate messages
+ * - Optionally runs compression and RS decoding on a worker task (the
+ *   second core on ESP32), off the router's send and receive paths
+ * - Decodes into buffers of its own and holds decoded texts in a bounded
+ *   store until a client is connected, so received frames take no
+ *   packets from the router's pool
+ * - Optionally keeps those texts compressed after the FEC check on a
+ *   headless node and decompresses them only when a client connects
+ * - Optionally logs received messages, compressed, to LittleFS, so the
+ *   last ones can be replayed to a phone (see MeshXTLog.h)
  *
  * MeshXT packets are identified by portnum PRIVATE_APP (256)
  * to avoid conflicting with standard TEXT_MESSAGE_APP packets.
@@ -24,7 +75,7 @@
  * 2. Add MeshXTModule to the module init list in modules/Modules.cpp
  * 3. Build with PlatformIO
  */
-class MeshXTModule : public MeshModule
+class MeshXTModule : public MeshModule, private concurrency::OSThread
 {
   public:
     MeshXTModule();
@@ -39,6 +90,19 @@ class MeshXTModule : public MeshModule
      */
     bool sendCompressed(const char *text, uint32_t dest, uint8_t channel = 0);
 
+    /**
+     * Send a codebook template (status, position report, weather, ...)
+     * as a few bytes of payload.
+     *
+     * @param name     Template name (e.g. "location", "battery", "ok")
+     * @param params   Template parameters (may be NULL for simple templates)
+     * @param dest     Destination node ID (NODENUM_BROADCAST for broadcast)
+     * @param channel  Channel index
+     * @return         true if sent successfully
+     */
+    bool sendTemplate(const char *name, const MeshXTTemplateParams *params, uint32_t dest,
+                      uint8_t channel = 0);
+
     /**
      * Intercept an outgoing TEXT_MESSAGE_APP packet from the phone/app.
      * Rewrites it in-place as a MeshXT-compressed packet.
@@ -51,14 +115,275 @@ class MeshXTModule : public MeshModule
      */
     bool interceptTextMessage(meshtastic_MeshPacket *mp);
 
+    /**
+     * Hold an outgoing TEXT_MESSAGE_APP packet for up to txCoalesceMs, so
+     * it can share one frame (header and parity) with the next messages
+     * to the same destination and channel; or, with asyncCodec, hand it
+     * to the worker task and send it once compressed. Packets with
+     * want_ack are not batched: only the first packet's ID goes on air.
+     *
+     * Called from Router::send() before interceptTextMessage().
+     *
+     * @param mp  Packet from the phone/app
+     * @return    true if the module took the packet: the router must not
+     *            send or release it. false: send it via interceptTextMessage
+     */
+    bool deferTextMessage(meshtastic_MeshPacket *mp);
+
+    /** Counters and stage timings since boot or the last resetStats(). */
+    const MeshXTStats &getStats();
+
+    void resetStats();
+
+    /**
+     * Ask `dest` for its statistics. The report comes back as a
+     * MESHXT_COMP_STATS frame, is logged, and is passed on to the phone.
+     */
+    bool requestStats(uint32_t dest, uint8_t channel = 0);
+
+    /**
+     * Hand the last `count` logged messages (logMessages) to the connected
+     * client as TEXT_MESSAGE_APP packets, oldest first, with their
+     * original sender, destination, channel and packet ID. Messages still
+     * held for the phone are left to flushPending(). Called by the module
+     * itself for the last logReplay messages when a client connects.
+     *
+     * @return  Messages replayed, or -1 if no client is connected
+     */
+    int replayLog(size_t count);
+
   protected:
     virtual ProcessMessage handleReceived(const meshtastic_MeshPacket &mp) override;
     virtual bool wantPacket(const meshtastic_MeshPacket *p) override;
 
+    /** Collect finished worker jobs; send held messages when their window closes. */
+    virtual int32_t runOnce() override;
+
   private:
+    /** The parts of a received packet needed to hand its text to the phone. */
+    struct RxMeta {
+        uint32_t from;
+        uint32_t to;
+        uint32_t id;
+        uint32_t rxTime;
+        float rxSnr;
+        int32_t rxRssi;
+        uint8_t channel;
+        uint8_t hopLimit;
+        uint8_t hopStart;
+        bool viaMqtt;
+        bool pkiEncrypted;
+    };
+
+    /**
+     * Encode text as a template packet when it matches one exactly, else
+     * with compType, the channel's dictionary or the history shared with
+     * `dest` (whichever is shortest), then add parity at the level chosen
+     * for `dest`.
+     */
+    int encodeText(const char *text, uint32_t dest, uint8_t channel, uint8_t *output, uint8_t *fecUsed);
+
+    /** Send the messages held by deferTextMessage() as one frame. */
+    void flushBatch();
+
+    /** Deliver each message of a batch frame as its own text message. */
+    ProcessMessage handleBatch(const RxMeta &mp, const uint8_t *payload, int payloadLen, int frameLen);
+
+    /** Load and register the per-channel dictionaries found in LittleFS. */
+    void loadDictionaries();
+
+    /**
+     * Send text too long for one frame as fragments. With `first`, the
+     * first fragment is written into it instead of being sent.
+     *
+     * @return  Number of fragments, or -1 on error
+     */
+    int sendFragments(const char *text, uint32_t dest, uint8_t channel, meshtastic_MeshPacket *first);
+
+    /** Account for frames sent with `textLen` bytes of text, and the airtime saved. */
+    void countSent(size_t textLen, size_t frameBytes, uint32_t frames);
+
+    /** Send our report (payloadLen 0) or log a report received. */
+    ProcessMessage handleStats(const RxMeta &mp, const uint8_t *payload, int payloadLen);
+
+    /** Send a stats frame: the report, or a request when !report. */
+    bool sendStats(uint32_t dest, uint8_t channel, bool report);
+
+    /** Collect a received fragment and deliver the message once complete. */
+    ProcessMessage handleFragment(const meshtastic_MeshPacket &mp);
+
+    /** Show a decoded text on the screen and queue it for the phone. */
+    void deliverText(const RxMeta &meta, const char *text, size_t len);
+
+    /**
+     * True if a message's text can stay compressed until a client asks
+     * for it: lazyDecode is on, no client is connected, there is no screen
+     * to show it on and it does not extend a conversation history.
+     */
+    bool decodeLater(const RxMeta &mp) const;
+
+    /**
+     * Queue a message for the phone: text (MESHXT_COMP_NONE) or a payload
+     * of a stateless type, decompressed by flushPending(). The oldest
+     * entries are dropped to make room.
+     */
+    void holdForPhone(const RxMeta &meta, uint8_t compType, const uint8_t *data, size_t len);
+
+    /**
+     * Hand the queued texts to the phone, if a client is connected. A
+     * client that has just connected first gets the last logReplay
+     * logged messages.
+     */
+    void flushPending();
+
+    /** True if runOnce() should poll for a client connecting, to replay the log. */
+    bool watchingClient() const;
+
+    /** True if the message from `from` with packet ID `id` is queued for the phone. */
+    bool isPending(uint32_t from, uint32_t id) const;
+
+    /** Index the log segments in LittleFS, starting a new one if the last write was torn. */
+    void loadLog();
+
+    /** Append a delivered message to the log (arguments as for holdForPhone). */
+    void logMessage(const RxMeta &meta, uint8_t compType, const uint8_t *data, size_t len);
+
+    static RxMeta rxMeta(const meshtastic_MeshPacket &mp);
+
+    /** Build a TEXT_MESSAGE_APP packet as received from `meta.from`. */
+    static void fillTextPacket(meshtastic_MeshPacket *p, const RxMeta &meta, const char *text, size_t len);
+
+    /** History state of a direct-message conversation, one per direction. */
+    struct PeerHistory {
+        uint32_t node;           // 0 = free slot
+        uint32_t lastMs;
+        MeshXTHistory tx;        // Text sent to node
+        MeshXTHistory rx;        // Text received from node
+        uint16_t lastTxChecksum; // Send history the last message was coded against
+        uint16_t lastTxLen;      // Length of that message if it used the history, else 0
+    };
+
+    /**
+     * History of the conversation with `node`, or NULL for broadcasts,
+     * with useHistory off, or if there is none and !create. Creating one
+     * evicts the least recently used conversation.
+     */
+    PeerHistory *peerHistory(uint32_t node, bool create);
+
+    /**
+     * Shortest encoding of text without FEC: a template, compType, the
+     * channel's dictionary or, when `peer` is given, its send history.
+     */
+    int compressText(const char *text, uint8_t channel, PeerHistory *peer, uint8_t *output);
+
+    /** Append a message sent to `dest` as `sentType` to the send history. */
+    void rememberSent(uint32_t dest, const char *text, uint8_t sentType);
+
+    /** Append a message received in a direct message to the receive history. */
+    void rememberReceived(const RxMeta &mp, const char *text, int len, uint8_t sentType);
+
+    /** Our receive history did not match `checksum`: clear it and tell the sender. */
+    void requestResync(const RxMeta &mp, PeerHistory *peer, uint16_t checksum);
+
+    /** The peer cleared its history: clear ours and resend what it could not decode. */
+    void handleResync(const RxMeta &mp, PeerHistory *peer, uint16_t checksum);
+
+    /**
+     * Add parity to a packet built without FEC, at the level chosen for
+     * `dest`, in place.
+     */
+    int addFec(uint8_t *packet, int packetLen, uint32_t dest, uint8_t *fecUsed);
+
+    /** Packet handed to the worker task, and what it did with it. */
+    struct AsyncJob {
+        meshtastic_MeshPacket *mp; // TX: the phone's packet
+        bool busy;                 // Owned by the worker or waiting to be collected (main thread only)
+        bool rx;
+        int result;                // TX: packet length without FEC; RX: payload length after FEC; -1 = failed
+        uint32_t cycles;           // Time the worker spent on it
+        RxMeta meta;               // RX: sender and link details
+        MeshXTPacketInfo info;     // RX: header and corrections
+        uint8_t frame[MESHXT_MAX_PACKET_SIZE]; // TX: compressed packet; RX: received frame, corrected in place
+        size_t frameLen;           // RX
+    };
+
+    /** Start the worker task, if this target has one. */
+    void startWorker();
+
+    /** A free job, or NULL if the worker is not running or all jobs are out. */
+    AsyncJob *takeJob();
+
+    /** Hand a filled-in job from takeJob() to the worker. */
+    void submitJob(AsyncJob *job);
+
+    /** Worker side: compress or FEC-decode one packet. */
+    void runJob(AsyncJob *job);
+
+    /** Main thread: finish the jobs the worker is done with. */
+    void collectJobs();
+
+    /** Send a compressed packet back from the worker, or fall back to the inline path. */
+    void finishEncode(AsyncJob *job);
+
+    /** Decompress and deliver a frame after FEC decoding. */
+    ProcessMessage finishDecode(const RxMeta &mp, uint8_t *frame, int payloadLen, MeshXTPacketInfo &info);
+
+#ifdef MESHXT_HAS_WORKER
+    static void workerTask(void *arg);
+#endif
+
+    /** fecCode argument for a level, with the parity-ratio option applied. */
+    uint8_t fecArg(uint8_t fec) const;
+
+    /** Feed a received packet's link quality into the adaptive selector. */
+    void observeLink(const meshtastic_MeshPacket &mp);
+
+    MeshXTAdaptive adaptive;
+    MeshXTReassembler reassembler;
+    MeshXTDictionary dicts[MESHXT_MODULE_DICTS];
+    uint8_t dictBlob[MESHXT_MODULE_DICTS][MESHXT_MODULE_DICT_BLOB];
+    uint8_t numDicts;
+    uint8_t channelDict[MESHXT_DICT_CHANNELS]; // Dictionary ID per channel (MESHXT_DICT_BUILTIN = none)
+    PeerHistory peers[MESHXT_HISTORY_PEERS];
+    MeshXTStats stats;
+    uint32_t statsSinceMs;
+    MeshXTBatch batch;     // Messages held for coalescing, all to batchDest on batchChannel
+    meshtastic_MeshPacket *batchPackets[MESHXT_BATCH_MAX_MESSAGES]; // Their packets; the first carries the frame
+    uint32_t batchDest;
+    uint8_t batchChannel;
+    size_t batchTextLen;
+    uint32_t batchDueMs;   // When the coalescing window closes
+    AsyncJob jobs[MESHXT_ASYNC_JOBS];
+    MeshXTQueue toWorker;  // Produced by the main thread, consumed by the worker
+    MeshXTQueue fromWorker;
+    void *worker;          // Task handle, NULL if not started
+    uint8_t jobsOut;       // Jobs submitted and not yet collected
+    bool passthrough;      // Sending a packet the worker gave back: do not take it again
+    uint8_t rxFrame[MESHXT_MAX_PACKET_SIZE]; // Inline decodes are FEC-corrected here
+    uint8_t pending[MESHXT_RX_STORE];        // Entries for the phone, oldest first
+    uint16_t pendingBytes;
+    uint8_t pendingCount;
+    bool clientConnected;                    // As of the last flushPending()
+    meshtastic_MeshPacket phoneMp;           // Scratch packet handed to the service, which copies it
+    MeshXTLogIndex logIndex;
+    uint16_t logBytes;                       // Size of the newer log segment
+
     uint8_t compType;
-    uint8_t fecLevel;
+    uint8_t fecLevel;      // Default FEC level, and the fixed level when adaptiveFec is off
     bool enabled;
+    bool useTemplates;
+    bool adaptiveFec;
+    bool parityRatio;
+    bool relayOnly;        // Forward MeshXT frames without decoding them (repeaters)
+    bool relayCheckParity; // In relay mode, also drop frames whose parity proves them uncorrectable
+    bool useHistory;       // Back-references into earlier messages of a direct-message conversation
+    uint8_t fragRepairPct; // Repair fragments per data fragment, in percent
+    uint8_t fragMsgId;     // ID of the next fragmented message
+    uint32_t txCoalesceMs; // Hold outgoing texts this long to batch them (0 = send each at once)
+    bool asyncCodec;       // Compress and FEC-decode on the worker task (MESHXT_HAS_WORKER targets)
+    bool lazyDecode;       // Keep texts for an absent client compressed; decompress when it connects
+    bool logMessages;      // Keep the last messages received in a compressed log in LittleFS
+    uint8_t logReplay;     // Logged messages replayed to a client when it connects (0 = none)
 };
 
 extern MeshXTModule *meshXTModule;
@@ -1,5 +1,6 @@
 #include "MeshXTPacket.h"
 #include "MeshXTCompress.h"
+#include "MeshXTCodebook.h"
 #include "MeshXTFEC.h"
 #include <string.h>
 
@@ -24,51 +25,310 @@ static void decode_header(const uint8_t *buf, MeshXTHeader *hdr) {
     hdr->flags    = buf[1] & 0x0F;
 }
 
-int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType, uint8_t fecCode) {
-    uint8_t payload[256];
-    int payloadLen;
+uint8_t meshxt_fec_ratio_nsym(uint8_t fecCode, size_t payloadLen) {
+    uint8_t levelNsym = meshxt_fec_nsym_from_code(fecCode);
+    if (levelNsym == 0) return 0;
 
-    // Step 1: Compress
+    // Parity per payload byte of a full frame at this level, rounded up to a step
+    size_t fullPayload = MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - levelNsym;
+    size_t nsym = (levelNsym * payloadLen + fullPayload - 1) / fullPayload;
+    nsym = (nsym + MESHXT_FEC_STEP - 1) / MESHXT_FEC_STEP * MESHXT_FEC_STEP;
+    if (nsym < MESHXT_FEC_STEP) nsym = MESHXT_FEC_STEP;
+    if (nsym > levelNsym) nsym = levelNsym;
+    return (uint8_t)nsym;
+}
+
+/**
+ * On-air FEC layout of one frame: level code and flags nibble as written
+ * in the header, and the RS parameters they stand for.
+ */
+struct FecLayout {
+    uint8_t code;
+    uint8_t flags;
+    uint8_t nsym;    // parity per codeword (0 = no FEC)
+    uint8_t depth;   // codewords
+};
+
+/**
+ * Layout for a fecCode argument (level | MESHXT_FEC_DEPTH(n) or
+ * level | MESHXT_FEC_RATIO) and the payload it will protect.
+ */
+static FecLayout fec_layout_from_arg(uint8_t fecArg, size_t payloadLen) {
+    FecLayout l;
+    l.code = fecArg & 0x0F;
+    l.flags = 0;
+    l.nsym = meshxt_fec_nsym_from_code(l.code);
+    l.depth = 1;
+    if (l.nsym == 0) return l;
+
+    if (fecArg & MESHXT_FEC_RATIO) {
+        l.nsym = meshxt_fec_ratio_nsym(l.code, payloadLen);
+        l.code = MESHXT_FEC_SHORT_CODE;
+        l.flags = l.nsym / MESHXT_FEC_STEP - 1;
+        return l;
+    }
+
+    uint8_t depth = (fecArg >> 4) & 0x07;
+    if (depth > 1) {
+        l.depth = depth;
+        l.flags = depth;
+    }
+    return l;
+}
+
+static FecLayout fec_layout_from_header(const MeshXTHeader *hdr) {
+    FecLayout l;
+    l.code = hdr->fecLevel;
+    l.flags = hdr->flags;
+    l.depth = 1;
+    if (hdr->fecLevel == MESHXT_FEC_SHORT_CODE) {
+        l.nsym = (hdr->flags + 1) * MESHXT_FEC_STEP;
+    } else {
+        l.nsym = meshxt_fec_nsym_from_code(hdr->fecLevel);
+        if (l.nsym > 0 && hdr->flags > 1) l.depth = hdr->flags;
+    }
+    return l;
+}
+
+/**
+ * Payload bytes available after header and parity. Ratio mode never uses
+ * more parity than its level, so the level's room is used.
+ */
+static size_t payload_room(uint8_t fecArg) {
+    FecLayout l = fec_layout_from_arg((uint8_t)(fecArg & ~MESHXT_FEC_RATIO), 0);
+    size_t parity = (size_t)l.depth * l.nsym;
+    if (parity > MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE) return 0;
+    return MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - parity;
+}
+
+/**
+ * Append parity in place after the payload at output + header, then
+ * write the header.
+ */
+static int finish_packet(uint8_t *output, int payloadLen, uint8_t compType, uint8_t fecArg) {
+    FecLayout l = fec_layout_from_arg(fecArg, payloadLen);
+    uint8_t *payload = output + MESHXT_HEADER_SIZE;
+
+    int fecLen = payloadLen;
+    if (l.nsym > 0) {
+        fecLen = meshxt_fec_encode_interleaved(payload, payloadLen, payload, l.nsym, l.depth);
+        if (fecLen < 0) return -1;
+    }
+
+    encode_header(output, MESHXT_PACKET_VERSION, compType, l.code, l.flags);
+    return MESHXT_HEADER_SIZE + fecLen;
+}
+
+/**
+ * Compress message into payload. Returns the payload length, or -1.
+ */
+static int compress_payload(const char *message, uint8_t *payload, size_t room, uint8_t compType,
+                            bool optimal) {
+    int payloadLen;
     switch (compType) {
         case MESHXT_COMP_SMAZ:
-            payloadLen = meshxt_compress(message, payload, sizeof(payload));
-            if (payloadLen < 0) return -1;
-            break;
+            return optimal ? meshxt_compress_optimal(message, payload, room)
+                           : meshxt_compress(message, payload, room);
+        case MESHXT_COMP_ENTROPY:
+            return meshxt_compress_entropy(message, payload, room);
+        case MESHXT_COMP_CODEBOOK:
+            return meshxt_codebook_match(message, payload, room);
         case MESHXT_COMP_NONE:
             payloadLen = (int)strlen(message);
-            if (payloadLen > 237) return -1;
+            if (payloadLen > (int)room) return -1;
             memcpy(payload, message, payloadLen);
-            break;
+            return payloadLen;
         default:
             return -1;
     }
+}
 
-    // Step 2: Apply FEC
-    uint8_t nsym = meshxt_fec_nsym_from_code(fecCode);
-    uint8_t fecData[320]; // payload + parity
-    int fecLen;
+int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType, uint8_t fecCode) {
+    bool optimal = (compType & MESHXT_COMP_OPTIMAL) != 0;
+    compType &= 0x0F;
 
-    if (nsym > 0) {
-        fecLen = meshxt_fec_encode(payload, payloadLen, fecData, nsym);
-        if (fecLen < 0) return -1;
-    } else {
-        memcpy(fecData, payload, payloadLen);
-        fecLen = payloadLen;
-    }
+    // Step 1: Compress
+    // Payload is built in place after the header, leaving room for parity
+    int payloadLen = compress_payload(message, output + MESHXT_HEADER_SIZE, payload_room(fecCode),
+                                      compType, optimal);
+    if (payloadLen < 0) return -1;
 
+    // Step 2: Apply FEC (parity appended in place)
     // Step 3: Build header
-    encode_header(output, MESHXT_PACKET_VERSION, compType, fecCode, 0);
+    return finish_packet(output, payloadLen, compType, fecCode);
+}
 
-    // Step 4: Assemble
-    int totalLen = MESHXT_HEADER_SIZE + fecLen;
-    if (totalLen > MESHXT_MAX_PACKET_SIZE) return -1;
+int meshxt_create_large_packet(const char *message, uint8_t *output, size_t outSize, uint8_t compType) {
+    bool optimal = (compType & MESHXT_COMP_OPTIMAL) != 0;
+    compType &= 0x0F;
+    if (outSize < MESHXT_HEADER_SIZE) return -1;
 
-    memcpy(output + MESHXT_HEADER_SIZE, fecData, fecLen);
+    int payloadLen = compress_payload(message, output + MESHXT_HEADER_SIZE, outSize - MESHXT_HEADER_SIZE,
+                                      compType, optimal);
+    if (payloadLen < 0) return -1;
 
-    return totalLen;
+    encode_header(output, MESHXT_PACKET_VERSION, compType, MESHXT_FEC_NONE_CODE, 0);
+    return MESHXT_HEADER_SIZE + payloadLen;
+}
+
+int meshxt_create_raw_packet(const uint8_t *payload, size_t payloadLen, uint8_t *output,
+                             uint8_t compType, uint8_t fecCode) {
+    if (payloadLen > payload_room(fecCode)) return -1;
+
+    memmove(output + MESHXT_HEADER_SIZE, payload, payloadLen);
+    return finish_packet(output, (int)payloadLen, compType & 0x0F, fecCode);
+}
+
+int meshxt_create_dict_packet(const char *message, uint8_t *output, const MeshXTDictionary *dict,
+                              uint8_t fecCode) {
+    size_t room = payload_room(fecCode);
+    if (room < 1) return -1;
+
+    uint8_t *payload = output + MESHXT_HEADER_SIZE;
+    payload[0] = dict->id;
+    int compLen = meshxt_compress_dict(dict, message, payload + 1, room - 1);
+    if (compLen < 0) return -1;
+
+    return finish_packet(output, 1 + compLen, MESHXT_COMP_DICT, fecCode);
+}
+
+int meshxt_create_history_packet(const char *message, uint8_t *output, const MeshXTHistory *history,
+                                 uint8_t fecCode) {
+    size_t room = payload_room(fecCode);
+    if (room < 2) return -1;
+
+    uint8_t *payload = output + MESHXT_HEADER_SIZE;
+    uint16_t checksum = meshxt_history_checksum(history);
+    payload[0] = (uint8_t)(checksum >> 8);
+    payload[1] = (uint8_t)(checksum & 0xFF);
+    int compLen = meshxt_compress_history(history, message, payload + 2, room - 2);
+    if (compLen < 0) return -1;
+
+    return finish_packet(output, 2 + compLen, MESHXT_COMP_HISTORY, fecCode);
+}
+
+int meshxt_create_history_resync(uint8_t *output, uint16_t checksum, uint8_t fecCode) {
+    // A lone back-reference marker: never a valid stream, so never text
+    const uint8_t payload[3] = {(uint8_t)(checksum >> 8), (uint8_t)(checksum & 0xFF), MESHXT_HISTORY_REF};
+    return meshxt_create_raw_packet(payload, sizeof(payload), output, MESHXT_COMP_HISTORY, fecCode);
+}
+
+// ---------------------------------------------------------------------------
+// Batches
+// ---------------------------------------------------------------------------
+
+/** Types whose payload decodes without other packets or state. */
+static bool batchable(uint8_t compType) {
+    switch (compType) {
+        case MESHXT_COMP_NONE:
+        case MESHXT_COMP_SMAZ:
+        case MESHXT_COMP_CODEBOOK:
+        case MESHXT_COMP_DICT:
+        case MESHXT_COMP_ENTROPY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void meshxt_batch_init(MeshXTBatch *batch) {
+    batch->len = 0;
+    batch->count = 0;
+}
+
+int meshxt_batch_add(MeshXTBatch *batch, const uint8_t *packet, size_t packetLen) {
+    if (packetLen < MESHXT_HEADER_SIZE || batch->count >= MESHXT_BATCH_MAX_MESSAGES) return -1;
+
+    MeshXTHeader hdr;
+    decode_header(packet, &hdr);
+    if (hdr.version != MESHXT_PACKET_VERSION || hdr.fecLevel != MESHXT_FEC_NONE_CODE || !batchable(hdr.compType))
+        return -1;
+
+    size_t dataLen = packetLen - MESHXT_HEADER_SIZE;
+    if (dataLen > 255 || batch->len + 2 + dataLen > MESHXT_BATCH_MAX_PAYLOAD) return -1;
+
+    uint8_t *p = batch->payload + batch->len;
+    p[0] = hdr.compType;
+    p[1] = (uint8_t)dataLen;
+    memcpy(p + 2, packet + MESHXT_HEADER_SIZE, dataLen);
+    batch->len += 2 + dataLen;
+    batch->count++;
+    return 0;
+}
+
+int meshxt_create_batch_packet(const MeshXTBatch *batch, uint8_t *output, uint8_t fecCode) {
+    if (batch->count == 0) return -1;
+    return meshxt_create_raw_packet(batch->payload, batch->len, output, MESHXT_COMP_BATCH, fecCode);
+}
+
+size_t meshxt_packet_payload_room(uint8_t fecCode) {
+    return payload_room(fecCode);
+}
+
+int meshxt_create_template_packet(const char *name, const MeshXTTemplateParams *params,
+                                  uint8_t *output, uint8_t fecCode) {
+    uint8_t *payload = output + MESHXT_HEADER_SIZE;
+    int payloadLen = meshxt_codebook_encode(name, params, payload, payload_room(fecCode));
+    if (payloadLen < 0) return -1;
+
+    return finish_packet(output, payloadLen, MESHXT_COMP_CODEBOOK, fecCode);
+}
+
+int meshxt_packet_add_fec(uint8_t *packet, size_t packetLen, uint8_t fecCode) {
+    if (packetLen < MESHXT_HEADER_SIZE) return -1;
+
+    MeshXTHeader hdr;
+    decode_header(packet, &hdr);
+    if (hdr.version != MESHXT_PACKET_VERSION || hdr.fecLevel != MESHXT_FEC_NONE_CODE) return -1;
+
+    size_t payloadLen = packetLen - MESHXT_HEADER_SIZE;
+    if (payloadLen > payload_room(fecCode)) return -1;
+
+    return finish_packet(packet, (int)payloadLen, hdr.compType, fecCode);
+}
+
+/**
+ * Decompress a FEC-decoded payload into a text buffer (null-terminated).
+ * The payload is validated first, so text is left untouched on error.
+ */
+static int decompress_payload(uint8_t compType, const uint8_t *payload, int payloadLen,
+                              char *text, size_t textSize) {
+    switch (compType) {
+        case MESHXT_COMP_SMAZ: {
+            int textLen = meshxt_decompressed_len(payload, payloadLen);
+            if (textLen < 0 || textLen >= (int)textSize) return -1;
+            return meshxt_decompress(payload, payloadLen, text, textSize);
+        }
+        case MESHXT_COMP_ENTROPY: {
+            int textLen = meshxt_decompressed_len_entropy(payload, payloadLen);
+            if (textLen < 0 || textLen >= (int)textSize) return -1;
+            return meshxt_decompress_entropy(payload, payloadLen, text, textSize);
+        }
+        case MESHXT_COMP_DICT: {
+            const MeshXTDictionary *dict = payloadLen >= 1 ? meshxt_dict_find(payload[0]) : NULL;
+            if (!dict) return -1;
+            int textLen = meshxt_decompressed_len_dict(dict, payload + 1, payloadLen - 1);
+            if (textLen < 0 || textLen >= (int)textSize) return -1;
+            return meshxt_decompress_dict(dict, payload + 1, payloadLen - 1, text, textSize);
+        }
+        case MESHXT_COMP_CODEBOOK:
+            return meshxt_codebook_decode(payload, payloadLen, text, textSize);
+        case MESHXT_COMP_NONE:
+            if (payloadLen >= (int)textSize) return -1;
+            memmove(text, payload, payloadLen);
+            text[payloadLen] = '\0';
+            return payloadLen;
+        default:
+            return -1;
+    }
 }
 
 int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResult *result) {
+    return meshxt_parse_packet_erasures(packet, packetLen, NULL, 0, result);
+}
+
+int meshxt_parse_packet_erasures(const uint8_t *packet, size_t packetLen, const uint8_t *erasures,
+                                 size_t numErasures, MeshXTParseResult *result) {
     memset(result, 0, sizeof(MeshXTParseResult));
 
     if (packetLen < MESHXT_HEADER_SIZE) {
@@ -89,12 +349,25 @@ int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResu
     size_t dataLen = packetLen - MESHXT_HEADER_SIZE;
 
     // Step 3: FEC decode
-    uint8_t nsym = meshxt_fec_nsym_from_code(result->header.fecLevel);
+    FecLayout fec = fec_layout_from_header(&result->header);
     uint8_t decoded[256];
     int decodedLen;
+    if (dataLen > sizeof(decoded)) {
+        result->valid = false;
+        return -1;
+    }
+
+    if (fec.nsym > 0) {
+        // Hints are packet offsets; the FEC layer wants frame offsets
+        uint8_t framePos[MESHXT_MAX_PACKET_SIZE];
+        size_t numFramePos = 0;
+        for (size_t i = 0; i < numErasures && numFramePos < sizeof(framePos); i++) {
+            if (erasures[i] < MESHXT_HEADER_SIZE) continue;
+            framePos[numFramePos++] = (uint8_t)(erasures[i] - MESHXT_HEADER_SIZE);
+        }
 
-    if (nsym > 0) {
-        decodedLen = meshxt_fec_decode(data, dataLen, decoded, nsym);
+        decodedLen = meshxt_fec_decode_interleaved(data, dataLen, framePos, numFramePos, decoded,
+                                                   fec.nsym, fec.depth, &result->fecCorrected);
         if (decodedLen < 0) {
             result->valid = false;
             return -1;
@@ -107,30 +380,159 @@ int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResu
     result->payloadSize = decodedLen;
 
     // Step 4: Decompress
-    switch (result->header.compType) {
+    result->messageLen = decompress_payload(result->header.compType, decoded, decodedLen,
+                                            result->message, sizeof(result->message));
+    if (result->messageLen < 0) {
+        result->valid = false;
+        return -1;
+    }
+
+    result->packetSize = (int)packetLen;
+    result->valid = true;
+    return 0;
+}
+
+int meshxt_packet_check(const uint8_t *packet, size_t packetLen, bool checkParity) {
+    if (packetLen < MESHXT_HEADER_SIZE || packetLen > MESHXT_MAX_PACKET_SIZE) return MESHXT_CHECK_INVALID;
+
+    MeshXTHeader hdr;
+    decode_header(packet, &hdr);
+    if (hdr.version != MESHXT_PACKET_VERSION) return MESHXT_CHECK_INVALID;
+    if (hdr.compType > MESHXT_COMP_BATCH || hdr.fecLevel > MESHXT_FEC_SHORT_CODE) return MESHXT_CHECK_INVALID;
+
+    FecLayout fec = fec_layout_from_header(&hdr);
+    if (fec.nsym == 0) return MESHXT_CHECK_CLEAN;
+
+    const uint8_t *data = packet + MESHXT_HEADER_SIZE;
+    size_t dataLen = packetLen - MESHXT_HEADER_SIZE;
+    size_t parity = (size_t)fec.depth * fec.nsym;
+    if (dataLen < parity || (fec.depth > 1 && dataLen - parity < fec.depth)) return MESHXT_CHECK_INVALID;
+    if (!checkParity) return MESHXT_CHECK_CLEAN;
+
+    int check = meshxt_fec_check(data, dataLen, fec.nsym, fec.depth);
+    return check < 0 ? MESHXT_CHECK_INVALID : (check > 0 ? MESHXT_CHECK_DAMAGED : MESHXT_CHECK_CLEAN);
+}
+
+int meshxt_packet_decode_fec(uint8_t *packet, size_t packetLen, MeshXTPacketInfo *info) {
+    memset(info, 0, sizeof(MeshXTPacketInfo));
+
+    if (packetLen < MESHXT_HEADER_SIZE) return -1;
+
+    decode_header(packet, &info->header);
+    if (info->header.version != MESHXT_PACKET_VERSION) return -1;
+
+    uint8_t *data = packet + MESHXT_HEADER_SIZE;
+    int dataLen = (int)(packetLen - MESHXT_HEADER_SIZE);
+
+    // FEC repairs are written back over the received bytes
+    FecLayout fec = fec_layout_from_header(&info->header);
+    if (fec.nsym > 0) {
+        dataLen = meshxt_fec_decode_interleaved(data, dataLen, NULL, 0, data, fec.nsym, fec.depth,
+                                                &info->fecCorrected);
+        if (dataLen < 0) return -1;
+    }
+
+    info->packetSize = (int)packetLen;
+    info->payloadSize = dataLen;
+    return dataLen;
+}
+
+int meshxt_parse_packet_inplace(uint8_t *packet, size_t packetLen, char *text, size_t textSize,
+                                MeshXTPacketInfo *info) {
+    MeshXTPacketInfo local;
+    if (!info) info = &local;
+
+    int payloadLen = meshxt_packet_decode_fec(packet, packetLen, info);
+    if (payloadLen < 0) return -1;
+
+    info->messageLen = decompress_payload(info->header.compType, packet + MESHXT_HEADER_SIZE,
+                                          payloadLen, text, textSize);
+    return info->messageLen;
+}
+
+int meshxt_parse_packet_stream(uint8_t *packet, size_t packetLen, MeshXTTextSink sink, void *ctx,
+                               MeshXTPacketInfo *info) {
+    MeshXTPacketInfo local;
+    if (!info) info = &local;
+
+    int payloadLen = meshxt_packet_decode_fec(packet, packetLen, info);
+    if (payloadLen < 0) return -1;
+
+    const uint8_t *payload = packet + MESHXT_HEADER_SIZE;
+    switch (info->header.compType) {
         case MESHXT_COMP_SMAZ:
-            result->messageLen = meshxt_decompress(decoded, decodedLen,
-                                                    result->message, sizeof(result->message));
-            if (result->messageLen < 0) {
-                result->valid = false;
-                return -1;
-            }
+            info->messageLen = meshxt_decompress_stream(payload, payloadLen, sink, ctx);
+            break;
+        case MESHXT_COMP_ENTROPY:
+            info->messageLen = meshxt_decompress_entropy_stream(payload, payloadLen, sink, ctx);
+            break;
+        case MESHXT_COMP_DICT: {
+            const MeshXTDictionary *dict = payloadLen >= 1 ? meshxt_dict_find(payload[0]) : NULL;
+            info->messageLen = dict ? meshxt_decompress_stream_dict(dict, payload + 1, payloadLen - 1, sink, ctx)
+                                    : -1;
             break;
+        }
         case MESHXT_COMP_NONE:
-            if (decodedLen >= (int)sizeof(result->message)) {
-                result->valid = false;
-                return -1;
-            }
-            memcpy(result->message, decoded, decodedLen);
-            result->message[decodedLen] = '\0';
-            result->messageLen = decodedLen;
+            info->messageLen = sink((const char *)payload, payloadLen, ctx) == 0 ? payloadLen : -1;
+            break;
+        case MESHXT_COMP_CODEBOOK: {
+            char text[MESHXT_TEMPLATE_MAX_TEXT];
+            int textLen = meshxt_codebook_decode(payload, payloadLen, text, sizeof(text));
+            info->messageLen = (textLen >= 0 && sink(text, textLen, ctx) == 0) ? textLen : -1;
             break;
+        }
         default:
-            result->valid = false;
-            return -1;
+            info->messageLen = -1;
+            break;
     }
+    return info->messageLen;
+}
 
-    result->packetSize = (int)packetLen;
-    result->valid = true;
-    return 0;
+int meshxt_parse_history_packet(uint8_t *packet, size_t packetLen, const MeshXTHistory *history, char *text,
+                                size_t textSize, MeshXTPacketInfo *info) {
+    MeshXTPacketInfo local;
+    if (!info) info = &local;
+
+    int payloadLen = meshxt_packet_decode_fec(packet, packetLen, info);
+    if (payloadLen < 0) return -1;
+    return meshxt_packet_decompress(packet, payloadLen, history, text, textSize, info);
+}
+
+int meshxt_packet_decompress(const uint8_t *packet, int payloadLen, const MeshXTHistory *history, char *text,
+                             size_t textSize, MeshXTPacketInfo *info) {
+    const uint8_t *payload = packet + MESHXT_HEADER_SIZE;
+    if (info->header.compType != MESHXT_COMP_HISTORY) {
+        info->messageLen = decompress_payload(info->header.compType, payload, payloadLen, text, textSize);
+        return info->messageLen;
+    }
+
+    if (payloadLen < 2) return -1;
+    uint16_t checksum = (uint16_t)(payload[0] << 8 | payload[1]);
+    if (payloadLen == 3 && payload[2] == MESHXT_HISTORY_REF) {
+        info->messageLen = checksum;
+        return MESHXT_HISTORY_RESYNC;
+    }
+    if (!history || checksum != meshxt_history_checksum(history)) return MESHXT_HISTORY_DESYNC;
+
+    int textLen = meshxt_decompressed_len_history(history, payload + 2, payloadLen - 2);
+    if (textLen < 0 || textLen >= (int)textSize) return -1;
+    info->messageLen = meshxt_decompress_history(history, payload + 2, payloadLen - 2, text, textSize);
+    return info->messageLen;
+}
+
+int meshxt_batch_next(const uint8_t *payload, size_t payloadLen, size_t *offset, char *text, size_t textSize,
+                      uint8_t *compType) {
+    size_t pos = *offset;
+    if (pos + 2 > payloadLen) return -1;
+
+    uint8_t type = payload[pos];
+    size_t dataLen = payload[pos + 1];
+    if (!batchable(type) || pos + 2 + dataLen > payloadLen) return -1;
+
+    int textLen = decompress_payload(type, payload + pos + 2, (int)dataLen, text, textSize);
+    if (textLen < 0) return -1;
+
+    if (compType) *compType = type;
+    *offset = pos + 2 + dataLen;
+    return textLen;
 }
@@ -2,16 +2,31 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+
+#include "MeshXTCompress.h"
+#include "MeshXTCodebook.h"
+#include "MeshXTEntropy.h"
+#include "MeshXTHistory.h"
+#include "MeshXTFEC.h"
 
 /**
  * MeshXT Packet Framing
  *
  * Header (2 bytes):
  *   Byte 0: [VVVV CCCC] Version (4 bits) | Compression type (4 bits)
- *   Byte 1: [FFFF xxxx] FEC level (4 bits) | Flags (4 bits)
+ *   Byte 1: [FFFF NNNN] FEC level (4 bits) | Flags (4 bits)
  *
- * Compression types: 0=none, 1=smaz, 2=codebook
- * FEC levels: 0=none, 1=low(16), 2=medium(32), 3=high(64)
+ * Compression types: 0=none, 1=smaz, 2=codebook, 3=fragment (see MeshXTFragment.h),
+ *                    4=trained dictionary (payload byte 0 = dictionary ID),
+ *                    5=entropy-coded Smaz (see MeshXTEntropy.h),
+ *                    6=shared history (payload bytes 0-1 = history checksum),
+ *                    7=statistics (empty = request, else a report; see MeshXTStats.h),
+ *                    8=batch (several short messages, see meshxt_batch_add)
+ * FEC levels: 0=none, 1=low(16), 2=medium(32), 3=high(64), 4=short
+ * Flags: levels 1-3: number of interleaved RS codewords, each with the
+ *        level's parity (0 = one codeword)
+ *        short:     one codeword with 4 * (flags + 1) parity symbols
  */
 
 #define MESHXT_PACKET_VERSION  1
@@ -21,11 +36,31 @@
 #define MESHXT_COMP_NONE     0
 #define MESHXT_COMP_SMAZ     1
 #define MESHXT_COMP_CODEBOOK 2
+#define MESHXT_COMP_FRAGMENT 3  // one piece of a multi-packet message
+#define MESHXT_COMP_DICT     4  // Smaz format with a trained dictionary (see meshxt_dict_load)
+#define MESHXT_COMP_ENTROPY  5  // codebook symbols arithmetic-coded with an order-1 model
+#define MESHXT_COMP_HISTORY  6  // Smaz format with back-references into earlier messages
+#define MESHXT_COMP_STATS    7  // module statistics request / report, not text
+#define MESHXT_COMP_BATCH    8  // several messages sharing one header and parity block
+
+// Encoder option, OR'd into the compType argument of meshxt_create_packet.
+// Uses the optimal (shortest output) Smaz parse; not sent on the wire.
+#define MESHXT_COMP_OPTIMAL  0x10
 
 #define MESHXT_FEC_NONE_CODE   0
 #define MESHXT_FEC_LOW_CODE    1
 #define MESHXT_FEC_MEDIUM_CODE 2
 #define MESHXT_FEC_HIGH_CODE   3
+#define MESHXT_FEC_SHORT_CODE  4  // shortened parity, written by MESHXT_FEC_RATIO
+
+// Encoder option, OR'd into the fecCode argument: split the FEC over n
+// interleaved codewords (2..7) to spread out bursts
+#define MESHXT_FEC_DEPTH(n)    ((uint8_t)(((n) & 0x07) << 4))
+
+// Encoder option, OR'd into a level code: scale parity to the payload
+// (see meshxt_fec_ratio_nsym). Sent as MESHXT_FEC_SHORT_CODE; not
+// combinable with MESHXT_FEC_DEPTH.
+#define MESHXT_FEC_RATIO       0x80
 
 /**
  * Parsed packet header.
@@ -37,6 +72,18 @@ typedef struct {
     uint8_t flags;
 } MeshXTHeader;
 
+/**
+ * Packet metadata from a parse, without the decoded text.
+ * Used by the caller-storage and streaming parse APIs.
+ */
+typedef struct {
+    MeshXTHeader header;   // Parsed header
+    int messageLen;        // Length of decoded message
+    int packetSize;        // Total packet size
+    int payloadSize;       // Compressed payload size
+    int fecCorrected;      // Symbols repaired by FEC (0 = clean)
+} MeshXTPacketInfo;
+
 /**
  * Result of parsing a packet.
  */
@@ -46,6 +93,7 @@ typedef struct {
     MeshXTHeader header;   // Parsed header
     int packetSize;        // Total packet size
     int payloadSize;       // Compressed payload size
+    int fecCorrected;      // Symbols repaired by FEC (0 = clean)
     bool valid;            // Whether parsing succeeded
 } MeshXTParseResult;
 
@@ -53,13 +101,169 @@ typedef struct {
  * Create a MeshXT packet from a text message.
  *
  * @param message    Input text (null-terminated)
- * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
- * @param compType   Compression type (MESHXT_COMP_*)
- * @param fecCode    FEC level code (MESHXT_FEC_*_CODE)
+ * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes).
+ *                   Compression and RS parity are written directly into it.
+ * @param compType   Compression type (MESHXT_COMP_*), optionally | MESHXT_COMP_OPTIMAL.
+ *                   MESHXT_COMP_CODEBOOK fails (-1) unless the text exactly
+ *                   matches a template (see meshxt_codebook_match).
+ * @param fecCode    FEC level code (MESHXT_FEC_*_CODE), optionally | MESHXT_FEC_DEPTH(n)
  * @return           Packet size in bytes, or -1 on error
  */
 int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType, uint8_t fecCode);
 
+/**
+ * Create a codebook (compType 2) packet directly from a template and its
+ * parameters, e.g. a position report or battery status.
+ *
+ * @param name       Template name (e.g. "location", "battery")
+ * @param params     Template parameters (may be NULL for simple templates)
+ * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param fecCode    FEC level code (MESHXT_FEC_*_CODE), optionally | MESHXT_FEC_DEPTH(n)
+ * @return           Packet size in bytes, or -1 on error
+ */
+int meshxt_create_template_packet(const char *name, const MeshXTTemplateParams *params,
+                                  uint8_t *output, uint8_t fecCode);
+
+/**
+ * Create a packet compressed with a trained dictionary (compType 4). The
+ * payload starts with the dictionary ID; receivers decode it with the
+ * dictionary they registered under that ID (meshxt_dict_register), and
+ * fail the parse if they have none.
+ *
+ * @param message    Input text (null-terminated)
+ * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param dict       Dictionary to compress with
+ * @param fecCode    FEC level code, with the same options as meshxt_create_packet
+ * @return           Packet size in bytes, or -1 on error
+ */
+int meshxt_create_dict_packet(const char *message, uint8_t *output, const MeshXTDictionary *dict,
+                              uint8_t fecCode);
+
+/**
+ * Create a packet compressed against a conversation history (compType 6).
+ * The payload starts with the checksum of the history, big-endian; the
+ * receiver decodes it with meshxt_parse_history_packet. The caller appends
+ * the message to its history once it is sent.
+ *
+ * @param message    Input text (null-terminated)
+ * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param history    History shared with the receiver
+ * @param fecCode    FEC level code, with the same options as meshxt_create_packet
+ * @return           Packet size in bytes, or -1 on error
+ */
+int meshxt_create_history_packet(const char *message, uint8_t *output, const MeshXTHistory *history,
+                                 uint8_t fecCode);
+
+/**
+ * Create a resync request: tells the sender of a history packet that the
+ * receiver's history did not match `checksum` (the one in that packet)
+ * and has been cleared. The sender should clear its history too and
+ * resend the message without it.
+ *
+ * @return  Packet size in bytes, or -1 on error
+ */
+int meshxt_create_history_resync(uint8_t *output, uint16_t checksum, uint8_t fecCode);
+
+// A batch carries at most this many messages, in a payload that fits one
+// frame at any FEC level
+#define MESHXT_BATCH_MAX_MESSAGES 8
+#define MESHXT_BATCH_MAX_PAYLOAD  (MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - MESHXT_FEC_HIGH)
+
+/**
+ * Payload of a batch packet (compType 8) being built. Each message is
+ * [compType][length][compressed bytes], in send order.
+ */
+typedef struct {
+    uint8_t payload[MESHXT_BATCH_MAX_PAYLOAD];
+    size_t len;
+    uint8_t count;
+} MeshXTBatch;
+
+/** Empty a batch. */
+void meshxt_batch_init(MeshXTBatch *batch);
+
+/**
+ * Add a message to a batch, taking its compressed payload from a packet
+ * built with MESHXT_FEC_NONE_CODE. Only types that decode on their own
+ * can be batched: none, smaz, codebook, dictionary and entropy.
+ *
+ * @param packet     Packet without FEC (e.g. from meshxt_create_packet)
+ * @param packetLen  Its length
+ * @return           0, or -1 if the batch is full, the message does not
+ *                   fit or its type cannot be batched
+ */
+int meshxt_batch_add(MeshXTBatch *batch, const uint8_t *packet, size_t packetLen);
+
+/**
+ * Frame a batch: one header and one set of RS parity for all its messages.
+ *
+ * @param output     Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param fecCode    FEC level code, with the same options as meshxt_create_packet
+ * @return           Packet size in bytes, or -1 if the batch is empty
+ */
+int meshxt_create_batch_packet(const MeshXTBatch *batch, uint8_t *output, uint8_t fecCode);
+
+/**
+ * Decode the next message from the payload of a batch packet, after
+ * meshxt_packet_decode_fec. Call with *offset = 0 first, until *offset
+ * reaches payloadLen. A malformed message ends the walk with -1; the
+ * messages before it have already been returned.
+ *
+ * @param payload     packet + MESHXT_HEADER_SIZE
+ * @param payloadLen  meshxt_packet_decode_fec's return value
+ * @param offset      Position in the payload; advanced past the message
+ * @param text        Output text buffer (null-terminated)
+ * @param textSize    Size of text buffer
+ * @param compType    Set to the message's compression type (may be NULL)
+ * @return            Text length, or -1 on error
+ */
+int meshxt_batch_next(const uint8_t *payload, size_t payloadLen, size_t *offset, char *text, size_t textSize,
+                      uint8_t *compType);
+
+/**
+ * Create a packet without FEC in a buffer of any size. Used for messages
+ * too long for one frame, which are then split by meshxt_fragment_message.
+ *
+ * @param message    Input text (null-terminated)
+ * @param output     Output buffer
+ * @param outSize    Size of output buffer
+ * @param compType   Compression type (MESHXT_COMP_*), optionally | MESHXT_COMP_OPTIMAL
+ * @return           Packet size in bytes, or -1 on error
+ */
+int meshxt_create_large_packet(const char *message, uint8_t *output, size_t outSize, uint8_t compType);
+
+/**
+ * Frame an already encoded payload: header, payload and RS parity.
+ *
+ * @param payload     Payload bytes (may be output + MESHXT_HEADER_SIZE)
+ * @param payloadLen  Payload length
+ * @param output      Output buffer (at least MESHXT_MAX_PACKET_SIZE bytes)
+ * @param compType    Compression type written in the header
+ * @param fecCode     FEC level code, with the same options as meshxt_create_packet
+ * @return            Packet size in bytes, or -1 if the payload does not fit
+ */
+int meshxt_create_raw_packet(const uint8_t *payload, size_t payloadLen, uint8_t *output,
+                             uint8_t compType, uint8_t fecCode);
+
+/**
+ * Largest payload (after the header, before parity) that fits in one
+ * frame with the given FEC.
+ *
+ * @param fecCode    FEC level code, with the same options as meshxt_create_packet
+ */
+size_t meshxt_packet_payload_room(uint8_t fecCode);
+
+/**
+ * Add RS parity to a packet built with MESHXT_FEC_NONE_CODE, in place.
+ * Lets a sender pick the FEC level after seeing the compressed size.
+ *
+ * @param packet     Packet bytes (room for MESHXT_MAX_PACKET_SIZE bytes)
+ * @param packetLen  Current packet length
+ * @param fecCode    FEC level code (MESHXT_FEC_*_CODE), optionally | MESHXT_FEC_DEPTH(n)
+ * @return           New packet size, or -1 on error or if it no longer fits
+ */
+int meshxt_packet_add_fec(uint8_t *packet, size_t packetLen, uint8_t fecCode);
+
 /**
  * Parse a MeshXT packet back to a text message.
  *
@@ -70,7 +274,241 @@ int meshxt_create_packet(const char *message, uint8_t *output, uint8_t compType,
  */
 int meshxt_parse_packet(const uint8_t *packet, size_t packetLen, MeshXTParseResult *result);
 
+/**
+ * Parse a packet with hints about which bytes are suspect, e.g. a region
+ * flagged by the radio or bytes of a fragment known to be missing. Hinted
+ * bytes are decoded as RS erasures, so up to nsym of them per codeword are
+ * recovered (against nsym/2 unknown errors). Hints inside the header are
+ * ignored; the header is not FEC-protected.
+ *
+ * @param erasures     Suspect byte offsets within packet
+ * @param numErasures  Number of offsets
+ * @return             0 on success, -1 on error
+ */
+int meshxt_parse_packet_erasures(const uint8_t *packet, size_t packetLen, const uint8_t *erasures,
+                                 size_t numErasures, MeshXTParseResult *result);
+
+/**
+ * Check the header and FEC-correct the payload in place, without
+ * decompressing. The payload starts at packet + MESHXT_HEADER_SIZE.
+ *
+ * @param packet     Packet bytes (modified: FEC repairs applied in place)
+ * @param packetLen  Length of packet
+ * @param info       Packet metadata (messageLen is left 0)
+ * @return           Payload length, or -1 on error
+ */
+int meshxt_packet_decode_fec(uint8_t *packet, size_t packetLen, MeshXTPacketInfo *info);
+
+// meshxt_packet_check results
+#define MESHXT_CHECK_INVALID  -1  // bad header/layout, or certainly uncorrectable
+#define MESHXT_CHECK_CLEAN     0  // header valid; parity clean (or not checked)
+#define MESHXT_CHECK_DAMAGED   1  // parity shows errors within the correction capacity
+
+/**
+ * Validate a packet without decoding it, for nodes that only relay.
+ * Checks the header fields and that the length fits the FEC layout;
+ * with checkParity, also runs meshxt_fec_check over the codewords.
+ * The packet is not modified.
+ *
+ * @return  MESHXT_CHECK_*
+ */
+int meshxt_packet_check(const uint8_t *packet, size_t packetLen, bool checkParity);
+
+/**
+ * Zero-copy parse for callers that own a mutable copy of the packet.
+ *
+ * FEC-corrects the payload in place inside `packet` and decompresses it
+ * straight into `text`, which can be the destination packet's payload
+ * buffer. Uses no large stack buffers. `text` is only written when the
+ * whole packet decodes successfully.
+ *
+ * @param packet     Packet bytes (modified: FEC repairs applied in place)
+ * @param packetLen  Length of packet
+ * @param text       Output text buffer (null-terminated)
+ * @param textSize   Size of text buffer
+ * @param info       Packet metadata (may be NULL)
+ * @return           Text length (excluding null), or -1 on error
+ */
+int meshxt_parse_packet_inplace(uint8_t *packet, size_t packetLen, char *text, size_t textSize,
+                                MeshXTPacketInfo *info);
+
+/**
+ * Streaming parse: like meshxt_parse_packet_inplace, but decoded text is
+ * delivered to `sink` in chunks (see meshxt_decompress_stream), so the
+ * caller decides where bytes go and no text buffer is needed at all.
+ *
+ * @param packet     Packet bytes (modified: FEC repairs applied in place)
+ * @param packetLen  Length of packet
+ * @param sink       Receives the decoded text in order
+ * @param ctx        Passed to sink
+ * @param info       Packet metadata (may be NULL)
+ * @return           Text length, or -1 on error or sink abort
+ */
+int meshxt_parse_packet_stream(uint8_t *packet, size_t packetLen, MeshXTTextSink sink, void *ctx,
+                               MeshXTPacketInfo *info);
+
+// meshxt_parse_history_packet results besides a text length or -1
+#define MESHXT_HISTORY_DESYNC -2  // coded against a history this receiver does not have
+#define MESHXT_HISTORY_RESYNC -3  // a resync request (info->messageLen = its checksum)
+
+/**
+ * Parse a packet of any compression type, using `history` for compType 6.
+ * Like meshxt_parse_packet_inplace, the packet is FEC-corrected in place
+ * and `text` is only written on success. The history is not updated;
+ * the caller appends the text once it has accepted the message.
+ *
+ * @param packet     Packet bytes (modified: FEC repairs applied in place)
+ * @param packetLen  Length of packet
+ * @param history    Receive history of the conversation (NULL = none)
+ * @param text       Output text buffer (null-terminated)
+ * @param textSize   Size of text buffer
+ * @param info       Packet metadata (may be NULL)
+ * @return           Text length, -1 on error, or MESHXT_HISTORY_DESYNC /
+ *                   MESHXT_HISTORY_RESYNC
+ */
+int meshxt_parse_history_packet(uint8_t *packet, size_t packetLen, const MeshXTHistory *history, char *text,
+                                size_t textSize, MeshXTPacketInfo *info);
+
+/**
+ * Second half of meshxt_parse_history_packet, for a packet already through
+ * meshxt_packet_decode_fec, so callers can time or account for the FEC
+ * and decompression stages separately.
+ *
+ * @param packet      Packet bytes after meshxt_packet_decode_fec
+ * @param payloadLen  Its return value
+ * @param info        Its info (messageLen is set)
+ * @return            As meshxt_parse_history_packet
+ */
+int meshxt_packet_decompress(const uint8_t *packet, int payloadLen, const MeshXTHistory *history, char *text,
+                             size_t textSize, MeshXTPacketInfo *info);
+
 /**
  * Get the number of FEC parity bytes for a given level code.
  */
 uint8_t meshxt_fec_nsym_from_code(uint8_t fecCode);
+
+/**
+ * Parity for a payload in ratio mode: the level's full-frame parity per
+ * payload byte applied to payloadLen, rounded up to a multiple of
+ * MESHXT_FEC_STEP and kept within [MESHXT_FEC_STEP, level nsym].
+ * E.g. a 12-byte payload at low gets 4 parity bytes instead of 16.
+ *
+ * @return  Parity symbols, or 0 for FEC none / unknown codes
+ */
+uint8_t meshxt_fec_ratio_nsym(uint8_t fecCode, size_t payloadLen);
+
+// ---------------------------------------------------------------------------
+// Fixed-format packets
+// ---------------------------------------------------------------------------
+
+namespace MeshXT {
+
+/**
+ * Packets of one compression type and one FEC level, fixed at compile
+ * time: no type or level switches and parity from MeshXT::RS<>. The wire
+ * format is that of meshxt_create_packet(message, out, COMP, FEC), and
+ * parse() falls back to meshxt_parse_packet_inplace for any other header,
+ * so a gateway on one format still reads everything.
+ *
+ *   typedef MeshXT::Packet<MESHXT_COMP_ENTROPY, MESHXT_FEC_LOW_CODE> Uplink;
+ *   int n = Uplink::create("On my way", frame);
+ */
+template <uint8_t COMP, uint8_t FEC>
+struct Packet {
+    static_assert(COMP == MESHXT_COMP_NONE || COMP == MESHXT_COMP_SMAZ || COMP == MESHXT_COMP_CODEBOOK ||
+                      COMP == MESHXT_COMP_ENTROPY,
+                  "MeshXT::Packet takes the stateless compression types none, smaz, codebook and entropy");
+    static_assert(FEC <= MESHXT_FEC_HIGH_CODE, "MeshXT::Packet takes FEC none, low, medium or high");
+
+    static constexpr uint8_t nsym = FEC == MESHXT_FEC_LOW_CODE      ? MESHXT_FEC_LOW
+                                    : FEC == MESHXT_FEC_MEDIUM_CODE ? MESHXT_FEC_MEDIUM
+                                    : FEC == MESHXT_FEC_HIGH_CODE   ? MESHXT_FEC_HIGH
+                                                                    : 0;
+    static constexpr size_t maxPayload = MESHXT_MAX_PACKET_SIZE - MESHXT_HEADER_SIZE - nsym;
+
+    typedef RS<nsym ? nsym : MESHXT_FEC_LOW> Codec;  // Not called when FEC is none
+
+    /** As meshxt_create_packet(message, output, COMP, FEC). */
+    static int create(const char *message, uint8_t *output) {
+        uint8_t *payload = output + MESHXT_HEADER_SIZE;
+        int payloadLen;
+        switch (COMP) {
+            case MESHXT_COMP_SMAZ:     payloadLen = meshxt_compress(message, payload, maxPayload); break;
+            case MESHXT_COMP_ENTROPY:  payloadLen = meshxt_compress_entropy(message, payload, maxPayload); break;
+            case MESHXT_COMP_CODEBOOK: payloadLen = meshxt_codebook_match(message, payload, maxPayload); break;
+            default:
+                payloadLen = (int)strlen(message);
+                if (payloadLen > (int)maxPayload) return -1;
+                memcpy(payload, message, payloadLen);
+                break;
+        }
+        if (payloadLen < 0) return -1;
+
+        int fecLen = payloadLen;
+        if (nsym > 0) {
+            fecLen = Codec::encode(payload, payloadLen, payload);
+            if (fecLen < 0) return -1;
+        }
+
+        output[0] = (uint8_t)((MESHXT_PACKET_VERSION << 4) | COMP);
+        output[1] = (uint8_t)(FEC << 4);
+        return MESHXT_HEADER_SIZE + fecLen;
+    }
+
+    /**
+     * As meshxt_parse_packet_inplace: FEC repairs are applied to packet
+     * and text is only written on success.
+     */
+    static int parse(uint8_t *packet, size_t packetLen, char *text, size_t textSize, MeshXTPacketInfo *info = NULL) {
+        if (packetLen < MESHXT_HEADER_SIZE || packet[0] != ((MESHXT_PACKET_VERSION << 4) | COMP) ||
+            packet[1] != (FEC << 4)) {
+            return meshxt_parse_packet_inplace(packet, packetLen, text, textSize, info);
+        }
+
+        uint8_t *payload = packet + MESHXT_HEADER_SIZE;
+        int payloadLen = (int)(packetLen - MESHXT_HEADER_SIZE);
+        int corrected = 0;
+        if (nsym > 0) {
+            payloadLen = Codec::decode(payload, payloadLen, payload, &corrected);
+            if (payloadLen < 0) return -1;
+        }
+
+        int textLen;
+        switch (COMP) {
+            case MESHXT_COMP_SMAZ:
+                textLen = meshxt_decompressed_len(payload, payloadLen);
+                if (textLen < 0 || textLen >= (int)textSize) return -1;
+                textLen = meshxt_decompress(payload, payloadLen, text, textSize);
+                break;
+            case MESHXT_COMP_ENTROPY:
+                textLen = meshxt_decompressed_len_entropy(payload, payloadLen);
+                if (textLen < 0 || textLen >= (int)textSize) return -1;
+                textLen = meshxt_decompress_entropy(payload, payloadLen, text, textSize);
+                break;
+            case MESHXT_COMP_CODEBOOK:
+                textLen = meshxt_codebook_decode(payload, payloadLen, text, textSize);
+                break;
+            default:
+                if (payloadLen >= (int)textSize) return -1;
+                memmove(text, payload, payloadLen);
+                text[payloadLen] = '\0';
+                textLen = payloadLen;
+                break;
+        }
+        if (textLen < 0) return -1;
+
+        if (info) {
+            info->header.version = MESHXT_PACKET_VERSION;
+            info->header.compType = COMP;
+            info->header.fecLevel = FEC;
+            info->header.flags = 0;
+            info->messageLen = textLen;
+            info->packetSize = (int)packetLen;
+            info->payloadSize = payloadLen;
+            info->fecCorrected = corrected;
+        }
+        return textLen;
+    }
+};
+
+} // namespace MeshXT
@@ -0,0 +1,28 @@
+#include "MeshXTQueue.h"
+
+static_assert((MESHXT_QUEUE_SIZE & (MESHXT_QUEUE_SIZE - 1)) == 0, "MESHXT_QUEUE_SIZE must be a power of two");
+
+void meshxt_queue_init(MeshXTQueue *q) {
+    for (size_t i = 0; i < MESHXT_QUEUE_SIZE; i++) q->slots[i] = NULL;
+    q->head.store(0, std::memory_order_relaxed);
+    q->tail.store(0, std::memory_order_relaxed);
+}
+
+bool meshxt_queue_push(MeshXTQueue *q, void *item) {
+    // The counters run freely and wrap; the size divides 2^32
+    uint32_t tail = q->tail.load(std::memory_order_relaxed);
+    if (tail - q->head.load(std::memory_order_acquire) >= MESHXT_QUEUE_SIZE) return false;
+
+    q->slots[tail & (MESHXT_QUEUE_SIZE - 1)] = item;
+    q->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+void *meshxt_queue_pop(MeshXTQueue *q) {
+    uint32_t head = q->head.load(std::memory_order_relaxed);
+    if (head == q->tail.load(std::memory_order_acquire)) return NULL;
+
+    void *item = q->slots[head & (MESHXT_QUEUE_SIZE - 1)];
+    q->head.store(head + 1, std::memory_order_release);
+    return item;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Queue — lock-free single-producer / single-consumer ring
+ *
+ * Hands pointers between exactly two threads, e.g. the radio thread and
+ * the codec worker, one queue per direction. Only the producer writes
+ * `tail` and only the consumer writes `head`; release / acquire ordering
+ * on them makes whatever the producer wrote into an item visible to the
+ * consumer before it can pop it. No locks, no allocation, and safe
+ * across the two cores of an ESP32.
+ */
+
+#define MESHXT_QUEUE_SIZE 8  // slots; must be a power of two
+
+typedef struct {
+    void *slots[MESHXT_QUEUE_SIZE];
+    std::atomic<uint32_t> head;  // Items popped so far, written by the consumer
+    std::atomic<uint32_t> tail;  // Items pushed so far, written by the producer
+} MeshXTQueue;
+
+/** Empty a queue. Not thread-safe: call before either side uses it. */
+void meshxt_queue_init(MeshXTQueue *q);
+
+/**
+ * Producer side: append an item.
+ *
+ * @return  false if the queue is full
+ */
+bool meshxt_queue_push(MeshXTQueue *q, void *item);
+
+/**
+ * Consumer side: take the oldest item.
+ *
+ * @return  The item, or NULL if the queue is empty
+ */
+void *meshxt_queue_pop(MeshXTQueue *q);
@@ -0,0 +1,130 @@
+#include "MeshXTStats.h"
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Arduino.h>
+#define CYCLE_UNIT "cycles"
+void meshxt_cycles_init(void) {}
+uint32_t meshxt_cycles(void) { return ESP.getCycleCount(); }
+#elif defined(ARDUINO_ARCH_NRF52) || defined(NRF52_SERIES)
+#include <nrf.h>
+#define CYCLE_UNIT "cycles"
+void meshxt_cycles_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+uint32_t meshxt_cycles(void) { return DWT->CYCCNT; }
+#else
+#include <chrono>
+#define CYCLE_UNIT "ns"
+void meshxt_cycles_init(void) {}
+uint32_t meshxt_cycles(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+const char *meshxt_cycles_unit(void) {
+    return CYCLE_UNIT;
+}
+
+void meshxt_stats_reset(MeshXTStats *s) {
+    memset(s, 0, sizeof(MeshXTStats));
+    meshxt_cycles_init();
+}
+
+void meshxt_stats_stage(MeshXTStats *s, uint8_t stage, uint32_t cycles) {
+    if (stage >= MESHXT_STAGE_COUNT) return;
+    MeshXTStageStats *st = &s->stages[stage];
+
+    int bucket = 0;
+    for (uint32_t limit = 1024; bucket < MESHXT_STATS_BUCKETS - 1 && cycles >= limit; limit <<= 2) bucket++;
+
+    st->count++;
+    st->totalCycles += cycles;
+    if (cycles > st->maxCycles) st->maxCycles = cycles;
+    st->buckets[bucket]++;
+}
+
+// ---------------------------------------------------------------------------
+// Report
+// ---------------------------------------------------------------------------
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static const uint8_t *get32(const uint8_t *p, uint32_t *v) {
+    *v = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    return p + 4;
+}
+
+int meshxt_stats_serialize(const MeshXTStats *s, uint8_t *out, size_t outSize) {
+    if (outSize < MESHXT_STATS_REPORT_SIZE) return -1;
+
+    int64_t savedMs = s->airtimeSavedUs / 1000;
+    if (savedMs > INT32_MAX) savedMs = INT32_MAX;
+    if (savedMs < INT32_MIN) savedMs = INT32_MIN;
+
+    uint8_t *p = out;
+    *p++ = MESHXT_STATS_VERSION;
+    p = put32(p, s->packetsEncoded);
+    p = put32(p, s->packetsDecoded);
+    p = put32(p, s->textBytesSent);
+    p = put32(p, s->frameBytesSent);
+    p = put32(p, s->frameBytesReceived);
+    p = put32(p, s->textBytesReceived);
+    p = put32(p, s->fecSymbolsCorrected);
+    p = put32(p, s->fecPacketsCorrected);
+    p = put32(p, s->uncorrectable);
+    p = put32(p, s->decodeFailures);
+    p = put32(p, s->uptimeMs);
+    p = put32(p, (uint32_t)(int32_t)savedMs);
+
+    for (int i = 0; i < MESHXT_STAGE_COUNT; i++) {
+        const MeshXTStageStats *st = &s->stages[i];
+        p = put32(p, st->count);
+        p = put32(p, st->count ? (uint32_t)(st->totalCycles / st->count) : 0);
+        p = put32(p, st->maxCycles);
+        for (int b = 0; b < MESHXT_STATS_BUCKETS; b++)
+            *p++ = st->count ? (uint8_t)(((uint64_t)st->buckets[b] * 255 + st->count / 2) / st->count) : 0;
+    }
+    return (int)(p - out);
+}
+
+int meshxt_stats_parse(const uint8_t *in, size_t len, MeshXTStats *s) {
+    if (len != MESHXT_STATS_REPORT_SIZE || in[0] != MESHXT_STATS_VERSION) return -1;
+    memset(s, 0, sizeof(MeshXTStats));
+
+    uint32_t savedMs;
+    const uint8_t *p = in + 1;
+    p = get32(p, &s->packetsEncoded);
+    p = get32(p, &s->packetsDecoded);
+    p = get32(p, &s->textBytesSent);
+    p = get32(p, &s->frameBytesSent);
+    p = get32(p, &s->frameBytesReceived);
+    p = get32(p, &s->textBytesReceived);
+    p = get32(p, &s->fecSymbolsCorrected);
+    p = get32(p, &s->fecPacketsCorrected);
+    p = get32(p, &s->uncorrectable);
+    p = get32(p, &s->decodeFailures);
+    p = get32(p, &s->uptimeMs);
+    p = get32(p, &savedMs);
+    s->airtimeSavedUs = (int64_t)(int32_t)savedMs * 1000;
+
+    for (int i = 0; i < MESHXT_STAGE_COUNT; i++) {
+        MeshXTStageStats *st = &s->stages[i];
+        uint32_t mean;
+        p = get32(p, &st->count);
+        p = get32(p, &mean);
+        p = get32(p, &st->maxCycles);
+        st->totalCycles = (uint64_t)mean * st->count;
+        for (int b = 0; b < MESHXT_STATS_BUCKETS; b++)
+            st->buckets[b] = (uint32_t)(((uint64_t)*p++ * st->count + 127) / 255);
+    }
+    return 0;
+}
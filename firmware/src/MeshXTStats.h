@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * MeshXT Statistics — counters and per-stage timing histograms
+ *
+ * Kept by the module on every TX and RX so compression efficiency and
+ * decode health can be read without verbose logging. A report can be
+ * requested over the air (MESHXT_COMP_STATS, see MeshXTPacket.h) and is
+ * serialized into a fixed little-endian layout:
+ *
+ *   [version] [12 x u32 counters] [4 stages x (u32 count, u32 mean, u32 max, 8 x u8 shares)]
+ *
+ * Stage times are from meshxt_cycles(): CPU cycles on ESP32 (ccount) and
+ * nRF52 (DWT CYCCNT), nanoseconds on a host. Histogram buckets are powers
+ * of four from 1024: <1k, <4k, <16k, <64k, <256k, <1M, <4M, >=4M; the
+ * report carries each bucket's share of the count in 1/255ths.
+ */
+
+#define MESHXT_STATS_VERSION     1
+#define MESHXT_STATS_BUCKETS     8
+#define MESHXT_STATS_REPORT_SIZE (1 + 12 * 4 + MESHXT_STAGE_COUNT * (12 + MESHXT_STATS_BUCKETS))
+
+// Timed stages
+#define MESHXT_STAGE_COMPRESS   0  // all encodings tried for a message
+#define MESHXT_STAGE_FEC_ENCODE 1  // RS parity
+#define MESHXT_STAGE_FEC_DECODE 2  // syndromes, plus correction when they are not zero
+#define MESHXT_STAGE_DECOMPRESS 3
+#define MESHXT_STAGE_COUNT      4
+
+typedef struct {
+    uint32_t count;
+    uint64_t totalCycles;
+    uint32_t maxCycles;
+    uint32_t buckets[MESHXT_STATS_BUCKETS];
+} MeshXTStageStats;
+
+typedef struct {
+    uint32_t packetsEncoded;      // Frames built for TX, fragments included
+    uint32_t packetsDecoded;      // Messages decoded
+    uint32_t textBytesSent;       // Before compression
+    uint32_t frameBytesSent;      // After compression and FEC
+    uint32_t frameBytesReceived;
+    uint32_t textBytesReceived;
+    uint32_t fecSymbolsCorrected;
+    uint32_t fecPacketsCorrected; // Packets that needed at least one correction
+    uint32_t uncorrectable;       // Dropped: more errors than the parity can fix
+    uint32_t decodeFailures;      // Dropped for any other reason (bad header, missing dictionary, ...)
+    uint32_t uptimeMs;            // Time since the counters were reset (set by the owner before reporting)
+    int64_t airtimeSavedUs;       // Against sending the same texts as plain TEXT_MESSAGE_APP
+    MeshXTStageStats stages[MESHXT_STAGE_COUNT];
+} MeshXTStats;
+
+/** Enable the cycle counter (DWT on nRF52); safe to call more than once. */
+void meshxt_cycles_init(void);
+
+/** Free-running cycle counter for stage timing; wraps. */
+uint32_t meshxt_cycles(void);
+
+/** Unit of meshxt_cycles(): "cycles" or "ns". */
+const char *meshxt_cycles_unit(void);
+
+/** Zero all counters and enable the cycle counter. */
+void meshxt_stats_reset(MeshXTStats *s);
+
+/** Record one run of a stage that took `cycles`. */
+void meshxt_stats_stage(MeshXTStats *s, uint8_t stage, uint32_t cycles);
+
+/**
+ * Serialize a report (MESHXT_STATS_REPORT_SIZE bytes). Airtime saved is
+ * sent in milliseconds as a signed 32-bit value.
+ *
+ * @return  Bytes written, or -1 if outSize is too small
+ */
+int meshxt_stats_serialize(const MeshXTStats *s, uint8_t *out, size_t outSize);
+
+/**
+ * Parse a report. Stage totals are rebuilt from count x mean and the
+ * buckets from the shares, so they are approximate.
+ *
+ * @return  0 on success, -1 if malformed or of another version
+ */
+int meshxt_stats_parse(const uint8_t *in, size_t len, MeshXTStats *s);
@@ -0,0 +1,164 @@
+#!/usr/bin/env node
+'use strict';
+
+/**
+ * Generates firmware/src/MeshXTEntropyModel.h, the static model of the
+ * MESHXT_COMP_ENTROPY coder, from a chat corpus (one message per line):
+ *
+ *   node firmware/tools/gen-entropy-model.js [corpus.txt]
+ *
+ * Each message is parsed into built-in codebook symbols, escaped literal
+ * bytes and an end symbol, with the context of every symbol being the
+ * class of the character before it (see entropy_context() in
+ * MeshXTEntropy.cpp, mirrored by contextOf below). The parse and the model
+ * are refined together for a few rounds, as the firmware parses with the
+ * model's costs. Frequencies are blended with the context-free counts and
+ * scaled to 2^15 per context, every symbol keeping at least 1.
+ *
+ * Every fifth message is held out of training and used to report the
+ * expected size against Smaz.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { CODEBOOK, compress } = require('../../src/compress');
+
+const CONTEXTS = 8;
+const PROB_BITS = 15;
+const TOTAL = 1 << PROB_BITS;
+const SYM_ESCAPE = 254;
+const SYM_END = 255;
+const ROUNDS = 4;
+const BLEND = 8;  // weight of the context-free distribution, in samples
+
+// Must match entropy_context() in MeshXTEntropy.cpp
+function contextOf(prev) {
+  if (prev < 0) return 0;                       // start of message
+  if (prev === 0x20) return 1;                  // space
+  if ('aeiou'.includes(String.fromCharCode(prev))) return 2;
+  if (prev >= 0x61 && prev <= 0x7A) return 3;   // other lowercase
+  if (prev >= 0x41 && prev <= 0x5A) return 4;   // uppercase
+  if (prev >= 0x30 && prev <= 0x39) return 5;   // digit
+  if (prev === 0x2E || prev === 0x21 || prev === 0x3F) return 6;  // . ! ?
+  return 7;                                     // other punctuation, non-ASCII
+}
+
+const entries = CODEBOOK.map(e => Buffer.from(e, 'latin1'));
+
+/** Cheapest symbol sequence for a message under the given costs. */
+function parse(buf, symCost, litCost) {
+  const n = buf.length;
+  const ctx = (i) => contextOf(i > 0 ? buf[i - 1] : -1);
+  const best = new Array(n + 1).fill(Infinity);
+  const step = new Array(n + 1);
+  best[n] = symCost(ctx(n), SYM_END);
+
+  for (let i = n - 1; i >= 0; i--) {
+    const c = ctx(i);
+    entries.forEach((e, sym) => {
+      if (i + e.length > n || !buf.subarray(i, i + e.length).equals(e)) return;
+      const cost = symCost(c, sym) + best[i + e.length];
+      if (cost < best[i]) { best[i] = cost; step[i] = [sym, e.length]; }
+    });
+    const cost = symCost(c, SYM_ESCAPE) + litCost(c, buf[i]) + best[i + 1];
+    if (cost < best[i]) { best[i] = cost; step[i] = [SYM_ESCAPE, 1]; }
+  }
+
+  const out = [];
+  for (let i = 0; i < n; i += step[i][1]) out.push({ ctx: ctx(i), sym: step[i][0], byte: buf[i] });
+  out.push({ ctx: ctx(n), sym: SYM_END });
+  return { symbols: out, bits: best[0] };
+}
+
+/** Per-context probabilities, blended with the context-free ones. */
+function blend(counts, prior) {
+  const all = new Array(256).fill(0);
+  for (const c of counts) c.forEach((v, s) => { all[s] += v; });
+  const allN = all.reduce((a, b) => a + b, 0);
+  const p0 = all.map((v, s) => (v + prior[s]) / (allN + prior.reduce((a, b) => a + b, 0)));
+  return counts.map(c => {
+    const n = c.reduce((a, b) => a + b, 0);
+    return c.map((v, s) => (v + BLEND * p0[s]) / (n + BLEND));
+  });
+}
+
+/** Integer frequencies summing to TOTAL, each at least 1. */
+function quantize(p) {
+  const f = p.map(x => Math.max(1, Math.round(x * TOTAL)));
+  const largest = f.indexOf(Math.max(...f));
+  f[largest] += TOTAL - f.reduce((a, b) => a + b, 0);
+  return f;
+}
+
+function train(messages) {
+  // Unseen symbols: a little mass, more for printable literal bytes
+  const symPrior = new Array(256).fill(0.1);
+  const litPrior = Array.from({ length: 256 }, (_, b) => (b >= 0x20 && b < 0x7F ? 0.5 : 0.02));
+
+  let symCost = () => 8;
+  let litCost = () => 8;
+  let model;
+  for (let round = 0; round < ROUNDS; round++) {
+    const sym = Array.from({ length: CONTEXTS }, () => new Array(256).fill(0));
+    const lit = Array.from({ length: CONTEXTS }, () => new Array(256).fill(0));
+    for (const m of messages) {
+      for (const s of parse(Buffer.from(m, 'utf8'), symCost, litCost).symbols) {
+        sym[s.ctx][s.sym]++;
+        if (s.sym === SYM_ESCAPE) lit[s.ctx][s.byte]++;
+      }
+    }
+    model = { sym: blend(sym, symPrior).map(quantize), lit: blend(lit, litPrior).map(quantize) };
+    symCost = (c, s) => Math.log2(TOTAL / model.sym[c][s]);
+    litCost = (c, b) => Math.log2(TOTAL / model.lit[c][b]);
+  }
+  return { model, symCost, litCost };
+}
+
+function cumulative(freqs) {
+  const cum = [0];
+  for (const f of freqs) cum.push(cum[cum.length - 1] + f);
+  return cum;
+}
+
+function table(name, rows) {
+  const body = rows.map(freqs => {
+    const cum = cumulative(freqs);
+    const lines = [];
+    for (let i = 0; i < cum.length; i += 12) lines.push('        ' + cum.slice(i, i + 12).join(', ') + ',');
+    return '    {\n' + lines.join('\n') + '\n    },';
+  });
+  return `static constexpr uint16_t ${name}[MESHXT_ENTROPY_CONTEXTS][257] = {\n${body.join('\n')}\n};\n`;
+}
+
+const corpusPath = process.argv[2] || path.join(__dirname, 'chat-corpus.txt');
+const messages = fs.readFileSync(corpusPath, 'utf8').split(/\r?\n/).filter(m => m.length > 0);
+const trainSet = messages.filter((_, i) => i % 5 !== 0);
+const heldOut = messages.filter((_, i) => i % 5 === 0);
+
+const { model, symCost, litCost } = train(trainSet);
+
+let original = 0;
+let smaz = 0;
+let entropy = 0;
+for (const m of heldOut) {
+  original += Buffer.byteLength(m, 'utf8');
+  smaz += compress(m).length;
+  entropy += Math.ceil(parse(Buffer.from(m, 'utf8'), symCost, litCost).bits / 8);
+}
+
+const out = `#pragma once
+
+// Generated by firmware/tools/gen-entropy-model.js from ${path.basename(corpusPath)}; do not edit.
+// ${trainSet.length} training messages. Held out (${heldOut.length}): ${original} bytes, ` +
+  `Smaz ${smaz}, entropy ~${entropy}.
+//
+// Cumulative frequencies (total 2^${PROB_BITS}) per context: codebook symbols
+// 0..253, escape (254) and end of message (255); then escaped literal bytes.
+
+#include <stdint.h>
+
+${table('ENTROPY_SYM_CUM', model.sym)}
+${table('ENTROPY_LIT_CUM', model.lit)}`;
+
+fs.writeFileSync(path.join(__dirname, '..', 'src', 'MeshXTEntropyModel.h'), out);
+console.log(`Held out: ${original} bytes, Smaz ${smaz}, entropy ~${entropy}`);
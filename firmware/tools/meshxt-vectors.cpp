@@ -0,0 +1,497 @@
+/**
+ * Test vectors from the firmware C++ core, for comparing it with the JS
+ * implementation (test/differential.js). One input per line on stdin,
+ * one result per line on stdout: "ok <value>" or "err".
+ *
+ *   meshxt-vectors encode <comp> <fec>    text -> packet (hex)
+ *   meshxt-vectors decode                 packet (hex) -> text
+ *   meshxt-vectors fec-encode <fec>       data (hex) -> data + parity (hex)
+ *   meshxt-vectors fec-decode <fec>       codeword (hex) -> corrected data (hex)
+ *   meshxt-vectors roundtrip <check>      text -> text, through encode, damage and decode
+ *
+ * comp: none, smaz, codebook, entropy; fec: none, low, medium, high.
+ * A round trip prints the text back only if every step of the check
+ * holds; anything else is "err". Damage comes from a fixed-seed
+ * generator, so a failing line reproduces. Checks:
+ *
+ *   rs    each FEC level with exactly nsym/2 byte errors, and fecCorrected
+ *         reporting all of them
+ *   interleave  depths 2-4 with one burst of depth * nsym/2 bytes, which a
+ *         single codeword at the same level must fail to correct
+ *   ratio  MESHXT_FEC_RATIO at each level: a SHORT header whose parity is
+ *         meshxt_fec_ratio_nsym of the payload, correcting nsym/2 errors
+ *   erasures  e unknown errors plus f hinted erasures with 2e + f = nsym,
+ *         for e = 0, nsym/2 and one in between
+ *   fragment  the text repeated to 500 bytes and split with 50% repair; up
+ *         to m fragments dropped, the rest shuffled and damaged
+ *   entropy  meshxt_compress_entropy through the length, buffered and
+ *         streamed decoders, then in packets with nsym/2 errors
+ *   history  the corpus as one conversation, each line coded against the
+ *         lines before it, with byte errors; an empty history must see a
+ *         desync
+ *   batch  the text in a batch with short companions, each part at a
+ *         random compression type, framed at a random level with nsym/2
+ *         errors and split again in order
+ * Built without MESHTASTIC_FIRMWARE, e.g.
+ *
+ *   g++ -std=c++17 -O2 -Ifirmware/src -o meshxt-vectors firmware/tools/meshxt-vectors.cpp \
+ *       firmware/src/MeshXT{Compress,Codebook,Entropy,History,FEC,Packet,Fragment}.cpp
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MeshXTEntropy.h"
+#include "MeshXTFEC.h"
+#include "MeshXTFragment.h"
+#include "MeshXTHistory.h"
+#include "MeshXTPacket.h"
+
+static int comp_code(const char *name) {
+    if (!strcmp(name, "none")) return MESHXT_COMP_NONE;
+    if (!strcmp(name, "smaz")) return MESHXT_COMP_SMAZ;
+    if (!strcmp(name, "codebook")) return MESHXT_COMP_CODEBOOK;
+    if (!strcmp(name, "entropy")) return MESHXT_COMP_ENTROPY;
+    return -1;
+}
+
+static int fec_code(const char *name) {
+    if (!strcmp(name, "none")) return MESHXT_FEC_NONE_CODE;
+    if (!strcmp(name, "low")) return MESHXT_FEC_LOW_CODE;
+    if (!strcmp(name, "medium")) return MESHXT_FEC_MEDIUM_CODE;
+    if (!strcmp(name, "high")) return MESHXT_FEC_HIGH_CODE;
+    return -1;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/** Parse hex into out; returns the byte count, or -1. */
+static int from_hex(const char *s, uint8_t *out, size_t outSize) {
+    size_t n = strlen(s);
+    if (n % 2 || n / 2 > outSize) return -1;
+    for (size_t i = 0; i < n / 2; i++) {
+        int hi = hex_value(s[2 * i]), lo = hex_value(s[2 * i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return (int)(n / 2);
+}
+
+static void print_hex(const uint8_t *data, int len) {
+    fputs("ok ", stdout);
+    for (int i = 0; i < len; i++) printf("%02x", data[i]);
+    putchar('\n');
+}
+
+static void print_err(void) {
+    puts("err");
+}
+
+static int usage(void) {
+    fprintf(stderr, "usage: meshxt-vectors encode <comp> <fec> | decode | fec-encode <fec> | fec-decode <fec>"
+                    " | roundtrip <check>\n");
+    return 2;
+}
+
+// ---------------------------------------------------------------------------
+// Round trips
+// ---------------------------------------------------------------------------
+
+// Fixed seed, the same generator as test/differential.js
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/** Flip `count` distinct bytes in [start, end). */
+static void corrupt(uint8_t *buf, size_t start, size_t end, int count) {
+    bool hit[MESHXT_MAX_PACKET_SIZE] = {};
+    for (int done = 0; done < count && (size_t)done < end - start;) {
+        size_t pos = start + rng() % (end - start);
+        if (hit[pos]) continue;
+        hit[pos] = true;
+        buf[pos] ^= (uint8_t)(1 + rng() % 255);
+        done++;
+    }
+}
+
+/** Every level the text fits at, with as many errors as it corrects. */
+static bool roundtrip_rs(const char *text) {
+    for (uint8_t fec = MESHXT_FEC_LOW_CODE; fec <= MESHXT_FEC_HIGH_CODE; fec++) {
+        uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+        int n = meshxt_create_packet(text, packet, MESHXT_COMP_SMAZ, fec);
+        if (n < 0) continue;  // too long for this level
+
+        int errors = meshxt_fec_nsym_from_code(fec) / 2;
+        corrupt(packet, MESHXT_HEADER_SIZE, (size_t)n, errors);
+        MeshXTParseResult result;
+        if (meshxt_parse_packet(packet, (size_t)n, &result) != 0) return false;
+        if (strcmp(result.message, text) != 0 || result.fecCorrected != errors) return false;
+    }
+    return true;
+}
+
+/** Damage `len` contiguous bytes somewhere after the header. */
+static void burst(uint8_t *packet, size_t packetLen, size_t len) {
+    size_t start = MESHXT_HEADER_SIZE + rng() % (packetLen - MESHXT_HEADER_SIZE - len + 1);
+    for (size_t i = 0; i < len; i++) packet[start + i] ^= (uint8_t)(1 + rng() % 255);
+}
+
+/** Bursts that only interleaving makes correctable. */
+static bool roundtrip_interleave(const char *text) {
+    for (uint8_t fec = MESHXT_FEC_LOW_CODE; fec <= MESHXT_FEC_HIGH_CODE; fec++) {
+        for (uint8_t depth = 2; depth <= 4; depth++) {
+            uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+            int n = meshxt_create_packet(text, packet, MESHXT_COMP_SMAZ, fec | MESHXT_FEC_DEPTH(depth));
+            if (n < 0) continue;  // too long, or shorter than depth
+
+            size_t len = (size_t)depth * meshxt_fec_nsym_from_code(fec) / 2;
+            burst(packet, (size_t)n, len);
+            MeshXTParseResult result;
+            if (meshxt_parse_packet(packet, (size_t)n, &result) != 0) return false;
+            if (strcmp(result.message, text) != 0 || result.fecCorrected != (int)len) return false;
+
+            n = meshxt_create_packet(text, packet, MESHXT_COMP_SMAZ, fec);
+            if (n < 0 || (size_t)n < MESHXT_HEADER_SIZE + len) continue;
+            burst(packet, (size_t)n, len);
+            if (meshxt_parse_packet(packet, (size_t)n, &result) == 0 && !strcmp(result.message, text)) return false;
+        }
+    }
+    return true;
+}
+
+/** Ratio-mode frames: parity sized to the payload, and still correcting. */
+static bool roundtrip_ratio(const char *text) {
+    for (uint8_t fec = MESHXT_FEC_LOW_CODE; fec <= MESHXT_FEC_HIGH_CODE; fec++) {
+        uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+        int n = meshxt_create_packet(text, packet, MESHXT_COMP_SMAZ, fec | MESHXT_FEC_RATIO);
+        if (n < 0) continue;
+
+        if (packet[1] >> 4 != MESHXT_FEC_SHORT_CODE) return false;
+        int nsym = ((packet[1] & 0x0F) + 1) * MESHXT_FEC_STEP;
+        int payloadLen = n - MESHXT_HEADER_SIZE - nsym;
+        if (payloadLen <= 0 || nsym != meshxt_fec_ratio_nsym(fec, (size_t)payloadLen)) return false;
+
+        corrupt(packet, MESHXT_HEADER_SIZE, (size_t)n, nsym / 2);
+        MeshXTParseResult result;
+        if (meshxt_parse_packet(packet, (size_t)n, &result) != 0) return false;
+        if (strcmp(result.message, text) != 0 || result.fecCorrected != nsym / 2) return false;
+        if (result.payloadSize != payloadLen) return false;
+    }
+    return true;
+}
+
+/** Errors and erasures together, exactly at the level's capacity. */
+static bool roundtrip_erasures(const char *text) {
+    for (uint8_t fec = MESHXT_FEC_LOW_CODE; fec <= MESHXT_FEC_HIGH_CODE; fec++) {
+        int nsym = meshxt_fec_nsym_from_code(fec);
+        const int errorCounts[] = {0, 1 + (int)(rng() % (nsym / 2 - 1)), nsym / 2};
+        for (int errors : errorCounts) {
+            uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+            int n = meshxt_create_packet(text, packet, MESHXT_COMP_SMAZ, fec);
+            if (n < 0) break;
+
+            // The first `erased` distinct positions are hinted, the rest are not
+            int erased = nsym - 2 * errors;
+            uint8_t positions[MESHXT_MAX_PACKET_SIZE];
+            bool hit[MESHXT_MAX_PACKET_SIZE] = {};
+            for (int count = 0; count < erased + errors;) {
+                size_t pos = MESHXT_HEADER_SIZE + rng() % ((size_t)n - MESHXT_HEADER_SIZE);
+                if (hit[pos]) continue;
+                hit[pos] = true;
+                packet[pos] ^= (uint8_t)(1 + rng() % 255);
+                positions[count++] = (uint8_t)pos;
+            }
+
+            MeshXTParseResult result;
+            if (meshxt_parse_packet_erasures(packet, (size_t)n, positions, (size_t)erased, &result) != 0) return false;
+            if (strcmp(result.message, text) != 0) return false;
+        }
+    }
+    return true;
+}
+
+// Uncompressed, so every line makes the same stripe: k = 4, m = 2
+#define FRAGMENT_TEXT_LEN 500
+#define FRAGMENT_FEC      (MESHXT_FEC_MEDIUM_CODE | MESHXT_FEC_DEPTH(3))
+#define FRAGMENT_MAX (MESHXT_FEC_MAX_CHUNKS + MESHXT_FEC_MAX_REPAIR)
+
+struct Fragments {
+    uint8_t frames[FRAGMENT_MAX][MESHXT_MAX_PACKET_SIZE];
+    size_t lens[FRAGMENT_MAX];
+    int count;
+};
+
+static int collect_fragment(const uint8_t *packet, size_t len, void *ctx) {
+    Fragments *f = (Fragments *)ctx;
+    if (f->count == FRAGMENT_MAX) return 1;
+    memcpy(f->frames[f->count], packet, len);
+    f->lens[f->count++] = len;
+    return 0;
+}
+
+/** Any k of k + m fragments, in any order, rebuild the message. */
+static bool roundtrip_fragment(const char *text) {
+    static char message[FRAGMENT_TEXT_LEN + 1];
+    size_t textLen = strlen(text), len = 0;
+    if (textLen == 0) return false;
+    while (len < FRAGMENT_TEXT_LEN) {
+        message[len] = len % (textLen + 1) == textLen ? ' ' : text[len % (textLen + 1)];
+        len++;
+    }
+    message[len] = '\0';
+
+    static uint8_t msgId = 0;
+    static Fragments f;
+    f.count = 0;
+    int total = meshxt_fragment_message(message, MESHXT_COMP_NONE, FRAGMENT_FEC, ++msgId, 50, collect_fragment, &f);
+    if (total < 2 || total != f.count) return false;
+    int k = (f.frames[0][MESHXT_HEADER_SIZE + 2] >> 4) + 1;
+    int m = total - k;
+    if (m != (k * 50 + 99) / 100) return false;
+
+    // Drop up to m, then shuffle the rest
+    int order[FRAGMENT_MAX];
+    for (int i = 0; i < total; i++) order[i] = i;
+    for (int i = total - 1; i > 0; i--) {
+        int j = (int)(rng() % (uint32_t)(i + 1)), t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    int kept = total - (int)(rng() % (uint32_t)(m + 1));
+
+    static MeshXTReassembler r;
+    meshxt_reassembler_init(&r);
+    int rebuilt = 0;
+    static char out[MESHXT_FRAG_MAX_DATA + 1];
+    for (int i = 0; i < kept; i++) {
+        uint8_t *frame = f.frames[order[i]];
+        size_t frameLen = f.lens[order[i]];
+        corrupt(frame, MESHXT_HEADER_SIZE, frameLen, 1 + (int)(rng() % (MESHXT_FEC_MEDIUM / 2)));
+
+        uint8_t *packet = NULL;
+        int n = meshxt_reassembler_add(&r, 0x1234, frame, frameLen, 0, &packet);
+        if (n < 0) return false;
+        if (n == 0) continue;
+        if (rebuilt++ || i != k - 1) return false;  // exactly once, on the k-th fragment
+        if (meshxt_parse_packet_inplace(packet, (size_t)n, out, sizeof(out), NULL) < 0) return false;
+        if (strcmp(out, message) != 0) return false;
+    }
+    return rebuilt == 1;
+}
+
+struct TextBuffer {
+    char text[1024];
+    size_t len;
+};
+
+static int append_text(const char *text, size_t len, void *ctx) {
+    TextBuffer *b = (TextBuffer *)ctx;
+    if (b->len + len >= sizeof(b->text)) return 1;
+    memcpy(b->text + b->len, text, len);
+    b->len += len;
+    b->text[b->len] = '\0';
+    return 0;
+}
+
+/** Every entropy decoder agrees with the encoder, alone and in a packet. */
+static bool roundtrip_entropy(const char *text) {
+    uint8_t coded[1024];
+    int n = meshxt_compress_entropy(text, coded, sizeof(coded));
+    if (n < 0) return false;
+
+    int len = (int)strlen(text);
+    char decoded[1024];
+    if (meshxt_decompressed_len_entropy(coded, (size_t)n) != len) return false;
+    if (meshxt_decompress_entropy(coded, (size_t)n, decoded, (size_t)len + 1) != len) return false;
+    if (strcmp(decoded, text) != 0) return false;
+    if (meshxt_decompress_entropy(coded, (size_t)n, decoded, (size_t)len) != -1) return false;  // one short
+
+    TextBuffer streamed = {};
+    if (meshxt_decompress_entropy_stream(coded, (size_t)n, append_text, &streamed) != len) return false;
+    if (strcmp(streamed.text, text) != 0) return false;
+
+    for (uint8_t fec = MESHXT_FEC_NONE_CODE; fec <= MESHXT_FEC_HIGH_CODE; fec++) {
+        uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+        int size = meshxt_create_packet(text, packet, MESHXT_COMP_ENTROPY, fec);
+        if (size < 0) continue;
+        if (size - MESHXT_HEADER_SIZE - meshxt_fec_nsym_from_code(fec) != n) return false;
+
+        corrupt(packet, MESHXT_HEADER_SIZE, (size_t)size, meshxt_fec_nsym_from_code(fec) / 2);
+        MeshXTParseResult result;
+        if (meshxt_parse_packet(packet, (size_t)size, &result) != 0) return false;
+        if (strcmp(result.message, text) != 0) return false;
+    }
+    return true;
+}
+
+/** Sender and receiver histories stay in step across the whole input. */
+static bool roundtrip_history(const char *text) {
+    static MeshXTHistory sent, received;
+    static bool started = false;
+    if (!started) {
+        meshxt_history_init(&sent);
+        meshxt_history_init(&received);
+        started = true;
+    }
+
+    uint8_t fec = MESHXT_FEC_LOW_CODE;
+    uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+    int n = meshxt_create_history_packet(text, packet, &sent, fec);
+    if (n < 0) n = meshxt_create_history_packet(text, packet, &sent, fec = MESHXT_FEC_NONE_CODE);
+    if (n < 0) return false;
+
+    uint8_t copy[MESHXT_MAX_PACKET_SIZE];
+    memcpy(copy, packet, (size_t)n);
+    MeshXTHistory empty;
+    meshxt_history_init(&empty);
+    char decoded[256];
+    int expected = sent.len > 0 ? MESHXT_HISTORY_DESYNC : (int)strlen(text);
+    if (meshxt_parse_history_packet(copy, (size_t)n, &empty, decoded, sizeof(decoded), NULL) != expected) {
+        return false;
+    }
+
+    corrupt(packet, MESHXT_HEADER_SIZE, (size_t)n, meshxt_fec_nsym_from_code(fec) / 2);
+    int len = meshxt_parse_history_packet(packet, (size_t)n, &received, decoded, sizeof(decoded), NULL);
+    if (len < 0 || strcmp(decoded, text) != 0) return false;
+
+    meshxt_history_append(&sent, text, strlen(text));
+    meshxt_history_append(&received, decoded, (size_t)len);
+    return meshxt_history_checksum(&sent) == meshxt_history_checksum(&received);
+}
+
+/** Add text to a batch at a random batchable compression type. */
+static bool batch_add_text(MeshXTBatch *batch, const char *text, uint8_t *compType) {
+    static const uint8_t types[] = {MESHXT_COMP_NONE, MESHXT_COMP_SMAZ, MESHXT_COMP_ENTROPY};
+    uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+    *compType = types[rng() % sizeof(types)];
+    int n = meshxt_create_packet(text, packet, *compType, MESHXT_FEC_NONE_CODE);
+    return n >= 0 && meshxt_batch_add(batch, packet, (size_t)n) == 0;
+}
+
+/** A batch splits back into the messages it was built from, in order. */
+static bool roundtrip_batch(const char *text) {
+    static const char *const companions[] = {
+        "On my way", "ok", "See you at 5", "Copy that", "Where are you?", "Battery low", "Sending 👍",
+    };
+    const size_t numCompanions = sizeof(companions) / sizeof(companions[0]);
+
+    const char *parts[MESHXT_BATCH_MAX_MESSAGES];
+    uint8_t types[MESHXT_BATCH_MAX_MESSAGES];
+    MeshXTBatch batch;
+    meshxt_batch_init(&batch);
+
+    // Up to three companions ahead of the text, as many as fit after it
+    size_t ahead = rng() % 4;
+    for (size_t i = 0; i < ahead; i++) {
+        parts[batch.count] = companions[i];
+        if (!batch_add_text(&batch, companions[i], &types[batch.count])) return false;
+    }
+    parts[batch.count] = text;
+    if (!batch_add_text(&batch, text, &types[batch.count])) {
+        meshxt_batch_init(&batch);
+        parts[0] = text;
+        if (!batch_add_text(&batch, text, &types[0])) {
+            // Only a text too long for any batch may be refused
+            return strlen(text) + 2 > MESHXT_BATCH_MAX_PAYLOAD;
+        }
+        ahead = 0;
+    }
+    for (size_t i = ahead; i < numCompanions && batch.count < MESHXT_BATCH_MAX_MESSAGES; i++) {
+        parts[batch.count] = companions[i];
+        if (!batch_add_text(&batch, companions[i], &types[batch.count])) break;
+    }
+
+    uint8_t fec = (uint8_t)(MESHXT_FEC_LOW_CODE + rng() % 3);
+    uint8_t packet[MESHXT_MAX_PACKET_SIZE];
+    int n = meshxt_create_batch_packet(&batch, packet, fec);
+    if (n < 0) return false;
+    corrupt(packet, MESHXT_HEADER_SIZE, (size_t)n, meshxt_fec_nsym_from_code(fec) / 2);
+
+    MeshXTPacketInfo info;
+    int payloadLen = meshxt_packet_decode_fec(packet, (size_t)n, &info);
+    if (payloadLen < 0 || info.header.compType != MESHXT_COMP_BATCH) return false;
+
+    size_t offset = 0;
+    for (uint8_t i = 0; i < batch.count; i++) {
+        char decoded[256];
+        uint8_t compType;
+        int len = meshxt_batch_next(packet + MESHXT_HEADER_SIZE, (size_t)payloadLen, &offset, decoded,
+                                    sizeof(decoded), &compType);
+        if (len < 0 || strcmp(decoded, parts[i]) != 0 || compType != types[i]) return false;
+    }
+    return offset == (size_t)payloadLen;
+}
+
+typedef bool (*RoundTrip)(const char *text);
+
+static RoundTrip roundtrip_check(const char *name) {
+    if (!strcmp(name, "rs")) return roundtrip_rs;
+    if (!strcmp(name, "interleave")) return roundtrip_interleave;
+    if (!strcmp(name, "ratio")) return roundtrip_ratio;
+    if (!strcmp(name, "erasures")) return roundtrip_erasures;
+    if (!strcmp(name, "fragment")) return roundtrip_fragment;
+    if (!strcmp(name, "entropy")) return roundtrip_entropy;
+    if (!strcmp(name, "history")) return roundtrip_history;
+    if (!strcmp(name, "batch")) return roundtrip_batch;
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) return usage();
+    const char *mode = argv[1];
+
+    int comp = 0, fec = 0;
+    RoundTrip check = NULL;
+    if (!strcmp(mode, "encode")) {
+        if (argc != 4 || (comp = comp_code(argv[2])) < 0 || (fec = fec_code(argv[3])) < 0) return usage();
+    } else if (!strcmp(mode, "fec-encode") || !strcmp(mode, "fec-decode")) {
+        if (argc != 3 || (fec = fec_code(argv[2])) <= 0) return usage();
+    } else if (!strcmp(mode, "roundtrip")) {
+        if (argc != 3 || !(check = roundtrip_check(argv[2]))) return usage();
+    } else if (strcmp(mode, "decode") != 0 || argc != 2) {
+        return usage();
+    }
+    uint8_t nsym = meshxt_fec_nsym_from_code((uint8_t)fec);
+
+    static char line[4096];
+    while (fgets(line, sizeof(line), stdin)) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        uint8_t in[1024], out[1024];
+        if (check) {
+            if (check(line)) printf("ok %s\n", line);
+            else print_err();
+        } else if (!strcmp(mode, "encode")) {
+            int n = strlen(line) <= 255 ? meshxt_create_packet(line, out, (uint8_t)comp, (uint8_t)fec) : -1;
+            if (n < 0) print_err();
+            else print_hex(out, n);
+        } else if (!strcmp(mode, "decode")) {
+            char text[256];
+            int len = from_hex(line, in, MESHXT_MAX_PACKET_SIZE);
+            int n = len < 0 ? -1 : meshxt_parse_packet_inplace(in, (size_t)len, text, sizeof(text), NULL);
+            if (n < 0) print_err();
+            else printf("ok %s\n", text);
+        } else if (!strcmp(mode, "fec-encode")) {
+            int len = from_hex(line, in, 255);
+            int n = len < 0 ? -1 : meshxt_fec_encode(in, (size_t)len, out, nsym);
+            if (n < 0) print_err();
+            else print_hex(out, n);
+        } else {
+            int len = from_hex(line, in, 255);
+            int n = len < 0 ? -1 : meshxt_fec_decode(in, (size_t)len, out, nsym);
+            if (n < 0) print_err();
+            else print_hex(out, n);
+        }
+    }
+    return 0;
+}
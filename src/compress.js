@@ -304,126 +304,148 @@ function buildTrie(codebook) {
       }
       node = node.children[ch];
     }
-    node.index = i;
+    // Duplicate entries: the lower index wins, as in the firmware
+    if (node.index < 0) node.index = i;
   }
   return root;
 }
 
-const trie = buildTrie(CODEBOOK);
-
-// Max codebook entry length (for bounds checking)
-const MAX_ENTRY_LEN = Math.max(...CODEBOOK.map(s => s.length));
-
 // ---------------------------------------------------------------------------
-// compress(text) → Buffer
+// createCodec(codebook) → { compress, decompress }
 // ---------------------------------------------------------------------------
 
 /**
- * Compress a UTF-8 text string using the MeshXT Smaz-style codebook.
+ * Build a compressor/decompressor pair for a codebook. The built-in
+ * codebook is one; trained dictionaries (see dictionary.js) are others.
+ * Entries must be non-empty; the index of an entry is its encoded byte.
  *
- * Algorithm: greedy longest-match via trie traversal.
- * Non-matching characters are accumulated and flushed as literal runs.
- *
- * @param {string} text - Input text
- * @returns {Buffer} Compressed bytes
+ * @param {string[]} codebook - Up to 254 entries
+ * @returns {{compress: function(string): Buffer, decompress: function(Buffer): string}}
  */
-function compress(text) {
-  const out = [];
-  let literalBuf = [];
-  let pos = 0;
+function createCodec(codebook) {
+  if (codebook.length > LITERAL_MARKER) throw new Error(`Codebook has ${codebook.length} entries, max ${LITERAL_MARKER}`);
 
-  function flushLiterals() {
-    while (literalBuf.length > 0) {
-      const chunk = literalBuf.splice(0, 255);
-      out.push(LITERAL_MARKER);
-      out.push(chunk.length);
-      for (const b of chunk) out.push(b);
-    }
-  }
+  const trie = buildTrie(codebook);
 
-  while (pos < text.length) {
-    // Try longest match in trie
-    let node = trie;
-    let bestIndex = -1;
-    let bestLen = 0;
+  // Max codebook entry length (for bounds checking)
+  const maxEntryLen = Math.max(...codebook.map(s => s.length));
 
-    for (let i = 0; pos + i < text.length && i < MAX_ENTRY_LEN; i++) {
-      const ch = text[pos + i];
-      if (!node.children[ch]) break;
-      node = node.children[ch];
-      if (node.index >= 0) {
-        bestIndex = node.index;
-        bestLen = i + 1;
+  /**
+   * Compress a UTF-8 text string using the MeshXT Smaz-style codebook.
+   *
+   * Algorithm: greedy longest-match via trie traversal.
+   * Non-matching characters are accumulated and flushed as literal runs.
+   *
+   * @param {string} text - Input text
+   * @returns {Buffer} Compressed bytes
+   */
+  function compress(text) {
+    const out = [];
+    let literalBuf = [];
+    let pos = 0;
+
+    function flushLiterals() {
+      while (literalBuf.length > 0) {
+        const chunk = literalBuf.splice(0, 255);
+        out.push(LITERAL_MARKER);
+        out.push(chunk.length);
+        for (const b of chunk) out.push(b);
       }
     }
 
-    if (bestLen >= 2 || (bestLen === 1 && bestIndex >= 0)) {
-      // Emit codebook match — flush any pending literals first
-      flushLiterals();
-      out.push(bestIndex);
-      pos += bestLen;
-    } else {
-      // No useful match — accumulate as literal
-      const byte = text.charCodeAt(pos);
-      if (byte > 255) {
-        // Multi-byte character: encode as UTF-8 literal bytes
-        const encoded = Buffer.from(text[pos], 'utf8');
-        for (const b of encoded) literalBuf.push(b);
+    while (pos < text.length) {
+      // Try longest match in trie
+      let node = trie;
+      let bestIndex = -1;
+      let bestLen = 0;
+
+      for (let i = 0; pos + i < text.length && i < maxEntryLen; i++) {
+        const ch = text[pos + i];
+        if (!node.children[ch]) break;
+        node = node.children[ch];
+        if (node.index >= 0) {
+          bestIndex = node.index;
+          bestLen = i + 1;
+        }
+      }
+
+      if (bestLen >= 2 || (bestLen === 1 && bestIndex >= 0)) {
+        // Emit codebook match — flush any pending literals first
+        flushLiterals();
+        out.push(bestIndex);
+        pos += bestLen;
       } else {
-        literalBuf.push(byte);
+        // No useful match — accumulate as literal
+        const byte = text.charCodeAt(pos);
+        if (byte > 0x7F) {
+          // Non-ASCII character: encode as UTF-8 literal bytes. A
+          // surrogate pair is one character (4 UTF-8 bytes).
+          const ch = String.fromCodePoint(text.codePointAt(pos));
+          const encoded = Buffer.from(ch, 'utf8');
+          for (const b of encoded) literalBuf.push(b);
+          pos += ch.length;
+        } else {
+          literalBuf.push(byte);
+          pos += 1;
+        }
       }
-      pos += 1;
     }
-  }
-
-  flushLiterals();
-  return Buffer.from(out);
-}
 
-// ---------------------------------------------------------------------------
-// decompress(buffer) → string
-// ---------------------------------------------------------------------------
+    flushLiterals();
+    return Buffer.from(out);
+  }
 
-/**
- * Decompress a MeshXT Smaz-compressed buffer back to text.
- *
- * @param {Buffer|Uint8Array} buf - Compressed data
- * @returns {string} Original text
- */
-function decompress(buf) {
-  const parts = [];
-  let pos = 0;
+  /**
+   * Decompress a MeshXT Smaz-compressed buffer back to text.
+   *
+   * @param {Buffer|Uint8Array} buf - Compressed data
+   * @returns {string} Original text
+   */
+  function decompress(buf) {
+    const parts = [];
+    let pos = 0;
 
-  while (pos < buf.length) {
-    const byte = buf[pos];
+    while (pos < buf.length) {
+      const byte = buf[pos];
 
-    if (byte === LITERAL_MARKER) {
-      // Literal run
-      pos++;
-      if (pos >= buf.length) throw new Error('Truncated literal marker');
-      const len = buf[pos];
-      pos++;
-      if (pos + len > buf.length) throw new Error('Truncated literal data');
-      parts.push(Buffer.from(buf.slice(pos, pos + len)).toString('utf8'));
-      pos += len;
-    } else if (byte === 0xFF) {
-      throw new Error('Reserved byte 0xFF encountered');
-    } else {
-      // Codebook entry
-      if (byte >= CODEBOOK.length) {
-        throw new Error(`Invalid codebook index: 0x${byte.toString(16)}`);
+      if (byte === LITERAL_MARKER) {
+        // Literal run
+        pos++;
+        if (pos >= buf.length) throw new Error('Truncated literal marker');
+        const len = buf[pos];
+        pos++;
+        if (pos + len > buf.length) throw new Error('Truncated literal data');
+        parts.push(Buffer.from(buf.slice(pos, pos + len)));
+        pos += len;
+      } else if (byte === 0xFF) {
+        throw new Error('Reserved byte 0xFF encountered');
+      } else {
+        // Codebook entry
+        if (byte >= codebook.length) {
+          throw new Error(`Invalid codebook index: 0x${byte.toString(16)}`);
+        }
+        parts.push(Buffer.from(codebook[byte], 'utf8'));
+        pos++;
       }
-      parts.push(CODEBOOK[byte]);
-      pos++;
     }
+
+    // Joined as bytes: a character may span two literal runs
+    return Buffer.concat(parts).toString('utf8');
   }
 
-  return parts.join('');
+  return { compress, decompress };
 }
 
+// ---------------------------------------------------------------------------
+// compress(text) → Buffer, decompress(buffer) → string
+// ---------------------------------------------------------------------------
+
+const builtin = createCodec(CODEBOOK);
+
 module.exports = {
-  compress,
-  decompress,
+  compress: builtin.compress,
+  decompress: builtin.decompress,
+  createCodec,
   CODEBOOK,
   LITERAL_MARKER,
 };
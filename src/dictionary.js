@@ -0,0 +1,286 @@
+'use strict';
+
+/**
+ * MeshXT Trained Dictionaries
+ *
+ * Learns a replacement for the built-in Smaz codebook from a channel's own
+ * message log (callsigns, place names, jargon), and writes it in the blob
+ * format the firmware loads with meshxt_dict_load():
+ *
+ *   Bytes 0-2: "MXD"
+ *   Byte 3:    Format version (1)
+ *   Byte 4:    Dictionary ID (1–255; 0 is the built-in codebook)
+ *   Byte 5:    Entry count (1–254)
+ *   Then per entry: length (1–16), entry bytes
+ *
+ * Packets compressed with a dictionary carry its ID, and a receiver decodes
+ * with whatever dictionary it holds under that ID. By default the ID is a
+ * hash of the entries mapped to 1–255, so two different dictionaries share
+ * one about once in 255. Pass the dictionaries already in use as
+ * `options.avoid` and train() picks the next free ID instead, or refuses
+ * an explicit ID that clashes.
+ */
+
+const { compress, createCodec, LITERAL_MARKER } = require('./compress');
+
+const FORMAT = 1;
+const MAX_ENTRIES = LITERAL_MARKER;  // indices 0x00–0xFD
+const MAX_ENTRY_LEN = 16;
+
+// Entries are printable ASCII, so one character is one byte on both sides
+function isEntryChar(ch) {
+  const c = ch.charCodeAt(0);
+  return c >= 0x20 && c <= 0x7E;
+}
+
+// ---------------------------------------------------------------------------
+// train(messages, options) → dictionary
+// ---------------------------------------------------------------------------
+
+/**
+ * Train a dictionary on sample messages.
+ *
+ * Starts from the characters seen in the log, then repeatedly merges the
+ * most frequent adjacent pair of entries into a new entry (byte-pair
+ * encoding) until the dictionary is full or no pair repeats. Entries the
+ * greedy compressor never picks are dropped at the end.
+ *
+ * @param {string[]} messages - Sample messages, one per element
+ * @param {Object} [options]
+ * @param {number} [options.id]         - Dictionary ID (default: hash of the entries)
+ * @param {Array<{id: number, entries: string[]}>} [options.avoid] - Dictionaries already
+ *                                        in use; their IDs are not reused for different entries
+ * @param {number} [options.maxEntries] - Entry limit (default 254)
+ * @param {number} [options.minCount]   - Least occurrences for an entry (default 2)
+ * @returns {{id: number, hashId: number, entries: string[], stats: Object}}
+ *   hashId is the ID the hash gave, which differs from id if it was taken
+ */
+function train(messages, options = {}) {
+  const maxEntries = Math.min(options.maxEntries || MAX_ENTRIES, MAX_ENTRIES);
+  const minCount = options.minCount || 2;
+  const samples = messages.filter(m => m.length > 0);
+  if (samples.length === 0) throw new Error('No messages to train on');
+
+  // Token lists; characters that cannot be entries split them (null)
+  const tokens = samples.map(m => Array.from(m, ch => (isEntryChar(ch) ? ch : null)));
+
+  const charCount = new Map();
+  for (const toks of tokens) {
+    for (const t of toks) if (t !== null) charCount.set(t, (charCount.get(t) || 0) + 1);
+  }
+  const entries = [...charCount.entries()]
+    .filter(([, n]) => n >= minCount)
+    .sort((a, b) => b[1] - a[1] || (a[0] < b[0] ? -1 : 1))
+    .slice(0, maxEntries)
+    .map(([ch]) => ch);
+  const known = new Set(entries);
+
+  while (entries.length < maxEntries) {
+    const pairs = new Map();
+    for (const toks of tokens) {
+      for (let i = 0; i + 1 < toks.length; i++) {
+        const a = toks[i];
+        const b = toks[i + 1];
+        if (a === null || b === null || a.length + b.length > MAX_ENTRY_LEN) continue;
+        const key = a + '\u0000' + b;
+        pairs.set(key, (pairs.get(key) || 0) + 1);
+      }
+    }
+
+    let best = null;
+    let bestCount = minCount - 1;
+    for (const [key, n] of pairs) {
+      if (n > bestCount || (n === bestCount && best !== null && key.length > best.length)) {
+        best = key;
+        bestCount = n;
+      }
+    }
+    if (best === null) break;
+
+    const [a, b] = best.split('\u0000');
+    const merged = a + b;
+    for (const toks of tokens) {
+      for (let i = 0; i + 1 < toks.length; i++) {
+        if (toks[i] === a && toks[i + 1] === b) toks.splice(i, 2, merged);
+      }
+    }
+    if (!known.has(merged)) {
+      known.add(merged);
+      entries.push(merged);
+    }
+  }
+
+  // Keep what the compressor actually uses, most used first
+  const use = new Array(entries.length).fill(0);
+  const codec = createCodec(entries);
+  for (const m of samples) {
+    for (const idx of codecIndices(codec.compress(m))) use[idx]++;
+  }
+  const kept = entries
+    .map((e, i) => [e, use[i]])
+    .filter(([, n]) => n > 0)
+    .sort((x, y) => y[1] - x[1])
+    .map(([e]) => e);
+  if (kept.length === 0) throw new Error('Messages have nothing in common to train on');
+
+  const hashId = defaultId(kept);
+  const id = pickId(options.id !== undefined ? options.id : hashId, kept, options.avoid || [],
+    options.id === undefined);
+
+  const trained = createCodec(kept);
+  const stats = { messages: samples.length, originalBytes: 0, builtinBytes: 0, trainedBytes: 0 };
+  for (const m of samples) {
+    stats.originalBytes += Buffer.byteLength(m, 'utf8');
+    stats.builtinBytes += compress(m).length;
+    stats.trainedBytes += trained.compress(m).length;
+  }
+
+  return { id, hashId, entries: kept, stats };
+}
+
+// Codebook indices in compressed output (literal runs skipped)
+function codecIndices(buf) {
+  const out = [];
+  for (let pos = 0; pos < buf.length;) {
+    if (buf[pos] === LITERAL_MARKER) {
+      pos += 2 + buf[pos + 1];
+    } else {
+      out.push(buf[pos++]);
+    }
+  }
+  return out;
+}
+
+// FNV-1a over the entries, mapped to 1–255
+function defaultId(entries) {
+  let h = 0x811C9DC5;
+  for (const e of entries) {
+    for (const ch of e + '\u0000') {
+      h ^= ch.charCodeAt(0);
+      h = Math.imul(h, 0x01000193) >>> 0;
+    }
+  }
+  return (h % 255) + 1;
+}
+
+/**
+ * `id`, or the next ID no other dictionary in `avoid` holds when `probe`
+ * is set. An ID held by the same entries is not a clash: it is the same
+ * dictionary.
+ */
+function pickId(id, entries, avoid, probe) {
+  if (!Number.isInteger(id) || id < 1 || id > 255) throw new Error(`Dictionary ID must be 1–255, got ${id}`);
+  const same = d => d.entries.length === entries.length && d.entries.every((e, i) => e === entries[i]);
+  const taken = new Set(avoid.filter(d => !same(d)).map(d => d.id));
+  for (let tries = 0; tries < 255; tries++) {
+    if (!taken.has(id)) return id;
+    if (!probe) throw new Error(`Dictionary ID ${id} is already used by a different dictionary`);
+    id = (id % 255) + 1;
+  }
+  throw new Error('No free dictionary ID');
+}
+
+// ---------------------------------------------------------------------------
+// Blob format
+// ---------------------------------------------------------------------------
+
+/**
+ * Serialize a dictionary to the firmware blob format.
+ *
+ * @param {{id: number, entries: string[]}} dict
+ * @returns {Buffer}
+ */
+function serialize(dict) {
+  validate(dict);
+  const parts = [Buffer.from([0x4D, 0x58, 0x44, FORMAT, dict.id, dict.entries.length])];
+  for (const e of dict.entries) {
+    parts.push(Buffer.from([e.length]), Buffer.from(e, 'latin1'));
+  }
+  return Buffer.concat(parts);
+}
+
+/**
+ * Parse a dictionary blob.
+ *
+ * @param {Buffer|Uint8Array} buf
+ * @returns {{id: number, entries: string[]}}
+ */
+function parse(buf) {
+  if (buf.length < 6 || buf[0] !== 0x4D || buf[1] !== 0x58 || buf[2] !== 0x44) {
+    throw new Error('Not a MeshXT dictionary');
+  }
+  if (buf[3] !== FORMAT) throw new Error(`Unsupported dictionary format ${buf[3]}`);
+
+  const id = buf[4];
+  const count = buf[5];
+  const entries = [];
+  let pos = 6;
+  for (let i = 0; i < count; i++) {
+    if (pos >= buf.length) throw new Error('Truncated dictionary');
+    const len = buf[pos++];
+    if (pos + len > buf.length) throw new Error('Truncated dictionary');
+    entries.push(Buffer.from(buf.slice(pos, pos + len)).toString('latin1'));
+    pos += len;
+  }
+  if (pos !== buf.length) throw new Error('Trailing bytes after dictionary');
+
+  const dict = { id, entries };
+  validate(dict);
+  return dict;
+}
+
+function validate(dict) {
+  if (!Number.isInteger(dict.id) || dict.id < 1 || dict.id > 255) {
+    throw new Error(`Dictionary ID must be 1–255, got ${dict.id}`);
+  }
+  if (dict.entries.length === 0 || dict.entries.length > MAX_ENTRIES) {
+    throw new Error(`Dictionary needs 1–${MAX_ENTRIES} entries, has ${dict.entries.length}`);
+  }
+  for (const e of dict.entries) {
+    if (e.length === 0 || e.length > MAX_ENTRY_LEN || !Array.from(e).every(isEntryChar)) {
+      throw new Error(`Invalid dictionary entry ${JSON.stringify(e)}`);
+    }
+  }
+}
+
+/**
+ * C source for a dictionary blob, for building it into flash instead of
+ * loading it from LittleFS. Pass the array to meshxt_dict_load().
+ *
+ * @param {{id: number, entries: string[]}} dict
+ * @returns {string}
+ */
+function toCHeader(dict) {
+  const blob = serialize(dict);
+  const lines = [];
+  for (let i = 0; i < blob.length; i += 12) {
+    lines.push('    ' + Array.from(blob.slice(i, i + 12), b => `0x${b.toString(16).padStart(2, '0')}`).join(', ') + ',');
+  }
+  return `#pragma once
+
+#include <stdint.h>
+
+// MeshXT dictionary ${dict.id} (${dict.entries.length} entries), generated by \`meshxt train\`
+static const uint8_t MESHXT_DICT_${dict.id}[${blob.length}] = {
+${lines.join('\n')}
+};
+`;
+}
+
+/**
+ * Compressor/decompressor pair for a dictionary.
+ *
+ * @param {{id: number, entries: string[]}} dict
+ */
+function codec(dict) {
+  return createCodec(dict.entries);
+}
+
+module.exports = {
+  train,
+  serialize,
+  parse,
+  toCHeader,
+  codec,
+  MAX_ENTRY_LEN,
+};
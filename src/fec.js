@@ -86,14 +86,6 @@ function polyEval(poly, x) {
   return result;
 }
 
-function polyScale(poly, x) {
-  const r = new Uint8Array(poly.length);
-  for (let i = 0; i < poly.length; i++) {
-    r[i] = gfMul(poly[i], x);
-  }
-  return r;
-}
-
 // ---------------------------------------------------------------------------
 // Generator polynomial
 // ---------------------------------------------------------------------------
@@ -170,56 +162,73 @@ function rsCalcSyndromes(msg, nsym) {
   return synd;
 }
 
+/**
+ * Evaluate a polynomial stored lowest degree first.
+ */
+function polyEvalLow(poly, x) {
+  let result = poly[poly.length - 1];
+  for (let i = poly.length - 2; i >= 0; i--) {
+    result = gfMul(result, x) ^ poly[i];
+  }
+  return result;
+}
+
 function rsFindErrorLocator(synd, nsym) {
-  // Berlekamp-Massey algorithm
-  let errLoc = new Uint8Array([1]);
-  let oldLoc = new Uint8Array([1]);
+  // Berlekamp-Massey. Lambda(x) = 1 + L1*x + ... + Lv*x^v, lowest degree
+  // first, as in the firmware (MeshXTFEC.cpp)
+  let lambda = new Uint8Array(nsym + 1);
+  let prev = new Uint8Array(nsym + 1); // copy of lambda before the last length change
+  lambda[0] = 1;
+  prev[0] = 1;
+
+  let L = 0; // current locator degree
+  let m = 1; // steps since the last length change
+  let b = 1; // discrepancy at the last length change
+
+  for (let r = 0; r < nsym; r++) {
+    let delta = synd[r];
+    for (let i = 1; i <= L; i++) {
+      delta ^= gfMul(lambda[i], synd[r - i]);
+    }
 
-  for (let i = 0; i < nsym; i++) {
-    let delta = synd[i];
-    for (let j = 1; j < errLoc.length; j++) {
-      delta ^= gfMul(errLoc[errLoc.length - 1 - j], synd[i - j]);
+    if (delta === 0) {
+      m++;
+      continue;
     }
 
-    // Shift oldLoc
-    const newOld = new Uint8Array(oldLoc.length + 1);
-    newOld.set(oldLoc);
-    oldLoc = newOld;
+    const coef = gfDiv(delta, b);
+    const before = Uint8Array.from(lambda);
+    for (let i = 0; i + m <= nsym; i++) {
+      lambda[i + m] ^= gfMul(coef, prev[i]);
+    }
 
-    if (delta !== 0) {
-      if (oldLoc.length > errLoc.length) {
-        const newLoc = polyScale(oldLoc, delta);
-        oldLoc = polyScale(errLoc, gfInverse(delta));
-        errLoc = newLoc;
-      }
-      // Update error locator
-      const scaledOld = polyScale(oldLoc, delta);
-      const updated = new Uint8Array(Math.max(errLoc.length, scaledOld.length));
-      updated.set(errLoc, updated.length - errLoc.length);
-      for (let j = 0; j < scaledOld.length; j++) {
-        updated[updated.length - scaledOld.length + j] ^= scaledOld[j];
-      }
-      errLoc = updated;
+    if (2 * L <= r) {
+      L = r + 1 - L;
+      prev = before;
+      b = delta;
+      m = 1;
+    } else {
+      m++;
     }
   }
 
-  // Number of errors
-  const numErrors = errLoc.length - 1;
-  if (numErrors * 2 > nsym) {
+  if (2 * L > nsym) {
     throw new Error('Too many errors to correct');
   }
 
-  return errLoc;
+  return lambda.slice(0, L + 1);
 }
 
 function rsFindErrors(errLoc, msgLen) {
-  // Chien search
+  // Chien search: position p is the coefficient of x^(msgLen-1-p), so
+  // Lambda(X^-1) == 0 with X = alpha^(msgLen-1-p) marks an error there
   const numErrors = errLoc.length - 1;
   const errPos = [];
 
-  for (let i = 0; i < msgLen; i++) {
-    if (polyEval(errLoc, gfExp[255 - i]) === 0) {
-      errPos.push(msgLen - 1 - i);
+  for (let p = 0; p < msgLen; p++) {
+    const power = msgLen - 1 - p;
+    if (polyEvalLow(errLoc, gfExp[(255 - power) % 255]) === 0) {
+      errPos.push(p);
     }
   }
 
@@ -230,57 +239,36 @@ function rsFindErrors(errLoc, msgLen) {
   return errPos;
 }
 
-function rsForneySyndromes(synd, errPos, nmsg) {
-  // Compute Forney syndromes for erasure correction
-  const fsynd = new Uint8Array(synd.length);
-  fsynd.set(synd);
-  return fsynd;
-}
-
-function rsCorrectErrors(msg, synd, errPos) {
-  // Forney algorithm
+function rsCorrectErrors(msg, synd, errLoc, errPos) {
+  // Forney: Omega(x) = S(x) * Lambda(x) mod x^nsym,
+  // e = X * Omega(X^-1) / Lambda'(X^-1)   (first consecutive root alpha^0)
   const nsym = synd.length;
+  const numErrors = errLoc.length - 1;
 
-  // Compute error evaluator polynomial
-  // First get the error locator from positions
-  let errLoc = new Uint8Array([1]);
-  for (const pos of errPos) {
-    const coef = gfExp[msg.length - 1 - pos];
-    errLoc = polyMul(errLoc, new Uint8Array([coef, 1]));
-  }
-
-  // Error evaluator = (Synd * ErrLoc) mod x^nsym
-  // Build syndrome polynomial (reversed)
-  const syndPoly = new Uint8Array(nsym + 1);
-  syndPoly[0] = 0;
+  const omega = new Uint8Array(nsym);
   for (let i = 0; i < nsym; i++) {
-    syndPoly[nsym - i] = synd[i];
-  }
-  let errEval = polyMul(syndPoly, errLoc);
-  // Take only the low-order terms
-  errEval = errEval.slice(errEval.length - nsym);
-
-  // Formal derivative of error locator
-  const errLocPrime = new Uint8Array(Math.ceil(errLoc.length / 2));
-  for (let i = errLoc.length & ~1; i >= 0; i -= 2) {
-    if (i < errLoc.length) {
-      errLocPrime[Math.floor(i / 2)] = errLoc[i];
+    for (let j = 0; j <= numErrors && i + j < nsym; j++) {
+      omega[i + j] ^= gfMul(synd[i], errLoc[j]);
     }
   }
 
-  // Correct errors using Forney
+  // Formal derivative: in GF(2^m) only the odd-degree terms survive
+  const errLocPrime = new Uint8Array(Math.max(numErrors, 1));
+  for (let i = 1; i <= numErrors; i += 2) {
+    errLocPrime[i - 1] = errLoc[i];
+  }
+
   const corrected = new Uint8Array(msg);
   for (const pos of errPos) {
-    const xi = gfExp[msg.length - 1 - pos];
-    const xiInv = gfInverse(xi);
-
-    const errLocEval = polyEval(errLocPrime, xiInv);
-    if (errLocEval === 0) throw new Error('Error locator derivative is zero');
+    const power = msg.length - 1 - pos;
+    const x = gfExp[power];
+    const xInv = gfExp[(255 - power) % 255];
 
-    const errEvalVal = polyEval(errEval, xiInv);
-    const magnitude = gfDiv(errEvalVal, errLocEval);
+    const denom = polyEvalLow(errLocPrime, xInv);
+    if (denom === 0) throw new Error('Error locator derivative is zero');
 
-    corrected[pos] ^= magnitude;
+    const num = gfMul(x, polyEvalLow(omega, xInv));
+    corrected[pos] ^= gfDiv(num, denom);
   }
 
   return corrected;
@@ -309,7 +297,7 @@ function rsDecodeMsg(msgWithParity, nsym) {
   const errPos = rsFindErrors(errLoc, msgWithParity.length);
 
   // Correct errors
-  const corrected = rsCorrectErrors(msgWithParity, synd, errPos);
+  const corrected = rsCorrectErrors(msgWithParity, synd, errLoc, errPos);
 
   // Verify correction
   const checkSynd = rsCalcSyndromes(corrected, nsym);
@@ -15,6 +15,7 @@ const codebook = require('./codebook');
 const fec = require('./fec');
 const adaptive = require('./adaptive');
 const packet = require('./packet');
+const dictionary = require('./dictionary');
 const utils = require('./utils');
 
 module.exports = {
@@ -29,6 +30,15 @@ module.exports = {
     listTemplates: codebook.listTemplates,
   },
 
+  // Trained dictionaries
+  dictionary: {
+    train: dictionary.train,
+    serialize: dictionary.serialize,
+    parse: dictionary.parse,
+    toCHeader: dictionary.toCHeader,
+    codec: dictionary.codec,
+  },
+
   // Forward error correction
   fec: {
     encode: fec.encode,
@@ -0,0 +1,284 @@
+#!/usr/bin/env node
+'use strict';
+
+/**
+ * Differential conformance: the JS implementation against the firmware
+ * C++ core, through firmware/tools/meshxt-vectors.cpp.
+ *
+ * Every corpus message is encoded by both at each compression type they
+ * share (none, smaz) and each FEC level, and the packets must be byte for
+ * byte identical. Each side then decodes the other's packets, clean and
+ * with as many byte errors as the level corrects, and raw RS codewords
+ * are compared the same way. Compression ratios are reported per type.
+ * Firmware-only features are checked by round trips inside the tool:
+ * every corpus message must come back unchanged.
+ *
+ * The tool is built with $CXX (default c++) unless MESHXT_VECTORS points
+ * at a binary. A failed build fails the suite; set MESHXT_SKIP_CPP=1 to
+ * skip it instead where no compiler is available.
+ *
+ *   node test/differential.js [corpus.txt]
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { spawnSync } = require('child_process');
+
+const packet = require('../src/packet');
+const fec = require('../src/fec');
+
+const ROOT = path.join(__dirname, '..');
+const FIRMWARE = path.join(ROOT, 'firmware', 'src');
+
+let passed = 0;
+let failed = 0;
+let total = 0;
+
+function assert(condition, label) {
+  total++;
+  if (condition) {
+    passed++;
+    console.log(`  ✅ ${label}`);
+  } else {
+    failed++;
+    console.log(`  ❌ ${label}`);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// The C++ side
+// ---------------------------------------------------------------------------
+
+function buildVectors() {
+  if (process.env.MESHXT_VECTORS) return process.env.MESHXT_VECTORS;
+
+  const out = path.join(os.tmpdir(), `meshxt-vectors-${process.pid}`);
+  const sources = ['Compress', 'Codebook', 'Entropy', 'History', 'FEC', 'Packet', 'Fragment']
+    .map(name => path.join(FIRMWARE, `MeshXT${name}.cpp`));
+  const cxx = process.env.CXX || 'c++';
+  const result = spawnSync(cxx, ['-std=c++17', '-O2', `-I${FIRMWARE}`, '-o', out,
+    path.join(ROOT, 'firmware', 'tools', 'meshxt-vectors.cpp'), ...sources], { encoding: 'utf8' });
+  if (result.error || result.status !== 0) {
+    if (result.stderr) console.log(result.stderr);
+    if (result.error) console.log(result.error.message);
+    if (process.env.MESHXT_SKIP_CPP === '1') {
+      console.log(`Skipping: could not build meshxt-vectors with ${cxx} (MESHXT_SKIP_CPP=1)`);
+      return null;
+    }
+    console.log(`Could not build meshxt-vectors with ${cxx}; set MESHXT_SKIP_CPP=1 to skip`);
+    process.exit(1);
+  }
+  process.on('exit', () => fs.rmSync(out, { force: true }));
+  return out;
+}
+
+/** Run the tool over one input per line; returns its results, null for "err". */
+function vectors(bin, args, inputs) {
+  const result = spawnSync(bin, args, { input: inputs.map(s => s + '\n').join(''), encoding: 'utf8',
+    maxBuffer: 64 * 1024 * 1024 });
+  if (result.status !== 0) throw new Error(`meshxt-vectors ${args.join(' ')} failed: ${result.stderr}`);
+  const lines = result.stdout.split('\n').slice(0, inputs.length);
+  return lines.map(line => (line.startsWith('ok ') ? line.slice(3) : null));
+}
+
+// ---------------------------------------------------------------------------
+// Inputs
+// ---------------------------------------------------------------------------
+
+// Fixed seed, so a failure reproduces
+let rngState = 0x2545F491;
+function rng() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >>> 17;
+  rngState ^= rngState << 5;
+  return rngState >>> 0;
+}
+
+function loadCorpus(file) {
+  const lines = fs.readFileSync(file, 'utf8').split(/\r?\n/).filter(line => line.length > 0);
+  return lines.concat([
+    'a',
+    ' ',
+    'Sending 👍 from 📍 here',
+    'Ünïcode & ~odd~ text — “quoted”',
+    'þþ literal markers þ',
+    'x'.repeat(180),
+    'the '.repeat(60),
+    'é'.repeat(110),
+  ]);
+}
+
+/** Flip `count` distinct bytes from `start` on. */
+function corrupt(buf, count, start = 0) {
+  const damaged = Buffer.from(buf);
+  const positions = new Set();
+  while (positions.size < Math.min(count, damaged.length - start)) {
+    positions.add(start + rng() % (damaged.length - start));
+  }
+  for (const pos of positions) damaged[pos] ^= 1 + rng() % 255;
+  return damaged;
+}
+
+function jsPacket(message, compression, fecLevel) {
+  try {
+    return packet.createPacket(message, { compression, fec: fecLevel }).packet.toString('hex');
+  } catch (e) {
+    return null;
+  }
+}
+
+function jsParse(hex) {
+  try {
+    return packet.parsePacket(Buffer.from(hex, 'hex')).message;
+  } catch (e) {
+    return null;
+  }
+}
+
+function jsFecDecode(hex, level) {
+  try {
+    return fec.decode(Buffer.from(hex, 'hex'), level).toString('hex');
+  } catch (e) {
+    return null;
+  }
+}
+
+/** Indices where two result lists disagree. */
+function mismatches(a, b) {
+  const out = [];
+  for (let i = 0; i < a.length; i++) if (a[i] !== b[i]) out.push(i);
+  return out;
+}
+
+function describe(label, inputs, diff, show) {
+  if (diff.length === 0) return label;
+  const first = diff[0];
+  const input = JSON.stringify(inputs[first]).slice(0, 60);
+  return `${label} — ${diff.length} differ, first: ${input} (${show(first).slice(0, 160)})`;
+}
+
+// ---------------------------------------------------------------------------
+// Suite
+// ---------------------------------------------------------------------------
+
+const bin = buildVectors();
+if (!bin) process.exit(0);
+
+const corpusFile = process.argv[2] || path.join(ROOT, 'firmware', 'tools', 'chat-corpus.txt');
+const corpus = loadCorpus(corpusFile);
+const LEVELS = ['none', 'low', 'medium', 'high'];
+
+console.log(`\n🔀 Packets (${corpus.length} messages)`);
+console.log('───────────────────────────────────────');
+
+const packets = {};
+for (const comp of ['none', 'smaz']) {
+  for (const level of LEVELS) {
+    const cpp = vectors(bin, ['encode', comp, level], corpus);
+    const js = corpus.map(m => jsPacket(m, comp, level));
+    const diff = mismatches(cpp, js);
+    const encoded = cpp.filter(p => p !== null).length;
+    assert(diff.length === 0, describe(`${comp}/${level}: ${encoded} packets identical`, corpus, diff,
+      i => `C++ ${cpp[i]} vs JS ${js[i]}`));
+    packets[`${comp}/${level}`] = cpp;
+  }
+}
+
+console.log('\n🔁 Cross-decoding');
+console.log('───────────────────────────────────────');
+
+for (const [key, list] of Object.entries(packets)) {
+  const level = key.split('/')[1];
+  const indices = list.map((p, i) => i).filter(i => list[i] !== null);
+  const clean = indices.map(i => list[i]);
+  const expected = indices.map(i => corpus[i]);
+
+  const cppClean = vectors(bin, ['decode'], clean);
+  const jsClean = clean.map(jsParse);
+  assert(mismatches(cppClean, expected).length === 0 && mismatches(jsClean, expected).length === 0,
+    `${key}: both decode all ${clean.length} packets`);
+
+  if (level === 'none') continue;
+  // Errors anywhere after the header, up to the level's capacity
+  const damaged = clean.map(hex => corrupt(Buffer.from(hex, 'hex'), 1 + rng() % fec.maxCorrectableErrors(level),
+    packet.HEADER_SIZE).toString('hex'));
+  const cppDamaged = vectors(bin, ['decode'], damaged);
+  const jsDamaged = damaged.map(jsParse);
+  const cppDiff = mismatches(cppDamaged, expected);
+  const jsDiff = mismatches(jsDamaged, expected);
+  assert(cppDiff.length === 0, describe(`${key}: C++ corrects all ${damaged.length} damaged packets`, expected,
+    cppDiff, i => `got ${cppDamaged[i]}`));
+  assert(jsDiff.length === 0, describe(`${key}: JS corrects all ${damaged.length} damaged packets`, expected,
+    jsDiff, i => `got ${jsDamaged[i]}`));
+}
+
+console.log('\n🛡️ Reed-Solomon codewords');
+console.log('───────────────────────────────────────');
+
+for (const level of ['low', 'medium', 'high']) {
+  const nsym = fec.parityBytes(level);
+  const data = [];
+  for (let i = 0; i < 300; i++) {
+    const len = 1 + rng() % (255 - nsym);
+    data.push(Buffer.from(Array.from({ length: len }, () => rng() & 0xFF)).toString('hex'));
+  }
+
+  const cppCodewords = vectors(bin, ['fec-encode', level], data);
+  const jsCodewords = data.map(hex => fec.encode(Buffer.from(hex, 'hex'), level).toString('hex'));
+  assert(mismatches(cppCodewords, jsCodewords).length === 0, `${level}: ${data.length} codewords identical`);
+
+  // Exactly at capacity, then each side corrects the other's codeword
+  const damaged = jsCodewords.map(hex => corrupt(Buffer.from(hex, 'hex'), nsym / 2).toString('hex'));
+  const cppFixed = vectors(bin, ['fec-decode', level], damaged);
+  const jsFixed = damaged.map(hex => jsFecDecode(hex, level));
+  assert(mismatches(cppFixed, data).length === 0, `${level}: C++ corrects ${nsym / 2} errors in every codeword`);
+  assert(mismatches(jsFixed, data).length === 0, `${level}: JS corrects ${nsym / 2} errors in every codeword`);
+}
+
+console.log('\n🔄 Firmware round trips');
+console.log('───────────────────────────────────────');
+
+const ROUND_TRIPS = {
+  rs: 'every FEC level corrects nsym/2 errors and reports them',
+  interleave: 'depths 2-4 correct a depth * nsym/2 byte burst',
+  ratio: 'ratio-mode SHORT frames carry payload-sized parity and correct nsym/2 errors',
+  erasures: 'errors and hinted erasures at 2e + f = nsym',
+  fragment: 'any k of k + m damaged, reordered fragments rebuild the message',
+  entropy: 'entropy coding round-trips through every decoder and in packets',
+  history: 'history-coded conversation stays in step, with byte errors',
+  batch: 'batches split back into their messages, in order and type',
+};
+for (const [check, label] of Object.entries(ROUND_TRIPS)) {
+  const results = vectors(bin, ['roundtrip', check], corpus);
+  const diff = mismatches(results, corpus);
+  assert(diff.length === 0, describe(`${check}: ${label}`, corpus, diff, i => `got ${results[i]}`));
+}
+
+console.log('\n📊 Compression ratios (payload / text bytes)');
+console.log('───────────────────────────────────────');
+
+const textBytes = corpus.reduce((n, m) => n + Buffer.byteLength(m, 'utf8'), 0);
+const ratioOf = list => {
+  let bytes = 0;
+  let count = 0;
+  list.forEach((hex, i) => {
+    if (hex === null) return;
+    bytes += hex.length / 2 - packet.HEADER_SIZE;
+    count += Buffer.byteLength(corpus[i], 'utf8');
+  });
+  return count > 0 ? bytes / count : 0;
+};
+const jsSmaz = corpus.map(m => jsPacket(m, 'smaz', 'none'));
+const cppSmaz = packets['smaz/none'];
+const cppEntropy = vectors(bin, ['encode', 'entropy', 'none'], corpus);
+console.log(`  ${textBytes} text bytes`);
+console.log(`  smaz    JS ${ratioOf(jsSmaz).toFixed(3)}   C++ ${ratioOf(cppSmaz).toFixed(3)}`);
+console.log(`  entropy C++ ${ratioOf(cppEntropy).toFixed(3)}   (firmware only)`);
+assert(ratioOf(jsSmaz) === ratioOf(cppSmaz), 'smaz ratio identical');
+
+console.log('\n═══════════════════════════════════════');
+console.log(`Results: ${passed}/${total} passed, ${failed} failed`);
+console.log('═══════════════════════════════════════\n');
+
+process.exit(failed > 0 ? 1 : 0);
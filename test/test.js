@@ -6,6 +6,7 @@ const codebook = require('../src/codebook');
 const fec = require('../src/fec');
 const adaptive = require('../src/adaptive');
 const packet = require('../src/packet');
+const dictionary = require('../src/dictionary');
 
 let passed = 0;
 let failed = 0;
@@ -107,6 +108,11 @@ try {
   assert(false, `ascii roundtrip: ${e.message}`);
 }
 
+// Emoji are literal runs of their 4 UTF-8 bytes, as in the firmware
+const emojiMsg = 'Sending 👍 from 📍 here';
+assert(decompress(compress(emojiMsg)) === emojiMsg, 'emoji roundtrip');
+assert(compress('👍').equals(Buffer.from([0xFE, 0x04, 0xF0, 0x9F, 0x91, 0x8D])), 'emoji literal is 4 bytes');
+
 // ═══════════════════════════════════════════════════
 console.log('\n📖 Codebook Tests');
 console.log('───────────────────────────────────────');
@@ -190,6 +196,20 @@ try {
   assert(false, `FEC error handling: ${e.message}`);
 }
 
+// Error correction up to capacity, errors spread over data and parity
+for (const level of ['low', 'medium', 'high']) {
+  const data = Buffer.from('Correct me if the channel is noisy today');
+  const encoded = fec.encode(data, level);
+  const errors = fec.maxCorrectableErrors(level);
+  const damaged = Buffer.from(encoded);
+  for (let i = 0; i < errors; i++) damaged[(i * 7) % damaged.length] ^= 0x5A;
+  try {
+    assert(fec.decode(damaged, level).equals(data), `FEC ${level}: corrects ${errors} errors`);
+  } catch (e) {
+    assert(false, `FEC ${level}: corrects ${errors} errors (${e.message})`);
+  }
+}
+
 // Parity bytes
 assert(fec.parityBytes('low') === 16, 'low = 16 parity bytes');
 assert(fec.parityBytes('medium') === 32, 'medium = 32 parity bytes');
@@ -268,6 +288,46 @@ try {
   assert(false, `no-FEC packet: ${e.message}`);
 }
 
+// ═══════════════════════════════════════════════════
+console.log('\n📖 Dictionary Tests');
+console.log('───────────────────────────────────────');
+
+// Channel log with its own vocabulary: callsigns, grid squares, net jargon
+const calls = ['KD9XYZ', 'W1AW', 'N0CALL', 'VE3RSB', 'G4KLM'];
+const grids = ['EN52', 'FN31', 'IO91', 'DM79'];
+const channelLog = [];
+for (let i = 0; i < 120; i++) {
+  const a = calls[i % calls.length];
+  const b = calls[(i * 3 + 1) % calls.length];
+  const g = grids[i % grids.length];
+  channelLog.push(i % 2 ? `${b} de ${a} QSL 73, grid ${g}` : `CQ net check-in ${a} grid ${g} QRV`);
+}
+const trainSet = channelLog.filter((_, i) => i % 4 !== 0);
+const heldOut = channelLog.filter((_, i) => i % 4 === 0);
+
+const dict = dictionary.train(trainSet, { id: 7 });
+const dictCodec = dictionary.codec(dict);
+assert(dict.id === 7 && dict.entries.length > 0 && dict.entries.length <= 254, `trained ${dict.entries.length} entries`);
+assert(heldOut.every(m => dictCodec.decompress(dictCodec.compress(m)) === m), 'trained dictionary roundtrip (held-out)');
+
+const builtinBytes = heldOut.reduce((n, m) => n + compress(m).length, 0);
+const trainedBytes = heldOut.reduce((n, m) => n + dictCodec.compress(m).length, 0);
+assert(trainedBytes < builtinBytes, `trained beats built-in on held-out messages (${trainedBytes} vs ${builtinBytes} bytes)`);
+assert(dictCodec.decompress(dictCodec.compress('Ünïcode & ~odd~ text')) === 'Ünïcode & ~odd~ text', 'untrained text roundtrip');
+
+const blob = dictionary.serialize(dict);
+const reparsed = dictionary.parse(blob);
+assert(reparsed.id === dict.id && reparsed.entries.join('\n') === dict.entries.join('\n'), 'dictionary blob roundtrip');
+assertThrows(() => dictionary.parse(blob.slice(0, blob.length - 1)), 'truncated blob rejected');
+assert(dictionary.train(trainSet).id === dictionary.train(trainSet).id, 'default ID is stable for the same entries');
+
+const hashed = dictionary.train(trainSet);
+const other = { id: hashed.id, entries: ['zz'] };
+const moved = dictionary.train(trainSet, { avoid: [other] });
+assert(moved.id !== hashed.id && moved.hashId === hashed.id, `clashing hash ID moved (${hashed.id} → ${moved.id})`);
+assert(dictionary.train(trainSet, { avoid: [hashed] }).id === hashed.id, 'same dictionary keeps its ID');
+assertThrows(() => dictionary.train(trainSet, { id: 7, avoid: [{ id: 7, entries: ['zz'] }] }), 'clashing explicit ID rejected');
+
 // ═══════════════════════════════════════════════════
 console.log('\n═══════════════════════════════════════');
 console.log(`Results: ${passed}/${total} passed, ${failed} failed`);